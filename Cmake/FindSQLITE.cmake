@@ -0,0 +1,35 @@
+#
+# Try to find the SQLITE installation
+#
+
+SET( SQLITE_FOUND_STRING "Whether a SQLITE installation was found." )
+
+find_path(SQLITE_INCLUDE_DIR
+  sqlite3.h
+  paths
+  ${SQLITE_DIR}/include
+  $ENV{SQLITE_DIR}/include
+  /usr/include
+  /usr/local/include
+  /opt/local/include
+)
+
+find_library(SQLITE_LIB
+  NAMES sqlite3
+  PATHS
+  ${SQLITE_DIR}
+  ${SQLITE_DIR}/lib
+  $ENV{SQLITE_DIR}/lib
+  /usr/lib
+  /usr/lib64
+  /usr/local/lib
+  /usr/local/lib64
+)
+
+if (SQLITE_INCLUDE_DIR AND SQLITE_LIB)
+  set(SQLITE_FOUND TRUE CACHE BOOL ${SQLITE_FOUND_STRING} FORCE)
+  mark_as_advanced(SQLITE_DIR)
+  mark_as_advanced(SQLITE_LIB)
+else (SQLITE_INCLUDE_DIR AND SQLITE_LIB)
+  set(SQLITE_FOUND FALSE CACHE BOOL ${SQLITE_FOUND_STRING} FORCE)
+endif(SQLITE_INCLUDE_DIR AND SQLITE_LIB)
@@ -33,7 +33,7 @@ public:
    * \param authKey The session token
    */
   ListFileTransfers(const std::string& authKey)
-    :  mauthKey(authKey), QueryServer<FMS_Data::LsTransferOptions, FMS_Data::FileTransferList>(),
+    :  mauthKey(authKey), QueryServer<FMS_Data::LsTransferOptions, FMS_Data::FileTransferList>(authKey),
       mcommandName("vishnu_list_file_transfers")
   {
   }
@@ -101,10 +101,18 @@ public:
   FMS_Data::FileTransferList*
   list(FMS_Data::LsTransferOptions_ptr options) {
 
+    // the archived transfers are terminal, only the transfers in progress
+    // are listed without filter
+    bool onlyProgressFile = options->getTransferId().empty()
+                            && options->getFromMachineId().empty()
+                            && options->getUserId().empty();
+    bool terminal = (options->getStatus() == 4) ? !onlyProgressFile
+                                                : options->getStatus() != vishnu::TRANSFER_INPROGRESS;
     std::string sqlListOfFiles = "SELECT transferId, filetransfer.status, userId, clientMachineId, "
                                  "   sourceMachineId, destinationMachineId, sourceFilePath,"
-                                 "   destinationFilePath, fileSize, startTime,errorMsg, trCommand "
-                                 " FROM filetransfer, vsession "
+                                 "   destinationFilePath, fileSize, startTime,errorMsg, trCommand, filetransfer.numfiletransferid "
+                                 " FROM " + vishnu::getHistoryTable("filetransfer", terminal)
+                                 + ", " + vishnu::getHistoryTable("vsession", terminal) +
                                  " WHERE vsession.numsessionid=filetransfer.vsession_numsessionid";
 
     std::vector<std::string>::iterator iter;
@@ -115,7 +123,9 @@ public:
     mlistObject = ecoreFactory->createFileTransferList();
 
     processOptions(options, sqlListOfFiles);
-    sqlListOfFiles.append(" order by startTime");
+    if (! addPageRequest("filetransfer.numfiletransferid", sqlListOfFiles)) {
+      sqlListOfFiles.append(" order by startTime");
+    }
 
 
     boost::scoped_ptr<DatabaseResult> ListOfFiles (mdatabaseInstance->getResult(sqlListOfFiles));
@@ -129,6 +139,9 @@ public:
       for (size_t i = 0; i < ListOfFiles->getNbTuples(); ++i) {
         results.clear();
         results = ListOfFiles->get(i);
+        if (! addToPage(results.back())) {
+          break;
+        }
         iter = results.begin();
 
         FMS_Data::FileTransfer_ptr filetransfer = ecoreFactory->createFileTransfer();
@@ -187,7 +200,8 @@ private:
    * \param transferId the file transfer identifier
    */
   void checkTransferId(std::string transferId) {
-    std::string sqlTransferRequest = "SELECT transferId from filetransfer where transferId='"+mdatabaseInstance->escapeData(transferId)+"'";
+    std::string sqlTransferRequest = "SELECT transferId from " + vishnu::getHistoryTable("filetransfer")
+                                     + " where transferId='"+mdatabaseInstance->escapeData(transferId)+"'";
     boost::scoped_ptr<DatabaseResult> transfer(mdatabaseInstance->getResult(sqlTransferRequest));
     if (transfer->getNbTuples()==0) {
       throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer identifier");;
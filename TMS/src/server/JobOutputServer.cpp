@@ -149,6 +149,7 @@ JobOutputServer::getCompletedJobsOutput(JsonObject* options) {
     return mlistJobsResult;
   }
 
+  std::vector<std::string> updates;
   for (size_t i = 0; i < sqlResult->getNbTuples(); ++i) {
     results.clear();
     results = sqlResult->get(i);
@@ -181,15 +182,15 @@ JobOutputServer::getCompletedJobsOutput(JsonObject* options) {
     mlistJobsResult->getResults().push_back(curResult);
 
     // Mark the job as downloaded, so it will be ignored at the subsequent calls
-    std::string query = (boost::format("UPDATE job SET status=%1% "
-                                       " WHERE jobId='%2%';"
-                                       ) % vishnu::convertToString(vishnu::STATE_DOWNLOADED)
-                         % mdatabaseInstance->escapeData(jobId)).str();
-    mdatabaseInstance->process(query);
+    updates.push_back((boost::format("UPDATE job SET status=%1% "
+                                     " WHERE jobId='%2%';"
+                                     ) % vishnu::convertToString(vishnu::STATE_DOWNLOADED)
+                       % mdatabaseInstance->escapeData(jobId)).str());
     LOG(boost::str(boost::format("[INFO] request to job ouput: %1%. aclogin: %2%")
                    % jobId
                    % muserSessionInfo.user_aclogin), LogInfo);
   }
+  mdatabaseInstance->processBatch(updates);
   mlistJobsResult->setNbJobs(mlistJobsResult->getResults().size());
 
   return mlistJobsResult;
@@ -20,6 +20,7 @@
 #include "utilVishnu.hpp"
 #include "utilServer.hpp"
 #include "DbFactory.hpp"
+#include "DbTransaction.hpp"
 #include "ScriptGenConvertor.hpp"
 #include "api_fms.hpp"
 #include "utils.hpp"
@@ -572,11 +573,13 @@ JobServer::getJobStepInfo(const std::string& jobId, TMS_Data::ListJobs& jobSteps
                                       "   jobPrio, nbCpus, job.status, submitDate, endDate, "
                                       "   owner, jobQueue,wallClockLimit, groupName, memLimit,"
                                       "   nbNodes, nbNodesAndCpuPerNode, userid, vmId, vmIp, jobDescription"
-                                      " FROM job, vsession, users "
+                                      " FROM %2%, %3%, users "
                                       " WHERE vsession.numsessionid=job.vsession_numsessionid "
                                       "   AND vsession.users_numuserid=users.numuserid"
                                       "   AND (job.jobId='%1%' OR job.jobId like '%1%._%%');"
-                                      ) % mdatabaseInstance->escapeData(jobId));
+                                      ) % mdatabaseInstance->escapeData(jobId)
+                                      % vishnu::getHistoryTable("job")
+                                      % vishnu::getHistoryTable("vsession"));
 
   boost::scoped_ptr<DatabaseResult> sqlResult(mdatabaseInstance->getResult(sqlQuery));
   if (sqlResult->getNbTuples() == 0) {
@@ -900,6 +903,7 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
     int nbSteps = jobSteps.getJobs().size();
 
     // first set steps' id and other default parameters
+    std::string jobIds;
     for (int step = 0; step < nbSteps; ++step) {
       TMS_Data::Job_ptr currentJobPtr = jobSteps.getJobs().get(step);
       currentJobPtr->setJobId(boost::str(boost::format("%1%.%2%") % baseJobInfo.getJobId() % step));
@@ -908,14 +912,14 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
       currentJobPtr->setJobPath(baseJobInfo.getJobPath());
       currentJobPtr->setOwner(baseJobInfo.getOwner());
       currentJobPtr->setOutputDir(baseJobInfo.getOutputDir());
-
-      // create an entry to the database for the step
-      mdatabaseInstance->process(boost::str(boost::format("INSERT INTO job (jobid, vsession_numsessionid)"
-                                                          " VALUES ('%1%', %2%)"
-                                                          ) % currentJobPtr->getJobId() % muserSessionInfo.num_session));
+      jobIds += (step == 0 ? "'" : ", '") + mdatabaseInstance->escapeData(currentJobPtr->getJobId()) + "'";
     }
 
-    // now each job's related steps and record to database
+    // now each job's related steps, all the steps are recorded at once with
+    // the same columns, the missing values being NULL
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::string> > rows(nbSteps);
+    std::vector<std::vector<bool> > nulls(nbSteps);
     for (int step = 0; step < nbSteps; ++step) {
       std::string relatedStepList =  "";
       for (int relatedStep = 0; relatedStep < nbSteps; ++relatedStep) {
@@ -925,7 +929,20 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
       }
       TMS_Data::Job_ptr currentJobPtr = jobSteps.getJobs().get(step);
       currentJobPtr->setRelatedSteps(relatedStepList);
-      updateJobRecordIntoDatabase(SubmitBatchAction, *currentJobPtr);
+      getJobRecord(*currentJobPtr, columns, rows[step], nulls[step]);
+      rows[step].push_back(currentJobPtr->getJobId());
+      nulls[step].push_back(false);
+    }
+    columns.push_back("jobid");
+
+    // the steps are recorded at once, or not at all
+    DbTransaction transaction(mdatabaseInstance);
+    mdatabaseInstance->insertRows("job", columns, rows, nulls, transaction.getId());
+    mdatabaseInstance->process("UPDATE job SET submitDate=CURRENT_TIMESTAMP WHERE jobid IN (" + jobIds + ")",
+                               transaction.getId());
+    transaction.commit();
+    for (int step = 0; step < nbSteps; ++step) {
+      logSubmission(*jobSteps.getJobs().get(step));
     }
   }
 }
@@ -934,80 +951,121 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
  * \brief Function to save the encapsulated job into the database
  * @param action The type of action to finalize (submit, cancel...)
  * @param job The concerned job
+ * @param transacId the id of the transaction if one is used
  */
 void
-JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job)
+JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job, int transacId)
 {
   if (action == CancelBatchAction) {
-    std::string query = boost::str(boost::format("UPDATE job set status=%1% where jobid='%2%';")
-                                   % vishnu::convertToString(job.getStatus())
-                                   % job.getJobId());
-    mdatabaseInstance->process(query);
+    std::vector<std::string> params;
+    params.push_back(vishnu::convertToString(job.getStatus()));
+    params.push_back(job.getJobId());
+    mdatabaseInstance->processPrepared("UPDATE job set status=$1 where jobid=$2;", params, transacId);
     LOG(boost::str(boost::format("[INFO] job cancelled: %1%")
                    % job.getJobId()), LogInfo);
 
   } else if (action == SubmitBatchAction) {
-    // Append the machine name to the error and output path if necessary
-    size_t pos = job.getOutputPath().find(":");
-    std::string prefixOutputPath = (pos == std::string::npos)? muserSessionInfo.machine_name+":" : "";
-    job.setOutputPath(prefixOutputPath+job.getOutputPath());
-    pos = job.getErrorPath().find(":");
-    std::string prefixErrorPath = (pos == std::string::npos)? muserSessionInfo.machine_name+":" : "";
-    job.setErrorPath(prefixErrorPath+job.getErrorPath());
-
     // Update the database with the result
-    std::string query = "UPDATE job set ";
-    query+="vsession_numsessionid="+vishnu::convertToString(muserSessionInfo.num_session)+", ";
-    query+="job_owner_id="+vishnu::convertToString(muserSessionInfo.num_user)+", ";
-    query+="owner='"+mdatabaseInstance->escapeData(job.getOwner())+"', ";
-    query+="submitMachineId='"+mdatabaseInstance->escapeData(mmachineId)+"', ";
-    query+="machine_id='"+mdatabaseInstance->escapeData(muserSessionInfo.num_machine)+"', ";
-    query+="submitMachineName='"+mdatabaseInstance->escapeData(muserSessionInfo.machine_name)+"', ";
-    query+="batchJobId='"+mdatabaseInstance->escapeData(job.getBatchJobId())+"', ";
-    query+="batchType="+vishnu::convertToString(mbatchType)+", ";
-    query+="jobName='"+mdatabaseInstance->escapeData(job.getJobName())+"', ";
-    query+="jobPath='"+mdatabaseInstance->escapeData(job.getJobPath())+"', ";
-    query+="outputPath='"+mdatabaseInstance->escapeData(job.getOutputPath())+"',";
-    query+="errorPath='"+mdatabaseInstance->escapeData(job.getErrorPath())+"',";
-    query+="scriptContent='job', ";
-    query+="jobPrio="+vishnu::convertToString(job.getJobPrio())+", ";
-    query+="nbCpus="+vishnu::convertToString(job.getNbCpus())+", ";
-    query+="jobWorkingDir='"+mdatabaseInstance->escapeData(job.getJobWorkingDir())+"', ";
-    query+="status="+vishnu::convertToString(job.getStatus())+", ";
-    query+="submitDate=CURRENT_TIMESTAMP, ";
-    query+="jobQueue='"+mdatabaseInstance->escapeData(job.getJobQueue())+"', ";
-    query+="wallClockLimit="+vishnu::convertToString(job.getWallClockLimit())+", ";
-    query+="groupName='"+mdatabaseInstance->escapeData(job.getGroupName())+"',";
-    query+="jobDescription='"+mdatabaseInstance->escapeData(job.getJobDescription())+"', ";
-    query+="memLimit="+vishnu::convertToString(job.getMemLimit())+", ";
-    query+="nbNodes="+vishnu::convertToString(job.getNbNodes())+", ";
-    query+="nbNodesAndCpuPerNode='"+mdatabaseInstance->escapeData(job.getNbNodesAndCpuPerNode())+"', ";
-    query+="outputDir='"+mdatabaseInstance->escapeData(job.getOutputDir())+"', ";
-    query+= job.getWorkId()? "workId="+vishnu::convertToString(job.getWorkId())+", " : "";
-    query+="vmId='"+mdatabaseInstance->escapeData(job.getVmId())+"', ";
-    query+="vmIp='"+mdatabaseInstance->escapeData(job.getVmIp())+"', ";
-    query+="relatedSteps='"+mdatabaseInstance->escapeData(job.getRelatedSteps())+"'";
-    query+=" WHERE jobid='"+mdatabaseInstance->escapeData(job.getJobId())+"';";
-
-    mdatabaseInstance->process(query);
-
-    // logging
-    if (job.getSubmitError().empty()) {
-      LOG(boost::str(boost::format("[INFO] job submitted: %1%. User: %2%. Owner: %3%")
-                     % job.getJobId()
-                     % muserSessionInfo.userid
-                     % muserSessionInfo.user_aclogin), LogInfo);
-    } else {
-      LOG((boost::str(boost::format("[WARN] submission error: %1% [%2%]")
-                      % job.getJobId()
-                      % job.getSubmitError())), LogWarning);
+    std::vector<std::string> columns;
+    std::vector<std::string> values;
+    std::vector<bool> nulls;
+    getJobRecord(job, columns, values, nulls);
+    // the NULL values are left unchanged
+    std::vector<std::string> params;
+    std::string query = "UPDATE job set submitDate=CURRENT_TIMESTAMP";
+    for (size_t i = 0; i < columns.size(); ++i) {
+      if (! nulls[i]) {
+        query += ", " + columns[i] + "=" + Database::addParam(params, values[i]);
+      }
     }
+    query+=" WHERE jobid="+Database::addParam(params, job.getJobId())+";";
+
+    mdatabaseInstance->processPrepared(query, params, transacId);
+    logSubmission(job);
   } else {
     throw TMSVishnuException(ERRCODE_INVALID_PARAM, "unknown batch action");
   }
 }
 
 
+/**
+ * \brief Function to get the columns of the record of a submitted job
+ * @param job The concerned job, the machine name is added to its paths if necessary
+ * @param columns The columns of the record
+ * @param values The values of the columns, as text
+ * @param nulls Whether each value is NULL
+ */
+void
+JobServer::getJobRecord(TMS_Data::Job& job,
+                        std::vector<std::string>& columns,
+                        std::vector<std::string>& values,
+                        std::vector<bool>& nulls)
+{
+  // Append the machine name to the error and output path if necessary
+  size_t pos = job.getOutputPath().find(":");
+  std::string prefixOutputPath = (pos == std::string::npos)? muserSessionInfo.machine_name+":" : "";
+  job.setOutputPath(prefixOutputPath+job.getOutputPath());
+  pos = job.getErrorPath().find(":");
+  std::string prefixErrorPath = (pos == std::string::npos)? muserSessionInfo.machine_name+":" : "";
+  job.setErrorPath(prefixErrorPath+job.getErrorPath());
+
+  columns.clear();
+  values.clear();
+  columns.push_back("vsession_numsessionid"); values.push_back(vishnu::convertToString(muserSessionInfo.num_session));
+  columns.push_back("job_owner_id"); values.push_back(vishnu::convertToString(muserSessionInfo.num_user));
+  columns.push_back("owner"); values.push_back(job.getOwner());
+  columns.push_back("submitMachineId"); values.push_back(mmachineId);
+  columns.push_back("machine_id"); values.push_back(muserSessionInfo.num_machine);
+  columns.push_back("submitMachineName"); values.push_back(muserSessionInfo.machine_name);
+  columns.push_back("batchJobId"); values.push_back(job.getBatchJobId());
+  columns.push_back("batchType"); values.push_back(vishnu::convertToString(mbatchType));
+  columns.push_back("jobName"); values.push_back(job.getJobName());
+  columns.push_back("jobPath"); values.push_back(job.getJobPath());
+  columns.push_back("outputPath"); values.push_back(job.getOutputPath());
+  columns.push_back("errorPath"); values.push_back(job.getErrorPath());
+  columns.push_back("scriptContent"); values.push_back("job");
+  columns.push_back("jobPrio"); values.push_back(vishnu::convertToString(job.getJobPrio()));
+  columns.push_back("nbCpus"); values.push_back(vishnu::convertToString(job.getNbCpus()));
+  columns.push_back("jobWorkingDir"); values.push_back(job.getJobWorkingDir());
+  columns.push_back("status"); values.push_back(vishnu::convertToString(job.getStatus()));
+  columns.push_back("jobQueue"); values.push_back(job.getJobQueue());
+  columns.push_back("wallClockLimit"); values.push_back(vishnu::convertToString(job.getWallClockLimit()));
+  columns.push_back("groupName"); values.push_back(job.getGroupName());
+  columns.push_back("jobDescription"); values.push_back(job.getJobDescription());
+  columns.push_back("memLimit"); values.push_back(vishnu::convertToString(job.getMemLimit()));
+  columns.push_back("nbNodes"); values.push_back(vishnu::convertToString(job.getNbNodes()));
+  columns.push_back("nbNodesAndCpuPerNode"); values.push_back(job.getNbNodesAndCpuPerNode());
+  columns.push_back("outputDir"); values.push_back(job.getOutputDir());
+  size_t workIdColumn = columns.size();
+  columns.push_back("workId"); values.push_back(vishnu::convertToString(job.getWorkId()));
+  columns.push_back("vmId"); values.push_back(job.getVmId());
+  columns.push_back("vmIp"); values.push_back(job.getVmIp());
+  columns.push_back("relatedSteps"); values.push_back(job.getRelatedSteps());
+
+  // no work is NULL
+  nulls.assign(columns.size(), false);
+  nulls[workIdColumn] = (job.getWorkId() == 0);
+}
+
+/**
+ * \brief Function to log the submission of a job
+ * @param job The submitted job
+ */
+void
+JobServer::logSubmission(const TMS_Data::Job& job)
+{
+  if (job.getSubmitError().empty()) {
+    LOG(boost::str(boost::format("[INFO] job submitted: %1%. User: %2%. Owner: %3%")
+                   % job.getJobId()
+                   % muserSessionInfo.userid
+                   % muserSessionInfo.user_aclogin), LogInfo);
+  } else {
+    LOG((boost::str(boost::format("[WARN] submission error: %1% [%2%]")
+                    % job.getJobId()
+                    % job.getSubmitError())), LogWarning);
+  }
+}
+
 /**
  * @brief Get the uid corresponding to given system user name
  * @param username
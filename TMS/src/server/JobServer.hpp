@@ -181,9 +181,30 @@ private:
    * \brief Function to save the encapsulated job into the database
    * @param action The type of action to finalize (submit, cancel...)
    * @param job The concerned job
+   * @param transacId the id of the transaction if one is used
    */
   void
-  updateJobRecordIntoDatabase(int action, TMS_Data::Job& job);
+  updateJobRecordIntoDatabase(int action, TMS_Data::Job& job, int transacId = -1);
+
+  /**
+   * \brief Function to get the columns of the record of a submitted job
+   * @param job The concerned job, the machine name is added to its paths if necessary
+   * @param columns The columns of the record
+   * @param values The values of the columns, as text
+   * @param nulls Whether each value is NULL
+   */
+  void
+  getJobRecord(TMS_Data::Job& job,
+               std::vector<std::string>& columns,
+               std::vector<std::string>& values,
+               std::vector<bool>& nulls);
+
+  /**
+   * \brief Function to log the submission of a job
+   * @param job The submitted job
+   */
+  void
+  logSubmission(const TMS_Data::Job& job);
 
   /**
    * \brief Function to set the Working Directory
@@ -20,6 +20,7 @@
 #include "BatchServer.hpp"
 #include "BatchFactory.hpp"
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
 
 /**
  * \class ListJobServer
@@ -34,7 +35,7 @@ public:
    * \brief Constructor, raises an exception on error
    */
   ListJobServer(std::string authkey)
-    : QueryServer<TMS_Data::ListJobsOptions, TMS_Data::ListJobs>() {
+    : QueryServer<TMS_Data::ListJobsOptions, TMS_Data::ListJobs>(authkey) {
     mcommandName = "vishnu_list_jobs";
     UserSessionInfo userSessionInfo;
     vishnu::validateAuthKey(authkey, mdatabaseInstance, userSessionInfo);
@@ -176,11 +177,17 @@ public:
    */
   TMS_Data::ListJobs*
   list(TMS_Data::ListJobsOptions_ptr options) {
+    // the archived jobs are terminal, they are read when the filters may return some
+    bool terminal = (options->getStatus() == -1)
+                    ? !(options->getJobId().empty() && options->getMultipleStatus().empty())
+                    : options->getStatus() >= vishnu::STATE_COMPLETED;
+    time_t fromSubmitDate = static_cast<time_t>(options->getFromSubmitDate());
     std::string sqlQuery =
         "SELECT vsessionid, submitMachineId, submitMachineName, jobId, jobName, workId, jobPath,"
         " outputPath, errorPath, jobPrio, nbCpus, jobWorkingDir, job.status, submitDate, endDate, owner, jobQueue,"
-        " wallClockLimit, groupName, jobDescription, memLimit, nbNodes, nbNodesAndCpuPerNode, batchJobId, userid "
-        "FROM job, vsession, users "
+        " wallClockLimit, groupName, jobDescription, memLimit, nbNodes, nbNodesAndCpuPerNode, batchJobId, userid, job.numjobid "
+        "FROM " + vishnu::getHistoryTable("job", terminal, fromSubmitDate)
+        + ", " + vishnu::getHistoryTable("vsession", terminal, fromSubmitDate) + ", users "
         "WHERE vsession.numsessionid=job.vsession_numsessionid"
         " AND vsession.users_numuserid=users.numuserid";
 
@@ -189,70 +196,24 @@ public:
       sqlQuery.append(" and job.submitMachineId='"+mdatabaseInstance->escapeData(options->getMachineId())+"'");
     }
 
-    std::vector<std::string>::iterator ii;
-    std::vector<std::string> results;
-
     TMS_Data::TMS_DataFactory_ptr ecoreFactory = TMS_Data::TMS_DataFactory::_instance();
     mlistObject = ecoreFactory->createListJobs();
 
     processOptions(options, sqlQuery);
-    sqlQuery.append(" order by submitDate");
-
-    boost::scoped_ptr<DatabaseResult> ListOfJobs (mdatabaseInstance->getResult(sqlQuery));
-    long nbRunningJobs = 0;
-    long nbWaitingJobs = 0;
-    std::string batchJobId;
-    std::vector<std::string> ignoredIds;
-
-    int nbJobs = ListOfJobs->getNbTuples();
-    if (nbJobs != 0) {
-
-      for (size_t i = 0; i < nbJobs; ++i) {
-        results.clear();
-        results = ListOfJobs->get(i);
-        ii = results.begin();
-
-        TMS_Data::Job_ptr job = ecoreFactory->createJob();
-
-        job->setSessionId(*ii);
-        job->setSubmitMachineId(*(++ii));
-        job->setSubmitMachineName(*(++ii));
-        job->setJobId(*(++ii));
-        job->setJobName(*(++ii));
-        job->setWorkId(vishnu::convertToLong(*(++ii)));
-        job->setJobPath(*(++ii));
-        job->setOutputPath(*(++ii));
-        job->setErrorPath(*(++ii));
-        job->setJobPrio(vishnu::convertToInt(*(++ii)));
-        job->setNbCpus(vishnu::convertToInt(*(++ii)));
-        job->setJobWorkingDir(*(++ii));
-        job->setStatus(vishnu::convertToInt(*(++ii)));
+    if (! addPageRequest("job.numjobid", sqlQuery)) {
+      sqlQuery.append(" order by submitDate");
+    }
 
-        if (job->getStatus() == vishnu::STATE_RUNNING) {
-          nbRunningJobs++;
-        } else if(job->getStatus() >= vishnu::STATE_SUBMITTED
-                  && job->getStatus() <= vishnu::STATE_WAITING) {
-          nbWaitingJobs++;
-        }
-        job->setSubmitDate( vishnu::string_to_time_t(*(++ii)) );
-        job->setEndDate( vishnu::string_to_time_t(*(++ii)) );
-        job->setOwner(*(++ii));
-        job->setJobQueue(*(++ii));
-        job->setWallClockLimit(vishnu::convertToInt(*(++ii)));
-        job->setGroupName(*(++ii));
-        job->setJobDescription(*(++ii));
-        job->setMemLimit(vishnu::convertToInt(*(++ii)));
-        job->setNbNodes(vishnu::convertToInt(*(++ii)));
-        job->setNbNodesAndCpuPerNode(*(++ii));
-        batchJobId = *(++ii);
-        job->setBatchJobId(batchJobId);
-        ignoredIds.push_back(batchJobId);
-        job->setUserId(*(++ii));
-        mlistObject->getJobs().push_back(job);
-      }
+    // the jobs are built as the tuples are fetched, no copy of the result
+    // is held; the list still holds every job until it is serialized into
+    // the response, the page options bound its size
+    mnbRunningJobs = 0;
+    mnbWaitingJobs = 0;
+    mdatabaseInstance->forEachRow(sqlQuery, boost::bind(&ListJobServer::appendJob, this, _1));
+    if (mlistObject->getJobs().size() != 0) {
       mlistObject->setNbJobs(mlistObject->getJobs().size());
-      mlistObject->setNbRunningJobs(nbRunningJobs);
-      mlistObject->setNbWaitingJobs(nbWaitingJobs);
+      mlistObject->setNbRunningJobs(mnbRunningJobs);
+      mlistObject->setNbWaitingJobs(mnbWaitingJobs);
     }
     return mlistObject;
   }
@@ -276,6 +237,52 @@ public:
 
 private:
 
+  /**
+   * \brief To add a job of the listing
+   * \param row The tuple describing the job
+   */
+  void
+  appendJob(const DatabaseResult::Row& row) {
+    if (! addToPage(row.getString(25))) {
+      return;
+    }
+    TMS_Data::Job_ptr job = TMS_Data::TMS_DataFactory::_instance()->createJob();
+
+    job->setSessionId(row.getString(0));
+    job->setSubmitMachineId(row.getString(1));
+    job->setSubmitMachineName(row.getString(2));
+    job->setJobId(row.getString(3));
+    job->setJobName(row.getString(4));
+    job->setWorkId(row.getLong(5));
+    job->setJobPath(row.getString(6));
+    job->setOutputPath(row.getString(7));
+    job->setErrorPath(row.getString(8));
+    job->setJobPrio(row.getInt(9));
+    job->setNbCpus(row.getInt(10));
+    job->setJobWorkingDir(row.getString(11));
+    job->setStatus(row.getInt(12));
+
+    if (job->getStatus() == vishnu::STATE_RUNNING) {
+      mnbRunningJobs++;
+    } else if(job->getStatus() >= vishnu::STATE_SUBMITTED
+              && job->getStatus() <= vishnu::STATE_WAITING) {
+      mnbWaitingJobs++;
+    }
+    job->setSubmitDate(row.getTimestamp(13));
+    job->setEndDate(row.getTimestamp(14));
+    job->setOwner(row.getString(15));
+    job->setJobQueue(row.getString(16));
+    job->setWallClockLimit(row.getInt(17));
+    job->setGroupName(row.getString(18));
+    job->setJobDescription(row.getString(19));
+    job->setMemLimit(row.getInt(20));
+    job->setNbNodes(row.getInt(21));
+    job->setNbNodesAndCpuPerNode(row.getString(22));
+    job->setBatchJobId(row.getString(23));
+    job->setUserId(row.getString(24));
+    mlistObject->getJobs().push_back(job);
+  }
+
   /////////////////////////////////
   // Attributes
   /////////////////////////////////
@@ -284,6 +291,14 @@ private:
    * \brief The name of the ListJobServer command line
    */
   std::string mcommandName;
+  /**
+   * \brief The number of running jobs of the listing
+   */
+  long mnbRunningJobs;
+  /**
+   * \brief The number of waiting jobs of the listing
+   */
+  long mnbWaitingJobs;
 };
 
 #endif
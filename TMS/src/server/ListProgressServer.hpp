@@ -34,7 +34,7 @@ public:
    * \brief Constructor, raises an exception on error
    */
   ListProgressServer(const std::string& authkey)
-    : QueryServer<TMS_Data::ProgressOptions, TMS_Data::ListProgression>(),
+    : QueryServer<TMS_Data::ProgressOptions, TMS_Data::ListProgression>(authkey),
     mcommandName("vishnu_get_job_progress")
   {
     UserSessionInfo userSessionInfo;
@@ -9,6 +9,7 @@
 #include "DbFactory.hpp"
 #include "RequestFactory.hpp"
 #include "utilVishnu.hpp"
+#include "utilServer.hpp"
 #include <boost/format.hpp>
 
 using namespace vishnu;
@@ -71,6 +72,7 @@ AuthSystemServer::add(void) {
         sqlUpdate+="WHERE authsystemid='"+mdatabaseVishnu->escapeData(mauthsystem->getAuthSystemId())+"';";
 
         mdatabaseVishnu->process(sqlUpdate);
+        vishnu::invalidateReferenceCache("authsystem");
 
         //If the Ldap base is defined and the type is ldap
         if (mauthsystem->getType() == LDAPTYPE ) { // LDAP
@@ -189,6 +191,7 @@ AuthSystemServer::update() {
         //If there is a change
         if (!sqlCommand.empty()) {
           mdatabaseVishnu->process(sqlCommand.c_str());
+          vishnu::invalidateReferenceCache("authsystem");
         }
       } //End if the user-authentication system exists
       else {
@@ -231,6 +234,7 @@ AuthSystemServer::deleteAuthSystem() {
                                          " WHERE authsystemid='%2%'"
                                          )%vishnu::STATUS_DELETED %mdatabaseVishnu->escapeData(mauthsystem->getAuthSystemId())).str();
         mdatabaseVishnu->process(sql);
+        vishnu::invalidateReferenceCache("authsystem");
 
         // Deleting all the auth account when the auth system is deleted
         std::string req = mdatabaseVishnu->getRequest(VR_UPDATE_AUTHACCOUNT_WITH_AUTHSYSTEM);
@@ -280,8 +284,7 @@ std::string
 AuthSystemServer::getAttribut(std::string condition, std::string attrname) {
 
   std::string sqlCommand("SELECT "+attrname+" FROM authsystem "+condition);
-  boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlCommand.c_str()));
-  return result->getFirstElement();
+  return vishnu::getReferenceValue("authsystem", sqlCommand, mdatabaseVishnu);
 }
 
 /**
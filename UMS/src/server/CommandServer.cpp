@@ -11,6 +11,13 @@
 #include <boost/format.hpp>
 using namespace vishnu;
 
+/**
+ * \brief The statement recording commands, %1% is the list of rows
+ */
+static const std::string insertCommand = "INSERT INTO command (vsession_numsessionid, starttime,"  //%RELAX<MISRA_0_1_3> Used in this file
+                                         "   endtime, description, ctype, status, vishnuobjectid)"
+                                         " VALUES %1%";
+
 /**
 * \brief Constructor
 * \param session The object which encapsulates session data
@@ -57,24 +64,67 @@ CommandServer::record(CmdType cmdType,
                       std::string startTime,
                       std::string endTime) {
 
-  std::string numsess = msessionServer.getAttribut("WHERE sessionkey='"+msessionServer.getData().getSessionKey()+"'", "numsessionid");
-  std::string sqlCmd = (boost::format("INSERT INTO command (vsession_numsessionid, starttime,"
-                                      "   endtime, description, ctype, status, vishnuobjectid)"
-                                      " VALUES (%1%,%2%,%3%,'%4%',%5%,%6%,'%7%');"
-                                      )
-                        %numsess
-                        %startTime
-                        %endTime
-                        %mdatabaseVishnu->escapeData(mcommand)
-                        %convertToString(cmdType)
-                        %convertToString(cmdStatus)
-                        %mdatabaseVishnu->escapeData(newVishnuObjectID)
-                        ).str();
-
-  mdatabaseVishnu->process(sqlCmd.c_str());
+  std::string row = getRow(cmdType, cmdStatus, newVishnuObjectID, startTime, endTime);
+  DbFactory factory;
+  DbWriteBehind* writeBehind = factory.getWriteBehindInstance();
+  if (writeBehind != NULL) {
+    writeBehind->enqueue(insertCommand, row);
+  } else {
+    mdatabaseVishnu->process(boost::str(boost::format(insertCommand) % row));
+  }
   return 0;
 }
 
+/**
+* \brief Function to get the request recording the command, to send it
+* with other requests
+* \param cmdType The type of the command (UMS, TMS, FMS)
+* \param cmdStatus The status of the command
+* \param newVishnuObjectID the new vishnu object Id
+* \return the request
+*/
+std::string
+CommandServer::getRecordRequest(CmdType cmdType,
+                                CmdStatus cmdStatus,
+                                const std::string& newVishnuObjectID) {
+  return boost::str(boost::format(insertCommand)
+                    % getRow(cmdType, cmdStatus, newVishnuObjectID,
+                             "CURRENT_TIMESTAMP", "CURRENT_TIMESTAMP"));
+}
+
+/**
+* \brief Function to get the row of the command
+* \param cmdType The type of the command (UMS, TMS, FMS)
+* \param cmdStatus The status of the command
+* \param newVishnuObjectID the new vishnu object Id
+* \param startTime The start time of command
+* \param endTime The end time of command
+* \return the values of the row
+*/
+std::string
+CommandServer::getRow(CmdType cmdType,
+                      CmdStatus cmdStatus,
+                      const std::string& newVishnuObjectID,
+                      const std::string& startTime,
+                      const std::string& endTime) {
+  // the session checked by the request is known, otherwise the insert
+  // resolves it itself, saving a round trip
+  std::string numSession = msessionServer.getNumSessionId();
+  if (numSession.empty()) {
+    numSession = "(SELECT numsessionid FROM vsession WHERE sessionkey='"
+                 + mdatabaseVishnu->escapeData(msessionServer.getData().getSessionKey()) + "')";
+  }
+  return (boost::format("(%1%,%2%,%3%,'%4%',%5%,%6%,'%7%')")
+          %numSession
+          %startTime
+          %endTime
+          %mdatabaseVishnu->escapeData(mcommand)
+          %convertToString(cmdType)
+          %convertToString(cmdStatus)
+          %mdatabaseVishnu->escapeData(newVishnuObjectID)
+          ).str();
+}
+
 /**
 * \brief Function to check if commands are running
 * \return true if commands are running else false
@@ -51,6 +51,18 @@ public:
          std::string startTime = "CURRENT_TIMESTAMP",
          std::string endTime = "CURRENT_TIMESTAMP");
   /**
+  * \brief Function to get the request recording the command, to send it
+  * with other requests
+  * \param cmdType The type of the command (UMS, TMS, FMS)
+  * \param cmdStatus The status of the command
+  * \param newVishnuObjectID the new vishnu object Id
+  * \return the request
+  */
+  std::string
+  getRecordRequest(vishnu::CmdType cmdType,
+                   vishnu::CmdStatus cmdStatus,
+                   const std::string& newVishnuObjectID);
+  /**
   * \brief Function to check if commands are running
   * \return true if commands are running else false
   */
@@ -63,6 +75,21 @@ public:
 
   private:
   /**
+  * \brief Function to get the row of the command
+  * \param cmdType The type of the command (UMS, TMS, FMS)
+  * \param cmdStatus The status of the command
+  * \param newVishnuObjectID the new vishnu object Id
+  * \param startTime The start time of command
+  * \param endTime The end time of command
+  * \return the values of the row
+  */
+  std::string
+  getRow(vishnu::CmdType cmdType,
+         vishnu::CmdStatus cmdStatus,
+         const std::string& newVishnuObjectID,
+         const std::string& startTime,
+         const std::string& endTime);
+  /**
   * \brief An instance of vishnu database
   */
   Database *mdatabaseVishnu;
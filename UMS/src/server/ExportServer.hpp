@@ -8,6 +8,7 @@
 #ifndef __EXPORTSERVER__HH__
 #define __EXPORTSERVER__HH__
 
+#include <ostream>
 #include <string>
 #include <ecore.hpp> // Ecore metamodel
 #include <ecorecpp.hpp> // EMF4CPP utils
@@ -31,13 +32,14 @@ public:
    */
   ~ExportServer();
   /**
-   * \brief To export the commands made in the oldSession in the file filename with the options op
+   * \brief To export the commands made in the oldSession, written to the
+   * output as they are read from the database
    * \param oldSession: Session id of the old session to export
-   * \param content: The content of the export (OUT)
+   * \param output: The stream receiving the export, a response or a file
    * \return Return if the export was a SUCCESS
    */
   virtual int
-  exporte(std::string oldSession, std::string &content) = 0;
+  exporte(const std::string& oldSession, std::ostream& output) = 0;
 protected:
   /**
    * \brief To get the name of the mapper for the shell
@@ -34,7 +34,7 @@ public:
    * \brief Constructor, raises an exception on error
    */
   ListAuthAccountsServer(const SessionServer session)
-    : QueryServer<UMS_Data::ListAuthAccOptions, UMS_Data::ListAuthAccounts>(),
+    : QueryServer<UMS_Data::ListAuthAccOptions, UMS_Data::ListAuthAccounts>(session.getData().getSessionKey()),
     mcommandName("vishnu_list_auth_accounts"),
     msessionServer(session)
   {
@@ -33,7 +33,7 @@ public:
    * \brief Constructor, raises an exception on error
    */
   ListAuthSystemsServer(const SessionServer& session)
-    : QueryServer<UMS_Data::ListAuthSysOptions, UMS_Data::ListAuthSystems>(),
+    : QueryServer<UMS_Data::ListAuthSysOptions, UMS_Data::ListAuthSystems>(session.getData().getSessionKey()),
       mcommandName("vishnu_list_auth_systems"),
       msessionServer(session)
   {
@@ -13,6 +13,7 @@
 #include <list>
 #include <iostream>
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include <boost/bind.hpp>
 
 #include "SessionServer.hpp"
 #include "ListCmdOptions.hpp"
@@ -101,12 +102,13 @@ public:
   UMS_Data::ListCommands* list(UMS_Data::ListCmdOptions_ptr option)
 	{
 		std::string sqlListOfCommands;
-		std::vector<std::string>::iterator ii;
-		std::vector<std::string> results;
-		std::string description;
 
-		sqlListOfCommands = "SELECT ctype, vsessionid, name, description, starttime, endtime, command.status from "
-				" vsession, clmachine, command, users where vsession.numsessionid=command.vsession_numsessionid and "
+		// the archived commands started before the archival age
+		time_t startDate = static_cast<time_t>(option->getStartDateOption());
+		sqlListOfCommands = "SELECT ctype, vsessionid, name, description, starttime, endtime, command.status, command.numcommandid from "
+				+ vishnu::getHistoryTable("vsession", true, startDate) + ", clmachine, "
+				+ vishnu::getHistoryTable("command", true, startDate) + ", users"
+				" where vsession.numsessionid=command.vsession_numsessionid and "
 				" vsession.clmachine_numclmachineid=clmachine.numclmachineid and  vsession.users_numuserid=users.numuserid";
 
 
@@ -123,30 +125,20 @@ public:
 		}
 
     processOptions(userServer, option, sqlListOfCommands);
-		sqlListOfCommands.append(" order by starttime");
-		//To get the list of commands from the database
-    boost::scoped_ptr<DatabaseResult> ListOfCommands (mdatabaseInstance->getResult(sqlListOfCommands.c_str()));
-		for (size_t i = 0; i < ListOfCommands->getNbTuples(); ++i) {
-
-			results.clear();
-			results = ListOfCommands->get(i);
-			ii = results.begin();
-
-			UMS_Data::Command_ptr command = ecoreFactory->createCommand();
-			vishnu::CmdType currentCmdType = static_cast<vishnu::CmdType>(vishnu::convertToInt(*ii));
-			command->setCommandId(convertCmdType(static_cast<vishnu::CmdType>(currentCmdType)));
-			command->setSessionId(*(++ii));
-			command->setMachineId(*(++ii));
-			//MAPPER CREATION
-			Mapper* mapper = MapperRegistry::getInstance()->getMapper(convertypetoMapperName(currentCmdType));
-			description = mapper->decode(*(++ii));
-			command->setCmdDescription(description);
-			command->setCmdStartTime(convertToTimeType(*(++ii)));
-			command->setCmdEndTime(convertToTimeType(*(++ii)));
-			command->setStatus(vishnu::convertToInt(*(++ii)));
-
-			mlistObject->getCommands().push_back(command);
+		if (! addPageRequest("command.numcommandid", sqlListOfCommands)) {
+			sqlListOfCommands.append(" order by starttime");
 		}
+		//The deferred commands must be listed too
+		DbFactory factory;
+		if (factory.getWriteBehindInstance() != NULL) {
+			factory.getWriteBehindInstance()->flush();
+		}
+		//To get the list of commands from the database, the commands are
+		//built as the tuples are fetched; the list still holds every command
+		//until it is serialized into the response, the page options bound its
+		//size
+		mdatabaseInstance->forEachRow(sqlListOfCommands,
+		                              boost::bind(&ListCommandsServer::appendCommand, this, _1));
 		return mlistObject;
 	}
 
@@ -219,6 +211,30 @@ public:
 
 private:
 
+	/**
+	 * \brief To add a command of the listing
+	 * \param row The tuple describing the command
+	 */
+	void
+	appendCommand(const DatabaseResult::Row& row) {
+		if (! addToPage(row.getString(7))) {
+			return;
+		}
+		UMS_Data::Command_ptr command = UMS_Data::UMS_DataFactory::_instance()->createCommand();
+		vishnu::CmdType currentCmdType = static_cast<vishnu::CmdType>(row.getInt(0));
+		command->setCommandId(convertCmdType(currentCmdType));
+		command->setSessionId(row.getString(1));
+		command->setMachineId(row.getString(2));
+		//MAPPER CREATION
+		Mapper* mapper = MapperRegistry::getInstance()->getMapper(convertypetoMapperName(currentCmdType));
+		command->setCmdDescription(mapper->decode(row.getString(3)));
+		command->setCmdStartTime(convertToTimeType(row.getString(4)));
+		command->setCmdEndTime(convertToTimeType(row.getString(5)));
+		command->setStatus(row.getInt(6));
+
+		mlistObject->getCommands().push_back(command);
+	}
+
 	/**
 	 * \brief The name of the ListCommandsServer command line
 	 */
@@ -33,7 +33,7 @@ public:
    * \param session The object which encapsulates the session information (ex: identifier of the session)
    */
   ListLocalAccountsServer(const SessionServer session)
-    : QueryServer<UMS_Data::ListLocalAccOptions, UMS_Data::ListLocalAccounts>(),
+    : QueryServer<UMS_Data::ListLocalAccOptions, UMS_Data::ListLocalAccounts>(session.getData().getSessionKey()),
       mcommandName("vishnu_list_local_accounts"),
       msessionServer(session)
   {
@@ -92,7 +92,7 @@ public:
    */
   UMS_Data::ListLocalAccounts* list(UMS_Data::ListLocalAccOptions_ptr option)
   {
-    std::string sqlListofLocalAccount = boost::str(boost::format("SELECT machineid, userid, aclogin, home"
+    std::string sqlListofLocalAccount = boost::str(boost::format("SELECT machineid, userid, aclogin, home, account.numaccountid"
                                                                  " FROM account, machine, users"
                                                                  " WHERE account.machine_nummachineid=machine.nummachineid"
                                                                  " AND account.users_numuserid=users.numuserid"
@@ -116,12 +116,16 @@ public:
 
       //To process options
       processOptions(userServer, option, sqlListofLocalAccount);
+      addPageRequest("account.numaccountid", sqlListofLocalAccount);
 
       boost::scoped_ptr<DatabaseResult> ListofLocalAccount (mdatabaseInstance->getResult(sqlListofLocalAccount.c_str()));
       if (ListofLocalAccount->getNbTuples() != 0){
         for (size_t i = 0; i < ListofLocalAccount->getNbTuples(); ++i) {
           dbResults.clear();
           dbResults = ListofLocalAccount->get(i);
+          if (! addToPage(dbResults.back())) {
+            break;
+          }
           dbResultIter = dbResults.begin();
 
           UMS_Data::LocalAccount_ptr localAccount = ecoreFactory->createLocalAccount();
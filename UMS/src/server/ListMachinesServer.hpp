@@ -33,7 +33,7 @@ public:
    * \param session The object which encapsulates the session information (ex: identifier of the session)
    */
   ListMachinesServer(const SessionServer session)
-    : QueryServer<UMS_Data::ListMachineOptions, UMS_Data::ListMachines>(),
+    : QueryServer<UMS_Data::ListMachineOptions, UMS_Data::ListMachines>(session.getData().getSessionKey()),
       mcommandName("vishnu_list_machines"),
       msessionServer(session)
   {
@@ -50,7 +50,7 @@ public:
   processOptions(UserServer userServer, const UMS_Data::ListMachineOptions_ptr& options, std::string& sqlRequest)
   {
     std::string sqlJoinLstMachines = (boost::format("SELECT machineid, name, site, machine.status,"
-                                                    "        lang, description, userid "
+                                                    "        lang, description, userid, machine.nummachineid "
                                                     " FROM machine, description, account, users"
                                                     " WHERE machine.nummachineid = description.machine_nummachineid"
                                                     " AND account.machine_nummachineid = machine.nummachineid "
@@ -100,7 +100,7 @@ public:
   * \return raises an exception on error
   */
   UMS_Data::ListMachines* list(UMS_Data::ListMachineOptions_ptr option) {
-    std::string sqlListofMachines = (boost::format("SELECT machineid, name, site, status, lang, description"
+    std::string sqlListofMachines = (boost::format("SELECT machineid, name, site, status, lang, description, machine.nummachineid"
                                                    " FROM machine, description"
                                                    " WHERE machine.nummachineid = description.machine_nummachineid"
                                                    " AND machine.status != %1%")%vishnu::STATUS_DELETED).str();
@@ -117,12 +117,16 @@ public:
 
       //To process options
       processOptions(userServer, option, sqlListofMachines);
+      addPageRequest("machine.nummachineid", sqlListofMachines);
 
       boost::scoped_ptr<DatabaseResult> ListofMachines (mdatabaseInstance->getResult(sqlListofMachines.c_str()));
       if (ListofMachines->getNbTuples() != 0){
         for (size_t i = 0; i < ListofMachines->getNbTuples(); ++i) {
           results.clear();
           results = ListofMachines->get(i);
+          if (! addToPage(results.back())) {
+            break;
+          }
           ii = results.begin();
           UMS_Data::Machine_ptr machine = ecoreFactory->createMachine();
           machine->setMachineId(*ii);
@@ -32,7 +32,7 @@ public:
    * \param session The object which encapsulates the session information (ex: identifier of the session)
    */
   ListSessionsServer(const SessionServer session)
-    : QueryServer<UMS_Data::ListSessionOptions, UMS_Data::ListSessions>(),
+    : QueryServer<UMS_Data::ListSessionOptions, UMS_Data::ListSessions>(session.getData().getSessionKey()),
       mcommandName("vishnu_list_sessions"),
       msessionServer(session)
   {
@@ -62,7 +62,8 @@ public:
       checkClientMachineName(options->getMachineId());
 
       sqlRequest = "SELECT vsessionid, userid, sessionkey, state, closepolicy, timeout, lastconnect,"
-                   "creation, closure, authid from vsession, users, clmachine where vsession.users_numuserid=users.numuserid"
+                   "creation, closure, authid, vsession.numsessionid from " + getSessionTable(options) + ", users, clmachine"
+                   " where vsession.users_numuserid=users.numuserid"
                    " and vsession.clmachine_numclmachineid=clmachine.numclmachineid";
       addOptionRequest("name", options->getMachineId(), sqlRequest);
     }
@@ -135,7 +136,8 @@ public:
   list(UMS_Data::ListSessionOptions_ptr option)
   {
     std::string sqlListOfSessions = "SELECT vsessionid, userid, sessionkey, state, closepolicy, timeout, lastconnect, "
-                                    "creation, closure, authid from vsession, users where vsession.users_numuserid=users.numuserid";
+                                    "creation, closure, authid, vsession.numsessionid from " + getSessionTable(option) + ", users"
+                                    " where vsession.users_numuserid=users.numuserid";
 
     std::vector<std::string>::iterator ii;
     std::vector<std::string> results;
@@ -149,7 +151,9 @@ public:
     if (userServer.exist()) {
 
       processOptions(userServer, option, sqlListOfSessions);
-      sqlListOfSessions.append(" order by creation");
+      if (! addPageRequest("vsession.numsessionid", sqlListOfSessions)) {
+        sqlListOfSessions.append(" order by creation");
+      }
       //To get the list of sessions from the database
       boost::scoped_ptr<DatabaseResult> ListOfSessions (mdatabaseInstance->getResult(sqlListOfSessions.c_str()));
 
@@ -157,6 +161,9 @@ public:
         for (size_t i = 0; i < ListOfSessions->getNbTuples(); ++i) {
           results.clear();
           results = ListOfSessions->get(i);
+          if (! addToPage(results.back())) {
+            break;
+          }
           ii = results.begin();
 
           UMS_Data::Session_ptr session = ecoreFactory->createSession();
@@ -202,6 +209,20 @@ public:
 
 private:
 
+  /**
+   * \brief Function to get the table of the sessions to list, the archived
+   * sessions are closed and created before the archival age
+   * \param options the object which contains the ListSessionServer options values
+   * \return the table of the sessions
+   */
+  std::string
+  getSessionTable(const UMS_Data::ListSessionOptions_ptr& options)
+  {
+    return vishnu::getHistoryTable("vsession",
+                                   options->getStatus() == vishnu::SESSION_CLOSED,
+                                   static_cast<time_t>(options->getStartDateOption()));
+  }
+
   /**
   * \brief The name of the ListSessionsServer command line
   */
@@ -34,7 +34,7 @@ public:
    * \brief Constructor, raises an exception on error
    */
   ListUsersServer(const SessionServer& session)
-    : QueryServer<UMS_Data::ListUsersOptions, UMS_Data::ListUsers>(),
+    : QueryServer<UMS_Data::ListUsersOptions, UMS_Data::ListUsers>(session.getData().getSessionKey()),
       mcommandName("vishnu_list_users"),
       msessionServer(session)
   {
@@ -118,7 +118,9 @@ public:
 
       processOptions(userServer, option, sqlQuery);
 
-      sqlQuery.append(" ORDER BY userid");
+      if (! addPageRequest("userid", sqlQuery)) {
+        sqlQuery.append(" ORDER BY userid");
+      }
 
       //To get the list of users from the database
       boost::scoped_ptr<DatabaseResult> ListofUsers (mdatabaseInstance->getResult(sqlQuery));
@@ -128,6 +130,9 @@ public:
           results.clear();
           results = ListofUsers->get(resultIndex);
           dbResultIter = results.begin();
+          if (! addToPage(*dbResultIter)) {
+            break;
+          }
           UMS_Data::User_ptr user = ecoreFactory->createUser();
           user->setUserId(*dbResultIter);
           user->setPassword(*(++dbResultIter));
@@ -7,6 +7,7 @@
 
 #include "LocalAccountServer.hpp"
 #include "DbFactory.hpp"
+#include "UMSEntity.hpp"
 #include <boost/format.hpp>
 
 /**
@@ -34,23 +35,18 @@ LocalAccountServer::add() {
   UserServer userServer = UserServer(msessionServer);
   userServer.init();
 
-  //Creation of the object machine
-  UMS_Data::Machine *machine = new UMS_Data::Machine();
-  machine->setMachineId(mlocalAccount->getMachineId());
-  MachineServer machineServer = MachineServer(machine);
   //if the user exists
   if (userServer.exist()) {
     //if the session key is for the owner of the local account or the user is an admin
     if (userServer.getData().getUserId().compare(mlocalAccount->getUserId()) == 0 ||
         userServer.isAdmin()){
       //if the machine exists and it is not locked
-      if (machineServer.getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mlocalAccount->getMachineId())+"'"
-                                    " and status=1").size() != 0) {
-        //To get the database number id of the machine
-        numMachine = machineServer.getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mlocalAccount->getMachineId())+"'");
+      MachineEntity machineEntity;
+      if (machineEntity.load(mdatabaseVishnu, mlocalAccount->getMachineId())
+          && machineEntity.status == vishnu::STATUS_ACTIVE) {
+        numMachine = machineEntity.numMachineId;
         //To get the database number id of the user
-        std::string request = (boost::format("where userid='"+mdatabaseVishnu->escapeData(mlocalAccount->getUserId())+"' and status != %1%")%vishnu::STATUS_DELETED).str();
-        numUser = userServer.getAttribut(request);
+        numUser = getNumUserId(userServer, true);
 
         if (numUser.empty()) {
           throw UMSVishnuException (ERRCODE_UNKNOWN_USERID,
@@ -70,6 +66,7 @@ LocalAccountServer::add() {
                                   %mdatabaseVishnu->escapeData(mlocalAccount->getHomeDirectory())
                                   %vishnu::STATUS_ACTIVE).str();
             mdatabaseVishnu->process(sqlCmd);
+            vishnu::invalidateReferenceCache("account");
           } else {
             mmutex.unlock();
             throw UMSVishnuException(ERRCODE_LOGIN_ALREADY_USED);
@@ -101,11 +98,6 @@ LocalAccountServer::update() {
   UserServer userServer = UserServer(msessionServer);
   userServer.init();
 
-  //Creation of the object machine
-  UMS_Data::Machine *machine = new UMS_Data::Machine();
-  machine->setMachineId(mlocalAccount->getMachineId());
-  MachineServer machineServer = MachineServer(machine);
-
   //if the user exists
   if (userServer.exist()) {
     //if the session key is for the owner of the local account or the user is an admin
@@ -113,18 +105,13 @@ LocalAccountServer::update() {
         userServer.isAdmin()){
 
       // Check if if the machine exists and is not locked
-      std::string sqlcond = (boost::format("WHERE machineid='%1%'"
-                                           " AND status=%2%"
-                                          )%mdatabaseVishnu->escapeData(mlocalAccount->getMachineId()) %vishnu::STATUS_ACTIVE).str();
-      if (!(machineServer.getAttribut(sqlcond, "nummachineid").empty())) {
-
-        // Get the database number id of the machine
-        sqlcond = (boost::format("WHERE machineid='%1%'")%mdatabaseVishnu->escapeData(mlocalAccount->getMachineId())).str();
-        std::string numMachine = machineServer.getAttribut(sqlcond, "nummachineid");
+      MachineEntity machineEntity;
+      if (machineEntity.load(mdatabaseVishnu, mlocalAccount->getMachineId())
+          && machineEntity.status == vishnu::STATUS_ACTIVE) {
+        std::string numMachine = machineEntity.numMachineId;
 
         // Get the database number id of the user
-        sqlcond = (boost::format("WHERE userid='%1%'")%mdatabaseVishnu->escapeData(mlocalAccount->getUserId())).str();
-        std::string  numUser = userServer.getAttribut(sqlcond, "numuserid");
+        std::string  numUser = getNumUserId(userServer, false);
 
         mmutex.lock();
         //if the local account exists
@@ -150,6 +137,8 @@ LocalAccountServer::update() {
                                              " WHERE machine_nummachineid=%2%"
                                              "   AND users_numuserid=%3%")%fields %numMachine %numUser).str();
             mdatabaseVishnu->process(sql);
+            vishnu::invalidateReferenceCache("account");
+            vishnu::invalidateSessionCache();
           }
           mmutex.unlock();
         } else {
@@ -183,11 +172,6 @@ LocalAccountServer::deleteLocalAccount() {
   UserServer userServer = UserServer(msessionServer);
   userServer.init();
 
-  //Creation of the object machine
-  UMS_Data::Machine *machine = new UMS_Data::Machine();
-  machine->setMachineId(mlocalAccount->getMachineId());
-  MachineServer machineServer = MachineServer(machine);
-
   //if the user exists
   if (userServer.exist()) {
     //if the session key is for the owner of the local account or the user is an admin
@@ -195,13 +179,13 @@ LocalAccountServer::deleteLocalAccount() {
         userServer.isAdmin()){
 
       //if the machine exists and it is not locked
-      if (machineServer.getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mlocalAccount->getMachineId())+"'"
-                                    " and status=1").size() != 0) {
+      MachineEntity machineEntity;
+      if (machineEntity.load(mdatabaseVishnu, mlocalAccount->getMachineId())
+          && machineEntity.status == vishnu::STATUS_ACTIVE) {
 
-        //To get the database number id of the machine
-        numMachine = machineServer.getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mlocalAccount->getMachineId())+"'");
+        numMachine = machineEntity.numMachineId;
         //To get the database number id of the user
-        numUser = userServer.getAttribut("where userid='"+mdatabaseVishnu->escapeData(mlocalAccount->getUserId())+"'");
+        numUser = getNumUserId(userServer, false);
 
         //if the local account exists
         if (exist(numMachine, numUser)) {
@@ -212,6 +196,8 @@ LocalAccountServer::deleteLocalAccount() {
                                            " AND users_numuserid=%3%"
                                            )%vishnu::STATUS_DELETED %numMachine %numUser).str();
           mdatabaseVishnu->process(sql);
+          vishnu::invalidateReferenceCache("account");
+          vishnu::invalidateSessionCache();
         }//END if the local account exists
         else {
           UMSVishnuException e (ERRCODE_UNKNOWN_LOCAL_ACCOUNT);
@@ -258,8 +244,27 @@ std::string
 LocalAccountServer::getAttribut(std::string condition, std::string attrname) {
 
   std::string sqlCommand("SELECT "+attrname+" FROM account "+condition);
-  boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlCommand.c_str()));
-  return result->getFirstElement();
+  return vishnu::getReferenceValue("account", sqlCommand, mdatabaseVishnu);
+}
+
+/**
+* \brief Function to get the database number id of the owner of the local
+* account, without request if it is the user of the session
+* \param userServer The user of the session, checked
+* \param active Whether the owner must not be deleted
+* \return the database number id, empty if the owner is not found
+*/
+std::string
+LocalAccountServer::getNumUserId(UserServer& userServer, bool active) {
+  if (userServer.getData().getUserId() == mlocalAccount->getUserId()) {
+    return userServer.getEntity().numUserId;
+  }
+  std::string sqlcond = (boost::format("WHERE userid='%1%'")
+                         %mdatabaseVishnu->escapeData(mlocalAccount->getUserId())).str();
+  if (active) {
+    sqlcond += (boost::format(" AND status != %1%")%vishnu::STATUS_DELETED).str();
+  }
+  return userServer.getAttribut(sqlcond, "numuserid");
 }
 
 /**
@@ -100,6 +100,15 @@ private:
   bool
   exist(std::string idmachine, std::string iduser);
   /**
+  * \brief Function to get the database number id of the owner of the local
+  * account, without request if it is the user of the session
+  * \param userServer The user of the session, checked
+  * \param active Whether the owner must not be deleted
+  * \return the database number id, empty if the owner is not found
+  */
+  std::string
+  getNumUserId(UserServer& userServer, bool active);
+  /**
   * \brief Function to check if a given login is used on a machine
   * \param numMachine the internal id of the machine
   * \param acLogin the account login
@@ -8,6 +8,7 @@
 #include "MachineServer.hpp"
 #include "DbFactory.hpp"
 #include "RequestFactory.hpp"
+#include "UMSEntity.hpp"
 #include "utilVishnu.hpp"
 #include "utilServer.hpp"
 #include <boost/format.hpp>
@@ -62,7 +63,8 @@ MachineServer::add(void) {
         mmachine->setMachineId(idMachineGenerated);
 
         //if the machineId does not exist
-        if (getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mmachine->getMachineId())+"'","count(*)") == "1") {
+        MachineEntity entity;
+        if (entity.load(mdatabaseVishnu, mmachine->getMachineId())) {
           //To active the machine status
           mmachine->setStatus(vishnu::STATUS_ACTIVE);
 
@@ -71,9 +73,10 @@ MachineServer::add(void) {
           sqlUpdate+="status="+convertToString(mmachine->getStatus());
           sqlUpdate+=" where machineid='"+mdatabaseVishnu->escapeData(mmachine->getMachineId())+"';";
           mdatabaseVishnu->process(sqlUpdate);
+          vishnu::invalidateReferenceCache("machine");
 
           mdatabaseVishnu->process("insert into description (machine_nummachineid, lang, description) values ("
-                                   +getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mmachine->getMachineId())+"'")
+                                   +entity.numMachineId
                                    +",'"
                                    + mdatabaseVishnu->escapeData(mmachine->getLanguage())
                                    +"','"
@@ -123,9 +126,9 @@ MachineServer::update() {
     if (userServer.isAdmin()) {
 
       //if the machine to update exists
-      std::string sqlcond = (boost::format("WHERE machineid = '%1%'"
-                                           " AND status != %2%")%mdatabaseVishnu->escapeData(mmachine->getMachineId()) %vishnu::STATUS_DELETED).str();
-      if (!getAttribut(sqlcond, "nummachineid").empty()) {
+      MachineEntity entity;
+      if (entity.load(mdatabaseVishnu, mmachine->getMachineId())
+          && entity.status != vishnu::STATUS_DELETED) {
 
         //if a new machine name has been defined
         if (!mmachine->getName().empty()) {
@@ -148,7 +151,7 @@ MachineServer::update() {
         //if a new language has been defined
         if (!mmachine->getLanguage().empty()) {
           sqlCommand.append("UPDATE description SET lang='"+mdatabaseVishnu->escapeData(mmachine->getLanguage())+"'"
-                            " where machine_nummachineid='"+getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mmachine->getMachineId())+"'")+"';");
+                            " where machine_nummachineid='"+entity.numMachineId+"';");
         }
 
         //if a new machine description has been defined
@@ -156,12 +159,14 @@ MachineServer::update() {
           sqlCommand.append("UPDATE description SET description='"
                             +mdatabaseVishnu->escapeData(mmachine->getMachineDescription())+"'"
                             " WHERE machine_nummachineid='"
-                            +getAttribut("where machineid='"+mdatabaseVishnu->escapeData(mmachine->getMachineId())+"'")+"';");
+                            +entity.numMachineId+"';");
         }
 
         //If there is a change
         if (!sqlCommand.empty()) {
           mdatabaseVishnu->process(sqlCommand.c_str());
+          vishnu::invalidateReferenceCache("machine");
+          vishnu::invalidateSessionCache();
         }
 
       } //End if the machine to update exists
@@ -199,7 +204,9 @@ MachineServer::deleteMachine() {
                              %mdatabaseVishnu->escapeData(mmachine->getMachineId())
                              ).str();
 
-    return mdatabaseVishnu->process(sqlUpdate.c_str());
+    ret = mdatabaseVishnu->process(sqlUpdate.c_str());
+    vishnu::invalidateReferenceCache("account");
+    vishnu::invalidateSessionCache();
   }
   return ret;
 } //END: deleteMachine()
@@ -230,8 +237,7 @@ std::string
 MachineServer::getAttribut(std::string condition, std::string attrname) {
 
   std::string sqlCommand("SELECT "+attrname+" FROM machine "+condition);
-  boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlCommand.c_str()));
-  return result->getFirstElement();
+  return vishnu::getReferenceValue("machine", sqlCommand, mdatabaseVishnu);
 }
 
 /**
@@ -252,18 +258,14 @@ MachineServer::getMachineName() {
 */
 void MachineServer::checkMachine() {
 
-  std::string sqlcond ("");
-
-  sqlcond = (boost::format("WHERE machineid = '%1%'"
-                           " AND status != %2%")%mdatabaseVishnu->escapeData(mmachine->getMachineId()) %vishnu::STATUS_DELETED).str();
-  if (getAttribut(sqlcond, "nummachineid").empty()){
+  MachineEntity entity;
+  if (! entity.load(mdatabaseVishnu, mmachine->getMachineId())
+      || entity.status == vishnu::STATUS_DELETED) {
     throw UMSVishnuException(ERRCODE_UNKNOWN_MACHINE,
                              (boost::format("No machine with this id (%1%)")%mmachine->getMachineId()).str());
   }
 
-  sqlcond = (boost::format("WHERE machineid = '%1%'"
-                           " AND status = %2%")%mdatabaseVishnu->escapeData(mmachine->getMachineId()) %vishnu::STATUS_LOCKED).str();
-  if(!getAttribut(sqlcond, "nummachineid").empty()) {
+  if (entity.status == vishnu::STATUS_LOCKED) {
     throw UMSVishnuException(ERRCODE_MACHINE_LOCKED);
   }
 }
@@ -8,6 +8,7 @@
 #include "SessionServer.hpp"
 #include "CommandServer.hpp"
 #include "DbFactory.hpp"
+#include "DbTransaction.hpp"
 #include "boost/format.hpp"
 
 
@@ -17,7 +18,7 @@ using namespace boost::posix_time;
  * \brief Constructor
  */
 SessionServer::SessionServer()
-  : mtimeout(DEFAULT_CONNECTION_TIMEOUT)
+  : mtimeout(DEFAULT_CONNECTION_TIMEOUT), mnumSessionId("")
 {
   DbFactory factory;
   msession.setSessionKey("");
@@ -30,7 +31,7 @@ SessionServer::SessionServer()
  * \param timeout Lenght of the connection before timeout
  */
 SessionServer::SessionServer(std::string sessionKey, int timeout)
-  : mtimeout(timeout)
+  : mtimeout(timeout), mnumSessionId("")
 {
   DbFactory factory;
   msession.setSessionKey(sessionKey);
@@ -43,7 +44,8 @@ SessionServer::SessionServer(std::string sessionKey, int timeout)
  */
 SessionServer::SessionServer(const UMS_Data::Session& session, int timeout)
   : msession(session),
-    mtimeout(timeout)
+    mtimeout(timeout),
+    mnumSessionId("")
 {
   DbFactory factory;
   mdatabaseVishnu = factory.getDatabaseInstance();
@@ -57,7 +59,6 @@ SessionServer::SessionServer(const UMS_Data::Session& session, int timeout)
  */
 int
 SessionServer::connectSession(UserServer user, MachineClientServer host, UMS_Data::ConnectOptions* connectOpt) {
-  std::string numSubstituteUserId;
   std::string numUserIdToconnect;
 
   msession.setAuthenId(user.getData().getUserId());
@@ -66,11 +67,14 @@ SessionServer::connectSession(UserServer user, MachineClientServer host, UMS_Dat
   if (user.isAuthenticate()) {
     if (! connectOpt->getSubstituteUserId().empty()) {
       if (user.isAdmin()) {
-        numSubstituteUserId = user.getAttribut("where "
-                                               "userid='"+mdatabaseVishnu->escapeData(connectOpt->getSubstituteUserId())+"'");
+        UserEntity substitute;
+        std::string sqlcond = (boost::format("WHERE userid='%1%'"
+                                             " AND status != %2%")
+                               %mdatabaseVishnu->escapeData(connectOpt->getSubstituteUserId())
+                               %vishnu::STATUS_DELETED).str();
         //If the user to substitute exist
-        if (! user.getNumUserId(connectOpt->getSubstituteUserId()).empty()) {
-          numUserIdToconnect = numSubstituteUserId;
+        if (substitute.load(mdatabaseVishnu, sqlcond)) {
+          numUserIdToconnect = substitute.numUserId;
           msession.setUserId(connectOpt->getSubstituteUserId());
         } else {
           throw UMSVishnuException (ERRCODE_UNKNOWN_USERID);
@@ -82,12 +86,11 @@ SessionServer::connectSession(UserServer user, MachineClientServer host, UMS_Dat
 
     //if there is not a numSubstituteUserId
     if (numUserIdToconnect.empty()) {
-      numUserIdToconnect = user.getAttribut("where userid='"+mdatabaseVishnu->escapeData(user.getData().getUserId())+"'"
-                                            " and pwd='"+mdatabaseVishnu->escapeData(user.getData().getPassword())+"'");
+      numUserIdToconnect = user.getEntity().numUserId;
       msession.setUserId(user.getData().getUserId());
     } //END if There is not a numSubstituteUserId
 
-    generateSessionKey(user.getData().getUserId());
+    generateSessionKey();
     generateSessionId(user.getData().getUserId());
 
     //To solve the connection mode
@@ -125,8 +128,7 @@ SessionServer::reconnect(UserServer user, MachineClientServer host,
         if (user.isAdmin()) {
           existSessionKey = getSessionkey("", "", true);
         } else {
-          existSessionKey = getSessionkey(host.getId(), user.getAttribut("where userid='"+mdatabaseVishnu->escapeData(user.getData().getUserId())+"'"
-                                                                         " and pwd='"+mdatabaseVishnu->escapeData(user.getData().getPassword())+"'"));
+          existSessionKey = getSessionkey(host.getId(), user.getEntity().numUserId);
         }
         //if there is no session key with the previous parameters
         if (existSessionKey == -1) {
@@ -167,6 +169,7 @@ SessionServer::close() {
         mdatabaseVishnu->process((boost::format("UPDATE vsession"
                                                 " SET closure=CURRENT_TIMESTAMP"
                                                 " WHERE sessionkey='%1%';")%mdatabaseVishnu->escapeData(msession.getSessionKey())).str());
+        vishnu::invalidateSessionCache();
       } else {
         extractClosePolicyCond = boost::str(boost::format(" WHERE sessionkey='%1%';")
                                             % mdatabaseVishnu->escapeData(msession.getSessionKey()));
@@ -219,43 +222,82 @@ SessionServer::getAttribut(std::string condition, std::string attrname) {
 int
 SessionServer::saveConnection() {
 
-  std::string sqlCommand = "UPDATE vsession SET lastconnect=CURRENT_TIMESTAMP"
-                           " WHERE sessionkey='"+mdatabaseVishnu->escapeData(msession.getSessionKey())+"'";
+  std::string statement = "UPDATE vsession SET lastconnect=CURRENT_TIMESTAMP"
+                          " WHERE sessionkey IN (%1%)";
+  std::string key = "'"+mdatabaseVishnu->escapeData(msession.getSessionKey())+"'";
 
-  mdatabaseVishnu->process(sqlCommand);
+  DbFactory factory;
+  DbWriteBehind* writeBehind = factory.getWriteBehindInstance();
+  if (writeBehind != NULL) {
+    // requests of a same session within a flush interval are merged
+    writeBehind->enqueue(statement, key, true);
+  } else {
+    mdatabaseVishnu->process(boost::str(boost::format(statement) % key));
+  }
   return 0;
 }
 
 /**
- * \brief Function to get the list of sessions with close on timeout mode to close
- * \return the list of results
+ * \brief Function to close, in a single request, the sessions with close on
+ * timeout mode whose timeout is over and which run no command
+ * \return the number of sessions closed
  */
-DatabaseResult*
-SessionServer::getSessionToclosebyTimeout() {
-  DatabaseResult* result;
-  std::string sqlCommand;
+size_t
+SessionServer::closeSessionsByTimeout() {
+  std::string elapsed;
 
   switch(mdatabaseVishnu->getDbType()) {
     case DbConfiguration::MYSQL:
-      sqlCommand = "SELECT sessionkey from vsession where "
-                   " unix_timestamp(CURRENT_TIMESTAMP) - unix_timestamp(lastconnect) > timeout and state=1 "
-                   " and closepolicy=1";
+      elapsed = "unix_timestamp(CURRENT_TIMESTAMP) - unix_timestamp(lastconnect)";
       break;
     case DbConfiguration::POSTGRESQL:
-      sqlCommand = "SELECT sessionkey from vsession where "
-                   " EXTRACT( epoch FROM  CURRENT_TIMESTAMP ) - EXTRACT( epoch FROM lastconnect ) > timeout and state=1 "
-                   " and closepolicy=1";
+      elapsed = "EXTRACT( epoch FROM  CURRENT_TIMESTAMP ) - EXTRACT( epoch FROM lastconnect )";
+      break;
+    case DbConfiguration::SQLITE:
+      elapsed = "strftime('%s', CURRENT_TIMESTAMP) - strftime('%s', lastconnect)";
       break;
     case DbConfiguration::ORACLE:
-      throw SystemException(ERRCODE_DBERR, "SessionServer::getSessionToclosebyTimeout: Oracle query not defined");
+      throw SystemException(ERRCODE_DBERR, "SessionServer::closeSessionsByTimeout: Oracle query not defined");
       break;
     default:
       break;
   }
 
-  result = mdatabaseVishnu->getResult(sqlCommand);
-  return result;
+  // as close(), a session running a command stays open
+  std::string sqlCommand = boost::str(boost::format("UPDATE vsession"
+                                                    " SET state=%1%, closure=CURRENT_TIMESTAMP"
+                                                    " WHERE state=%2%"
+                                                    " AND closepolicy=%3%"
+                                                    " AND %4% > timeout"
+                                                    " AND NOT EXISTS (SELECT numcommandid FROM command"
+                                                    "  WHERE command.vsession_numsessionid=vsession.numsessionid"
+                                                    "  AND command.endtime IS NULL)")
+                                      % vishnu::SESSION_CLOSED
+                                      % vishnu::SESSION_ACTIVE
+                                      % vishnu::CLOSE_ON_TIMEOUT
+                                      % elapsed);
+
+  size_t closed;
+  if (mdatabaseVishnu->getDbType() == DbConfiguration::MYSQL
+      || mdatabaseVishnu->getDbType() == DbConfiguration::SQLITE) {
+    // no RETURNING (SQLite before 3.35), the count is read on the
+    // connection of the update
+    std::string count = (mdatabaseVishnu->getDbType() == DbConfiguration::MYSQL) ?
+      "SELECT ROW_COUNT()" : "SELECT changes()";
+    DbTransaction transaction(mdatabaseVishnu);
+    mdatabaseVishnu->process(sqlCommand, transaction.getId());
+    boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(count, transaction.getId()));
+    transaction.commit();
+    closed = vishnu::convertToInt(result->getFirstElement());
+  } else {
+    boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlCommand + " RETURNING numsessionid"));
+    closed = result->getNbTuples();
+  }
 
+  if (closed != 0) {
+    vishnu::invalidateSessionCache();
+  }
+  return closed;
 }
 
 /**
@@ -267,7 +309,19 @@ SessionServer::check() {
 
   int retCode = -1;
 
-  std::string sqlQuery = (boost::format("SELECT state, status, passwordstate"
+  // only the valid sessions are kept, the others are read again to raise
+  // the right error
+  DbFactory factory;
+  DbSessionCache* cache = factory.getSessionCacheInstance();
+  std::string key = "check\n" + msession.getSessionKey();
+  unsigned long generation = 0;
+  std::vector<std::string> row;
+  if (cache != NULL && cache->get(key, row, generation)) {
+    mnumSessionId = row.at(3);
+    return 0;
+  }
+
+  std::string sqlQuery = (boost::format("SELECT state, status, passwordstate, numsessionid"
                                         " FROM users, vsession "
                                         " WHERE users.numuserid = vsession.users_numuserid"
                                         " AND vsession.sessionkey='%1%'"
@@ -284,6 +338,10 @@ SessionServer::check() {
       if (vishnu::convertToInt(tmp[1]) == vishnu::STATUS_ACTIVE) {
         if (vishnu::convertToInt(tmp[2]) == vishnu::STATUS_ACTIVE) {
           retCode = 0;
+          mnumSessionId = tmp[3];
+          if (cache != NULL) {
+            cache->put(key, tmp, generation);
+          }
         } else {
           throw UMSVishnuException (ERRCODE_TEMPORARY_PASSWORD);
         }
@@ -315,43 +373,83 @@ SessionServer::finish(std::string cmdDescription,
                       const std::string& newVishnuObjectID,
                       bool checkSession) {
 
-  //To save the date of the last connection
   if (checkSession) {
     check();
   }
-  saveConnection();
-  //To save the command
-  CommandServer commandServer = CommandServer(cmdDescription, *this);
-  commandServer.record(cmdType, cmdStatus, newVishnuObjectID);
+  // the session must read its changes from the primary database
+  DbFactory factory;
+  DbReplicaRouter* router = factory.getReplicaRouterInstance();
+  if (router != NULL) {
+    router->noteWrite(msession.getSessionKey());
+  }
+  recordCommand(cmdDescription, cmdType, cmdStatus, newVishnuObjectID);
   return 0;
 }
 
-
 /**
- * \brief Function to generate the session key
- * \param salt This string is used to perturb the algorithm
- * \return an encrypted message registered on the session data structure
- */
+* \brief Function to finalize a read-only service
+* \param cmdDescription The description of the command
+* \param cmdType The type of the command (UMS, TMS, FMS)
+* \param cmdStatus The status of the command
+* \return raises an exception on error
+*/
 int
-SessionServer::generateSessionKey(std::string salt) {
-
-  std::string sessionKey;
-  //the current time
-  ptime now = microsec_clock::local_time();
+SessionServer::finishQuery(std::string cmdDescription,
+                           vishnu::CmdType cmdType,
+                           vishnu::CmdStatus cmdStatus) {
+  check();
+  recordCommand(cmdDescription, cmdType, cmdStatus, "");
+  return 0;
+}
 
-  //for the md5 encryption
-  std::string tmpSalt = "$1$" + salt + "$";
+/**
+ * \brief Function to get the database number id of the session
+ * \return the id read by check(), empty if the session is not checked
+ */
+std::string
+SessionServer::getNumSessionId() const {
+  return mnumSessionId;
+}
 
-  //for SHA1-512 encryption by using the userId as a salt
-  std::string globalSalt = "$6$"+std::string(crypt(salt.c_str(), tmpSalt.c_str())).substr(tmpSalt.size())+"$";
+/**
+ * \brief Function to save the date of the last connection and the command
+ * \param cmdDescription The description of the command
+ * \param cmdType The type of the command (UMS, TMS, FMS)
+ * \param cmdStatus The status of the command
+ * \param newVishnuObjectID the new vishnu object
+ */
+void
+SessionServer::recordCommand(const std::string& cmdDescription,
+                             vishnu::CmdType cmdType,
+                             vishnu::CmdStatus cmdStatus,
+                             const std::string& newVishnuObjectID) {
+  CommandServer commandServer = CommandServer(cmdDescription, *this);
+  DbFactory factory;
+  if (factory.getWriteBehindInstance() != NULL) {
+    // both are merged with the other requests of the interval
+    saveConnection();
+    commandServer.record(cmdType, cmdStatus, newVishnuObjectID);
+    return;
+  }
 
-  //SHA1-512 encryption of the salt encrypted using the md5 and the current time as the clef
-  sessionKey = std::string(crypt(to_simple_string(now).c_str(), globalSalt.c_str()));
+  // both statements in a single round trip
+  std::vector<std::string> requests;
+  requests.push_back(boost::str(boost::format("UPDATE vsession SET lastconnect=CURRENT_TIMESTAMP"
+                                              " WHERE sessionkey='%1%'")
+                                % mdatabaseVishnu->escapeData(msession.getSessionKey())));
+  requests.push_back(commandServer.getRecordRequest(cmdType, cmdStatus, newVishnuObjectID));
+  mdatabaseVishnu->processBatch(requests);
+}
 
-  //To put a randomize number at the end to complicate the string encrypted
-  sessionKey.append(vishnu::convertToString(vishnu::generateNumbers()));
-  msession.setSessionKey(sessionKey.substr(globalSalt.size()));
 
+/**
+ * \brief Function to generate the session key
+ * \return a random key registered on the session data structure
+ */
+int
+SessionServer::generateSessionKey() {
+  // 384 bits from the random generator of the kernel
+  msession.setSessionKey(vishnu::generateToken(SESSION_KEY_LENGTH));
   return 0;
 }
 /**
@@ -34,6 +34,9 @@ class UserServer;
 
 const int DEFAULT_CONNECTION_TIMEOUT = 3600;
 
+// characters of the session keys, 6 random bits each
+const size_t SESSION_KEY_LENGTH = 64;
+
 /**
 * \class SessionServer
 * \brief UserServer class implementation
@@ -107,11 +110,12 @@ public:
   int
   saveConnection();
   /**
-   * \brief Function to get the list of sessions with close on timeout mode to close
-   * \return the list of results
+   * \brief Function to close, in a single request, the sessions with close
+   * on timeout mode whose timeout is over and which run no command
+   * \return the number of sessions closed
    */
-  DatabaseResult*
-  getSessionToclosebyTimeout();
+  size_t
+  closeSessionsByTimeout();
   /**
    * \brief Function to make a complete checking of the session key
    * \return raises an exception on error
@@ -133,6 +137,24 @@ public:
           vishnu::CmdStatus cmdStatus,
           const std::string& newVishnuObjectID = "",
           bool checkSession=true);
+  /**
+  * \brief Function to finalize a read-only service, the next reads of the
+  * session may go to a replica of the database
+  * \param cmdDescription The description of the command
+  * \param cmdType The type of the command (UMS, TMS, FMS)
+  * \param cmdStatus The status of the command
+  * \return raises an exception on error
+  */
+  int
+  finishQuery(std::string cmdDescription,
+              vishnu::CmdType cmdType,
+              vishnu::CmdStatus cmdStatus);
+  /**
+   * \brief Function to get the database number id of the session
+   * \return the id read by check(), empty if the session is not checked
+   */
+  std::string
+  getNumSessionId() const;
 
   private:
   /////////////////////////////////
@@ -151,17 +173,33 @@ public:
    * @brief Hold connection timeout
    */
   int mtimeout;
+  /**
+   * \brief The database number id of the session, read by check()
+   */
+  std::string mnumSessionId;
 
   /////////////////////////////////
   // Functions
   /////////////////////////////////
   /**
    * \brief Function to generate the session key
-   * \param salt This string is used to perturb the algorithm
-   * \return an encrypted message registered on the session data structure
+   * \return a random key registered on the session data structure
    */
   int
-  generateSessionKey(std::string salt);
+  generateSessionKey();
+  /**
+   * \brief Function to save the date of the last connection and record the
+   * command, in a single round trip
+   * \param cmdDescription The description of the command
+   * \param cmdType The type of the command (UMS, TMS, FMS)
+   * \param cmdStatus The status of the command
+   * \param newVishnuObjectID the new vishnu object Id
+   */
+  void
+  recordCommand(const std::string& cmdDescription,
+                vishnu::CmdType cmdType,
+                vishnu::CmdStatus cmdStatus,
+                const std::string& newVishnuObjectID);
   /**
    * \brief Function to generate the session identifier
    * \param userId the userId of the owner of the session
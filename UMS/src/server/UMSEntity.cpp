@@ -0,0 +1,117 @@
+/**
+* \file UMSEntity.cpp
+* \brief This file implements the entities read by the UMS server classes
+*/
+
+#include "UMSEntity.hpp"
+
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "utilServer.hpp"
+#include "utilVishnu.hpp"
+
+const std::string UserEntity::columns = "users.numuserid, users.userid, users.pwd,"  //%RELAX<MISRA_0_1_3> Used in this file
+                                        " users.privilege, users.status, users.passwordstate";
+
+/**
+ * \brief Constructor, an entity not found
+ */
+UserEntity::UserEntity()
+  : found(false), privilege(-1), status(-1), passwordState(-1) {
+}
+
+/**
+ * \brief Function to read the first user matching a condition, kept by the
+ * cache of the reference tables
+ * \param database The database
+ * \param condition The condition of the select request on the users table
+ * \return true if a user has been found
+ */
+bool
+UserEntity::load(Database* database, const std::string& condition) {
+  read(vishnu::getReferenceRow("users", "SELECT " + columns + " FROM users " + condition, database));
+  return found;
+}
+
+/**
+ * \brief Function to read the fields of a tuple
+ * \param row The tuple, empty if the user is not found
+ * \param first The position of the first field of the user
+ */
+void
+UserEntity::read(const std::vector<std::string>& row, size_t first) {
+  found = row.size() >= first + 6;
+  if (! found) {
+    *this = UserEntity();
+    return;
+  }
+  numUserId = row[first];
+  userId = row[first + 1];
+  pwd = row[first + 2];
+  privilege = vishnu::convertToInt(row[first + 3]);
+  status = vishnu::convertToInt(row[first + 4]);
+  passwordState = vishnu::convertToInt(row[first + 5]);
+}
+
+/**
+ * \brief Constructor, an entity not found
+ */
+SessionEntity::SessionEntity()
+  : found(false), state(-1) {
+}
+
+/**
+ * \brief Function to read a session and its owner
+ * \param database The database
+ * \param sessionKey The key of the session
+ * \return true if the session has been found
+ */
+bool
+SessionEntity::load(Database* database, const std::string& sessionKey) {
+  std::string request = boost::str(boost::format("SELECT vsession.numsessionid, vsession.state, %1%"
+                                                 " FROM vsession, users"
+                                                 " WHERE users.numuserid = vsession.users_numuserid"
+                                                 " AND vsession.sessionkey='%2%'")
+                                   % UserEntity::columns
+                                   % database->escapeData(sessionKey));
+  boost::scoped_ptr<DatabaseResult> result(database->getResult(request));
+  found = result->getNbTuples() != 0;
+  if (found) {
+    std::vector<std::string> row = result->get(0);
+    numSessionId = row.at(0);
+    state = vishnu::convertToInt(row.at(1));
+    user.read(row, 2);
+  }
+  return found;
+}
+
+/**
+ * \brief Constructor, an entity not found
+ */
+MachineEntity::MachineEntity()
+  : found(false), status(-1) {
+}
+
+/**
+ * \brief Function to read a machine, kept by the cache of the reference
+ * tables
+ * \param database The database
+ * \param machineId The identifier of the machine
+ * \return true if the machine has been found
+ */
+bool
+MachineEntity::load(Database* database, const std::string& machineId) {
+  std::string request = boost::str(boost::format("SELECT nummachineid, name, status"
+                                                 " FROM machine"
+                                                 " WHERE machineid='%1%'")
+                                   % database->escapeData(machineId));
+  std::vector<std::string> row = vishnu::getReferenceRow("machine", request, database);
+  found = row.size() >= 3;
+  if (found) {
+    numMachineId = row[0];
+    name = row[1];
+    status = vishnu::convertToInt(row[2]);
+  }
+  return found;
+}
@@ -0,0 +1,152 @@
+/**
+* \file UMSEntity.hpp
+* \brief This file presents the entities read by the UMS server classes
+*/
+
+#ifndef UMS_ENTITY_H
+#define UMS_ENTITY_H
+
+#include <string>
+#include <vector>
+#include "Database.hpp"
+
+/**
+* \class UserEntity
+* \brief The columns of a user checked by the services, read in a single
+* request instead of one request per column
+*/
+class UserEntity {
+public:
+  /**
+   * \brief The columns read, in the order of the fields
+   */
+  static const std::string columns;
+
+  /**
+   * \brief Constructor, an entity not found
+   */
+  UserEntity();
+  /**
+   * \brief Function to read the first user matching a condition, kept by
+   * the cache of the reference tables
+   * \param database The database
+   * \param condition The condition of the select request on the users table
+   * \return true if a user has been found
+   */
+  bool
+  load(Database* database, const std::string& condition);
+  /**
+   * \brief Function to read the fields of a tuple
+   * \param row The tuple, empty if the user is not found
+   * \param first The position of the first field of the user
+   */
+  void
+  read(const std::vector<std::string>& row, size_t first = 0);
+
+  /**
+   * \brief Whether a user has been found
+   */
+  bool found;
+  /**
+   * \brief The database number id of the user
+   */
+  std::string numUserId;
+  /**
+   * \brief The identifier of the user
+   */
+  std::string userId;
+  /**
+   * \brief The encrypted password of the user
+   */
+  std::string pwd;
+  /**
+   * \brief The privilege of the user
+   */
+  int privilege;
+  /**
+   * \brief The status of the user
+   */
+  int status;
+  /**
+   * \brief The state of the password of the user
+   */
+  int passwordState;
+};
+
+/**
+* \class SessionEntity
+* \brief The columns of a session and of its owner, read in a single request
+*/
+class SessionEntity {
+public:
+  /**
+   * \brief Constructor, an entity not found
+   */
+  SessionEntity();
+  /**
+   * \brief Function to read a session and its owner
+   * \param database The database
+   * \param sessionKey The key of the session
+   * \return true if the session has been found
+   */
+  bool
+  load(Database* database, const std::string& sessionKey);
+
+  /**
+   * \brief Whether the session has been found
+   */
+  bool found;
+  /**
+   * \brief The database number id of the session
+   */
+  std::string numSessionId;
+  /**
+   * \brief The state of the session
+   */
+  int state;
+  /**
+   * \brief The owner of the session
+   */
+  UserEntity user;
+};
+
+/**
+* \class MachineEntity
+* \brief The columns of a machine checked by the services, read in a single
+* request
+*/
+class MachineEntity {
+public:
+  /**
+   * \brief Constructor, an entity not found
+   */
+  MachineEntity();
+  /**
+   * \brief Function to read a machine, kept by the cache of the reference
+   * tables
+   * \param database The database
+   * \param machineId The identifier of the machine
+   * \return true if the machine has been found
+   */
+  bool
+  load(Database* database, const std::string& machineId);
+
+  /**
+   * \brief Whether the machine has been found
+   */
+  bool found;
+  /**
+   * \brief The database number id of the machine
+   */
+  std::string numMachineId;
+  /**
+   * \brief The name of the machine
+   */
+  std::string name;
+  /**
+   * \brief The status of the machine
+   */
+  int status;
+};
+
+#endif // UMS_ENTITY_H
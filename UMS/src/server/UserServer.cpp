@@ -19,6 +19,11 @@
 
 using namespace vishnu;
 
+/**
+ * \brief The number of characters of the generated passwords
+ */
+static const size_t GENERATED_PASSWORD_LENGTH = 16;  //%RELAX<MISRA_0_1_3> Used in this file
+
 
 /**
  * \brief Constructor
@@ -70,7 +75,7 @@ UserServer::add(UMS_Data::User*& user, std::string sendmailScriptPath) {
     if (isAdmin()) {
 
       //Generation of password
-      pwd = generatePassword(user->getLastname(), user->getFirstname());
+      pwd = generatePassword();
       user->setPassword(pwd.substr(0,PASSWORD_MAX_SIZE));
 
       //Generation of userid
@@ -98,6 +103,7 @@ UserServer::add(UMS_Data::User*& user, std::string sendmailScriptPath) {
         sqlUpdate+="status="+convertToString(user->getStatus())+" ";
         sqlUpdate+="where userid='"+mdatabaseVishnu->escapeData(user->getUserId())+"';";
         mdatabaseVishnu->process(sqlUpdate);
+        vishnu::invalidateReferenceCache("users");
 
 
         //Send email
@@ -206,6 +212,8 @@ UserServer::update(UMS_Data::User *user) {
                                   % convertToString(vishnu::SESSION_ACTIVE));
             mdatabaseVishnu->process(sqlquery);
           }
+          vishnu::invalidateReferenceCache("users");
+          vishnu::invalidateSessionCache();
         }
       } else {
         throw UMSVishnuException (ERRCODE_UNKNOWN_USERID);
@@ -233,7 +241,9 @@ UserServer::deleteUser(UMS_Data::User user) {
     std::string sqlUpdate = boost::str(boost::format(req)
                                        % vishnu::STATUS_DELETED
                                        % mdatabaseVishnu->escapeData(user.getUserId()));
-    return mdatabaseVishnu->process(sqlUpdate);
+    ret = mdatabaseVishnu->process(sqlUpdate);
+    vishnu::invalidateReferenceCache("account");
+    vishnu::invalidateSessionCache();
   }
   return ret;
 }//END: deleteUser(UMS_Data::User user)
@@ -264,6 +274,7 @@ UserServer::changePassword(const std::string& newPassword) {
                                         % vishnu::STATUS_ACTIVE);
 
       mdatabaseVishnu->process(sqlQuery);
+      vishnu::invalidateReferenceCache("users");
 
       //Put the new user's password
       muser.setPassword(newPassword);
@@ -304,7 +315,7 @@ UserServer::resetPassword(UMS_Data::User& user, const std::string& sendmailScrip
   }
 
   //generation of a new password
-  std::string pwd = generatePassword(user.getUserId(), user.getUserId());
+  std::string pwd = generatePassword();
   user.setPassword(pwd.substr(0,PASSWORD_MAX_SIZE));
 
   //to get the password encryptes
@@ -328,6 +339,9 @@ UserServer::resetPassword(UMS_Data::User& user, const std::string& sendmailScrip
                                             % vishnu::STATUS_LOCKED);
 
   mdatabaseVishnu->process(sqlResetPwdQuery);
+  vishnu::invalidateReferenceCache("users");
+  // the sessions of the user now need a new password
+  vishnu::invalidateSessionCache();
 
   sqlCondition = boost::str(boost::format("WHERE userid='%1%' AND  status !='%2%'")
                             % mdatabaseVishnu->escapeData(user.getUserId())
@@ -363,27 +377,18 @@ UserServer::getData() {
  */
 void
 UserServer::init(){
-  std::string numUser;
-  std::string sessionState;
-
   //if userId and password have not been defined
   if ((muser.getUserId().size() == 0) && (muser.getPassword().size() == 0)) {
-    //To get the users_numuserid by using the sessionServer
-    numUser =
-        msessionServer->getAttribut("where"
-                                    " sessionkey='"+mdatabaseVishnu->escapeData(msessionServer->getData().getSessionKey())+"'", "users_numuserid");
+    //To get the session and its owner in a single request
+    SessionEntity session;
 
     //if the session key is found
-    if (numUser.size() != 0) {
-      //To get the session state
-      sessionState =
-          msessionServer->getAttribut("where"
-                                      " sessionkey='"+mdatabaseVishnu->escapeData(msessionServer->getData().getSessionKey())+"'", "state");
-
+    if (session.load(mdatabaseVishnu, msessionServer->getData().getSessionKey())) {
       //if the session is active
-      if (convertToInt(sessionState) == vishnu::STATUS_ACTIVE) {
-        muser.setUserId(getAttribut("where numuserid='"+numUser+"'", "userid"));
-        muser.setPassword(getAttribut("where numuserid='"+numUser+"'", "pwd"));
+      if (session.state == vishnu::STATUS_ACTIVE) {
+        muser.setUserId(session.user.userId);
+        muser.setPassword(session.user.pwd);
+        mentity = session.user;
       } //End if the session is active
       else {
         throw UMSVishnuException (ERRCODE_SESSIONKEY_EXPIRED);
@@ -404,12 +409,7 @@ UserServer::init(){
 bool
 UserServer::exist(bool flagForChangePwd) {
   //if the user is on the database
-
-  std::string sqlcond = (boost::format("WHERE userid = '%1%'"
-                                       " AND pwd='%2%'"
-                                       " AND status != %3%"
-                                       )%mdatabaseVishnu->escapeData(muser.getUserId()) %mdatabaseVishnu->escapeData(muser.getPassword()) %vishnu::STATUS_DELETED).str();
-  if (!getAttribut(sqlcond, "numuserid").empty()) {
+  if (getEntity().found) {
     CheckUserState(flagForChangePwd);
     return true;
   }
@@ -442,8 +442,7 @@ UserServer::isAuthenticate(bool flagForChangePwd) {
 bool
 UserServer::isAdmin() {
 
-  return (convertToInt (getAttribut("where userid='"+mdatabaseVishnu->escapeData(muser.getUserId())+"'and "
-                                    "pwd='"+mdatabaseVishnu->escapeData(muser.getPassword())+"'", " privilege")) != 0);
+  return (getEntity().found && getEntity().privilege != 0);
 }
 
 /**
@@ -466,8 +465,7 @@ UserServer::isAttributOk(std::string attributName, int valueOk) {
  */
 std::string UserServer::getAttribut(std::string condition, std::string attrname) {
   std::string sqlCommand("SELECT "+attrname+" FROM users "+condition);
-  boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlCommand));
-  return result->getFirstElement();
+  return vishnu::getReferenceValue("users", sqlCommand, mdatabaseVishnu);
 }
 
 /**
@@ -487,19 +485,33 @@ UserServer::getNumUserId(std::string userId) {
   return getAttribut(sqlcond, "numuserid");
 }
 
+/**
+ * \brief Function to get the columns of the user checked by the services,
+ * read once for its userId and password
+ * \return the user, not found if the userId or the password is wrong
+ */
+const UserEntity&
+UserServer::getEntity() {
+  if (! mentity.found
+      || mentity.userId != muser.getUserId()
+      || mentity.pwd != muser.getPassword()
+      || mentity.status == vishnu::STATUS_DELETED) {
+    std::string sqlcond = (boost::format("WHERE userid = '%1%'"
+                                         " AND pwd='%2%'"
+                                         " AND status != %3%"
+                                         )%mdatabaseVishnu->escapeData(muser.getUserId()) %mdatabaseVishnu->escapeData(muser.getPassword()) %vishnu::STATUS_DELETED).str();
+    mentity.load(mdatabaseVishnu, sqlcond);
+  }
+  return mentity;
+}
+
 /**
  * \brief Function to generate a password
- * \param value1 a string used to generate the password
- * \param value2 a string used to generate the password
- * \return an encrypted message
+ * \return a random password
  */
 std::string
-UserServer::generatePassword(std::string value1, std::string value2) {
-
-  std::string salt = convertToString(generateNumbers());
-  std::string clef = value2+convertToString(generateNumbers());
-
-  return (boost::str(boost::format("%1%%2%") % crypt(clef.c_str(), salt.c_str()) % salt.length()));
+UserServer::generatePassword() {
+  return vishnu::generateToken(GENERATED_PASSWORD_LENGTH);
 }
 /**
 * \brief Function to send an email to a user
@@ -661,9 +673,9 @@ UserServer::getUserAccountLogin(const std::string& machineId) {
 */
 void
 UserServer::CheckUserState(bool flagForChangePwd) {
-  if (isAttributOk("status", 1)) {
+  if (getEntity().status == vishnu::STATUS_ACTIVE) {
     if (! flagForChangePwd) {
-      if (! isAttributOk("passwordstate", 1)) {
+      if (getEntity().passwordState != vishnu::STATUS_ACTIVE) {
         throw UMSVishnuException (ERRCODE_TEMPORARY_PASSWORD);
       }
     }
@@ -18,6 +18,7 @@
 #include "UMS_Data.hpp"
 #include "UMS_Data_forward.hpp"
 #include "SessionServer.hpp"
+#include "UMSEntity.hpp"
 
 class SessionServer;
 
@@ -138,6 +139,13 @@ public:
    */
   std::string
   getNumUserId(std::string userId);
+  /**
+   * \brief Function to get the columns of the user checked by the services,
+   * read once for its userId and password
+   * \return the user, not found if the userId or the password is wrong
+   */
+  const UserEntity&
+  getEntity();
 
    /**
    * \brief Function to get the user account login
@@ -175,18 +183,20 @@ private:
   * \brief An object which encapsulates session data
   */
   SessionServer *msessionServer;
+  /**
+  * \brief The columns of the user read by getEntity()
+  */
+  UserEntity mentity;
 
   /////////////////////////////////
   // Functions
   /////////////////////////////////
   /**
    * \brief Function to generate a password
-   * \param value1 a string used to generate the password
-   * \param value2 a string used to generate the password
-   * \return an encrypted message
+   * \return a random password
    */
   std::string
-  generatePassword(std::string value1, std::string value2);
+  generatePassword();
 
   /**
    * \brief Function to send an email to the user
@@ -1,8 +1,11 @@
 #include "ShellExporter.hpp"
 
 #include <string>
-#include <vector>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
 
+#include "DbFactory.hpp"
+#include "DbWriteBehind.hpp"
 #include "utilServer.hpp"
 #include "UserException.hpp"
 #include "Mapper.hpp"
@@ -27,14 +30,7 @@ ShellExporter::~ShellExporter() {
 }
 
 int
-ShellExporter::exporte(std::string oldSession, std::string &content){
-  std::vector<std::string>::iterator iter;
-  std::vector<std::string> line;
-
-  // Init the script
-  content = "#!/bin/sh";
-  content += " \n";
-
+ShellExporter::exporte(const std::string& oldSession, std::ostream& output){
   // Check the user is alloed to export
   if (!muser.isAdmin() && !isAllowed(oldSession, muser)){
     throw UMSVishnuException(ERRCODE_INVALID_PARAM, "The user is not allowed to export this session");
@@ -45,39 +41,39 @@ ShellExporter::exporte(std::string oldSession, std::string &content){
     throw UMSVishnuException(ERRCODE_INVALID_PARAM, "The session id is invalid");
   }
 
-  // The request, ordered by starttime (=submission)
-  std::string req = "SELECT command.ctype, command.description, command.starttime from "
-    " command, vsession where vsession.numsessionid=command.vsession_numsessionid and "
-    " vsession.vsessionid='"+mdatabase->escapeData(oldSession)+"' order by starttime asc";
+  // Init the script
+  output << "#!/bin/sh \n";
 
-  boost::scoped_ptr<DatabaseResult> result (mdatabase->getResult(req.c_str()));
+  // The request, ordered by starttime (=submission), the session may be archived
+  std::string req = "SELECT command.ctype, command.description from "
+    + vishnu::getHistoryTable("command") + ", " + vishnu::getHistoryTable("vsession") + " where vsession.numsessionid=command.vsession_numsessionid and "
+    " vsession.vsessionid='"+mdatabase->escapeData(oldSession)+"' order by starttime asc";
 
-  // Adding all the results to the content
-  for (size_t i = 0 ; i<result->getNbTuples(); i++) {
-    line.clear();
-    line = result->get(i);
-    iter = line.begin();
-    //MAPPER CREATION
-    try {
-      vishnu::CmdType type = static_cast<vishnu::CmdType>(vishnu::convertToInt(*iter));
-      Mapper* mapper = MapperRegistry::getInstance()->getMapper(getMapperName(type));
-    content += mapper->decode(*(++iter));
-    } catch (SystemException &e) {
-      throw (e);
-    }
-    content += " \n";
+  // The deferred commands must be exported too
+  DbFactory factory;
+  if (factory.getWriteBehindInstance() != NULL) {
+    factory.getWriteBehindInstance()->flush();
   }
+  mdatabase->forEachRow(req, boost::bind(&ShellExporter::appendCommand, this, boost::ref(output), _1));
 
   return 0;
 }
 
+void
+ShellExporter::appendCommand(std::ostream& output, const DatabaseResult::Row& row) {
+  //MAPPER CREATION
+  vishnu::CmdType type = static_cast<vishnu::CmdType>(row.getInt(0));
+  Mapper* mapper = MapperRegistry::getInstance()->getMapper(getMapperName(type));
+  output << mapper->decode(row.getString(1)) << " \n";
+}
+
 bool
 ShellExporter::isClosed(std::string sid) {
   bool res = false;
   if (sid.size() < 1) {
     return res;
   }
-  std::string req = "select * from vsession where vsessionid ='"+mdatabase->escapeData(sid)+"' and state='0'";
+  std::string req = "select * from " + vishnu::getHistoryTable("vsession") + " where vsessionid ='"+mdatabase->escapeData(sid)+"' and state='0'";
   try {
     boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(req.c_str()));
     res = (result->getNbTuples()>0);
@@ -90,7 +86,7 @@ ShellExporter::isClosed(std::string sid) {
 bool
 ShellExporter::isAllowed(std::string oldSession, UserServer muser) {
   bool res = false;
-  std::string req = "select * from vsession, users where vsession.vsessionid='"+mdatabase->escapeData(oldSession)+"' and vsession.users_numuserid=users.numuserid and users.userid='"+mdatabase->escapeData(muser.getData().getUserId())+"'";
+  std::string req = "select * from " + vishnu::getHistoryTable("vsession") + ", users where vsession.vsessionid='"+mdatabase->escapeData(oldSession)+"' and vsession.users_numuserid=users.numuserid and users.userid='"+mdatabase->escapeData(muser.getData().getUserId())+"'";
   try {
     boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(req.c_str()));
     res = (result->getNbTuples()>0);
@@ -35,15 +35,24 @@ public:
    */
   ~ShellExporter();
   /**
-   * \brief To export the commands made in the oldSession in the file filename with the options op in the shell format
+   * \brief To export the commands made in the oldSession in the shell format,
+   * a line is written for each command as it is fetched so that the memory
+   * does not grow with the history
    * \param oldSession: Session id of the old session to export
-   * \param content: The content of the export (OUT)
+   * \param output: The stream receiving the script
    * \return Succes, an error code otherwise
    */
   int
-  exporte(std::string oldSession, std::string &content);
+  exporte(const std::string& oldSession, std::ostream& output);
 protected:
 private:
+  /**
+   * \brief Write the line of a command
+   * \param output: The stream receiving the script
+   * \param row: The type and the description of the command
+   */
+  void
+  appendCommand(std::ostream& output, const DatabaseResult::Row& row);
   /**
    * \brief Return true if the session with the session sid sid is closed
    * \param sid: A session id
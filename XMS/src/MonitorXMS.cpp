@@ -68,6 +68,8 @@ MonitorXMS::checkJobs(int batchtype){
 
     std::vector<std::string> buffer;
     std::vector<std::string>::iterator item;
+    // the updates of all the jobs are sent in a single round trip
+    std::vector<std::string> updates;
     for (size_t i = 0; i < result->getNbTuples(); ++i) {
       buffer.clear();
       buffer = result->get(i);
@@ -90,15 +92,7 @@ MonitorXMS::checkJobs(int batchtype){
             state = batchServer->getJobState(job.getBatchJobId());
             break;
         }
-        std::string query = "";
-
-        if (state == vishnu::STATE_COMPLETED) {
-          query.append(boost::str(boost::format("UPDATE job SET endDate=CURRENT_TIMESTAMP"
-                                                " WHERE jobId='%1%';") % job.getJobId()));
-        }
-
-
-        query = boost::str(boost::format("UPDATE job SET status=%1% WHERE jobId='%2%';")
+        std::string query = boost::str(boost::format("UPDATE job SET status=%1% WHERE jobId='%2%';")
                            % vishnu::convertToString(state) % job.getJobId());
 
         if (state == vishnu::STATE_COMPLETED) {
@@ -112,13 +106,13 @@ MonitorXMS::checkJobs(int batchtype){
               switch (state) {
                 case vishnu::STATE_RUNNING:
                   query.append( boost::str(boost::format("UPDATE job SET batchJobId='%1%' WHERE jobId='%2%';")
-                                           % executionOutput
+                                           % mdatabaseVishnu->escapeData(executionOutput)
                                            % job.getJobId()) );
                   break;
                 case vishnu::STATE_FAILED:
                 case vishnu::STATE_CANCELLED:
                   query.append( boost::str(boost::format("UPDATE job SET jobdescription='%1%' WHERE jobId='%2%';")
-                                           % executionOutput
+                                           % mdatabaseVishnu->escapeData(executionOutput)
                                            % job.getJobId()) );
                   break;
                 default:
@@ -129,12 +123,26 @@ MonitorXMS::checkJobs(int batchtype){
 
         }
 
-
-        mdatabaseVishnu->process(query);
+        updates.push_back(query);
       } catch (VishnuException& ex) {
         LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
       }
     }
+
+    try {
+      mdatabaseVishnu->processBatch(updates);
+    } catch (VishnuException& ex) {
+      // nothing has been applied, retry job by job so that a failing
+      // update does not hold back the others
+      LOG(boost::str(boost::format("[TMSMONITOR][WARN] batch update failed: %1%") % ex.what()), LogWarning);
+      for (item = updates.begin(); item != updates.end(); ++item) {
+        try {
+          mdatabaseVishnu->process(*item);
+        } catch (VishnuException& ex) {
+          LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
+        }
+      }
+    }
   } catch (VishnuException& ex) {
     LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
   } catch (...) {
@@ -146,35 +154,12 @@ MonitorXMS::checkJobs(int batchtype){
 void
 MonitorXMS::checkSession(){
   SessionServer closer;
-  std::vector<std::string> tmp;
-  std::vector<std::string>::iterator ii;
   try {
-    boost::scoped_ptr<DatabaseResult> result(closer.getSessionToclosebyTimeout());
-
-    if (result->getNbTuples() != 0) {
-      for (size_t i = 0; i < result->getNbTuples(); ++i) {
-        tmp.clear();
-        tmp = result->get(i);
-
-        ii = tmp.begin();
-        SessionServer sessionServer (*ii);
-
-        try {
-          //closure of the session
-          sessionServer.close();
-        }
-        catch (VishnuException& e) {
-          std::string errorInfo =  e.buildExceptionString();
-          std::cerr << errorInfo << "\n";
-          if (e.getMsgI() == ERRCODE_AUTHENTERR) {
-            //FIXME: Do something for the sed UMS when the monitor goes out
-            std::cerr << errorInfo << "\n";
-            exit(1);
-          }
-        }
-      }
+    // a single update whatever the number of sessions expired
+    size_t closed = closer.closeSessionsByTimeout();
+    if (closed != 0) {
+      LOG(boost::str(boost::format("[UMSMONITOR][INFO] %1% sessions closed on timeout") % closed), LogInfo);
     }
-
   } catch (VishnuException& e) {
     std::string errorInfo =  e.buildExceptionString();
 
@@ -223,6 +208,20 @@ MonitorXMS::checkFile(){
 
 
 
+void
+MonitorXMS::archive() {
+  DbFactory factory;
+  DbArchiver* archiver = factory.getArchiverInstance();
+  if (archiver == NULL) {
+    return;
+  }
+  int moved = archiver->archive();
+  if (moved != 0) {
+    LOG(boost::str(boost::format("[MONITOR][INFO] %1% rows archived") % moved), LogInfo);
+  }
+}
+
+
 int
 MonitorXMS::run() {
   while (kill(getppid(), 0) == 0) {
@@ -238,6 +237,7 @@ MonitorXMS::run() {
     if (mhasFMS) {
       checkFile();
     }
+    archive();
     sleep(minterval);
   }
   return 0;
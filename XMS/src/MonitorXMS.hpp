@@ -48,6 +48,11 @@ private:
   checkJobs(int batchtype);
   void
   checkFile();
+  /**
+   * @brief Move the terminal rows of the history tables to their archive
+   */
+  void
+  archive();
   int minterval;
   std::string mmachineId;
   BatchType mbatchType;
@@ -1,7 +1,10 @@
 #include "ServerXMS.hpp"
 #include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
 #include "AuthenticatorFactory.hpp"
 #include "DbFactory.hpp"
+#include "DbMigrator.hpp"
+#include "DbProfiler.hpp"
 #include "internalApiUMS.hpp"
 #include "internalApiTMS.hpp"
 #include "utilVishnu.hpp"
@@ -19,6 +22,39 @@ FMSMapper *ServerXMS::mmapperFMS = NULL;
 Authenticator *ServerXMS::mauthenticator = NULL;
 
 
+/**
+ * \brief Give the usage of the connection pool and the statistics of the
+ * database requests, the longest cumulated time first
+ * \param pb the profile of the service
+ * \return 0
+ */
+static int
+dbstats(diet_profile_t* pb) {
+  DbFactory factory;
+  DbConnectionPool::stats_t pool = factory.getDatabaseInstance()->getPoolStats();
+  std::string msg = boost::str(
+      boost::format("pool: size %1%, in use %2%, peak %3%, acquisitions %4%, waits %5%,"
+                    " timeouts %6%, total wait %7% ms, max wait %8% ms\n")
+      % pool.size % pool.inUse % pool.peakInUse % pool.acquisitions % pool.waits
+      % pool.timeouts % (pool.totalWaitUs / 1000) % (pool.maxWaitUs / 1000));
+  msg += "count\terrors\ttotal (ms)\tmean (ms)\tmax (ms)\trequest\n";
+  if (factory.getProfilerInstance() != NULL) {
+    std::vector<DbProfiler::stats_t> stats = factory.getProfilerInstance()->getStats();
+    std::vector<DbProfiler::stats_t>::const_iterator it;
+    for (it = stats.begin(); it != stats.end(); ++it) {
+      msg += boost::str(boost::format("%1%\t%2%\t%3%\t%4%\t%5%\t%6%\n")
+                        % it->count % it->errors % (it->totalUs / 1000)
+                        % (it->totalUs / it->count / 1000.0) % (it->maxUs / 1000)
+                        % it->request);
+    }
+  }
+
+  diet_profile_reset(pb, 2);
+  diet_string_set(pb, 1, msg);
+  diet_string_set(pb, 0, "success");
+  return 0;
+}
+
 ServerXMS*
 ServerXMS::getInstance() {
   if (minstance == NULL) {
@@ -57,6 +93,13 @@ ServerXMS::getDatabaseVishnu() {
     return mdatabaseVishnu;
 }
 
+int
+ServerXMS::call(diet_profile_t* profile) {
+  // names the requests of the service in the log of the slow ones
+  DbProfiler::Context context(profile->name);
+  return SeD::call(profile);
+}
+
 int
 ServerXMS::init(SedConfig& cfg) {
   using vishnu::convertToString;
@@ -135,6 +178,10 @@ ServerXMS::init(SedConfig& cfg) {
 
     /*connection to the database*/
     mdatabaseVishnu->connect();
+    if (cfg.dbConfig.getDbSchemaUpgrade()) {
+      DbMigrator migrator(mdatabaseVishnu);
+      migrator.upgrade();
+    }
     mmapperTMS = new TMSMapper(MapperRegistry::getInstance(), TMSMAPPERNAME);
     mmapperTMS->registerMapper();
     mmapperFMS = new FMSMapper(MapperRegistry::getInstance(), FMSMAPPERNAME);
@@ -157,6 +204,8 @@ ServerXMS::ServerXMS() {
 }
 
 ServerXMS::~ServerXMS() {
+  DbFactory factory;
+  factory.closeWriteBehindInstance();
   delete mmapperUMS;
   delete mdatabaseVishnu;
   delete mauthenticator;
@@ -166,6 +215,7 @@ void
 ServerXMS::initMap(const std::string& mid) {
   int (*functionPtr)(diet_profile_t*);
   mcb["heartbeatxmssed@"+mmachineId] = boost::ref(heartbeat);
+  mcb["dbstatsxmssed@"+mmachineId] = boost::ref(dbstats);
   if (mhasUMS) {
       functionPtr = solveSessionConnect;
       mcb[SERVICES_UMS[SESSIONCONNECT]] = functionPtr;
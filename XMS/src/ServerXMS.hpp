@@ -64,6 +64,9 @@ public:
   Database*
   getDatabaseVishnu();
 
+  int
+  call(diet_profile_t* profile);
+
 private:
   void
   initMap(const std::string& mid);
@@ -34,9 +34,14 @@ solveGenerique(diet_profile_t* profile) {
   //IN Parameters
   diet_string_get(profile,0, sessionKey);
   diet_string_get(profile,1, optionValueSerialized);
+  // the page, sent only when the client restricts the listing
+  std::string pageSerialized;
+  if (profile->param_count > 2) {
+    diet_string_get(profile, 2, pageSerialized);
+  }
 
   // reset profile to handle result
-  diet_profile_reset(profile, 2);
+  diet_profile_reset(profile, 3);
 
   SessionServer sessionServer  = SessionServer(sessionKey);
 
@@ -52,6 +57,8 @@ solveGenerique(diet_profile_t* profile) {
 
 
     QueryType query(sessionKey);
+    QueryPage page = QueryPage::deserialize(pageSerialized);
+    query.setPage(page);
 
     //MAPPER CREATION
     Mapper *mapper = MapperRegistry::getInstance()->getMapper(vishnu::FMSMAPPERNAME);
@@ -62,6 +69,7 @@ solveGenerique(diet_profile_t* profile) {
     //  perform the query
 
     list = query.list(options);
+    page.project(list);
 
     ::ecorecpp::serializer::serializer _ser;
 
@@ -70,10 +78,11 @@ solveGenerique(diet_profile_t* profile) {
     //OUT Parameter
     diet_string_set(profile, 0, "success");
     diet_string_set(profile, 1, listSerialized.c_str());
-    sessionServer.finish(cmd, vishnu::FMS, vishnu::CMDSUCCESS);
+    diet_string_set(profile, 2, query.getNextToken());
+    sessionServer.finishQuery(cmd, vishnu::FMS, vishnu::CMDSUCCESS);
   } catch (VishnuException& e) {
     try {
-      sessionServer.finish(cmd, vishnu::FMS, vishnu::CMDFAILED);
+      sessionServer.finishQuery(cmd, vishnu::FMS, vishnu::CMDFAILED);
     } catch (VishnuException& fe) {
       finishError =  fe.what();
       finishError +="\n";
@@ -344,9 +344,14 @@ solveGenerique(diet_profile_t* pb) {
   diet_string_get(pb,0, authKey);
   diet_string_get(pb,1, machineId);
   diet_string_get(pb,2, optionValueSerialized);
+  // the page, sent only when the client restricts the listing
+  std::string pageSerialized;
+  if (pb->param_count > 3) {
+    diet_string_get(pb, 3, pageSerialized);
+  }
 
   // reset profile to handle result
-  diet_profile_reset(pb, 2);
+  diet_profile_reset(pb, 3);
 
   QueryParameters* options = NULL;
   List* list = NULL;
@@ -358,6 +363,8 @@ solveGenerique(diet_profile_t* pb) {
       throw TMSVishnuException(ERRCODE_INVALID_PARAM);
     }
     QueryType query(authKey);
+    QueryPage page = QueryPage::deserialize(pageSerialized);
+    query.setPage(page);
 
     //MAPPER CREATION
     Mapper *mapper = MapperRegistry::getInstance()->getMapper(vishnu::TMSMAPPERNAME);
@@ -366,6 +373,7 @@ solveGenerique(diet_profile_t* pb) {
     std::string cmd = mapper->finalize(mapperkey);
 
     list = query.list(options);
+    page.project(list);
 
     ::ecorecpp::serializer::serializer _ser;
     listSerialized =  _ser.serialize_str(list);
@@ -373,12 +381,15 @@ solveGenerique(diet_profile_t* pb) {
     //OUT Parameter
     diet_string_set(pb,0, "success");
     diet_string_set(pb,1, listSerialized);
+    diet_string_set(pb,2, query.getNextToken());
 
-    FINISH_COMMAND(authKey, cmd, vishnu::TMS, vishnu::CMDSUCCESS, "");
+    SessionServer sessionServer(authKey);
+    sessionServer.finishQuery(cmd, vishnu::TMS, vishnu::CMDSUCCESS);
 
   } catch (VishnuException& ex) {
     try {
-      FINISH_COMMAND(authKey, "", vishnu::TMS, vishnu::CMDFAILED, "");
+      SessionServer sessionServer(authKey);
+      sessionServer.finishQuery("", vishnu::TMS, vishnu::CMDFAILED);
     } catch (VishnuException& fe) {
       ex.appendMsgComp(fe.what());
     }
@@ -7,6 +7,7 @@
 
 #include "internalApiUMS.hpp"
 #include <string>
+#include <sstream>
 #include "utilVishnu.hpp"
 #include "utilServer.hpp"
 #include "ServerXMS.hpp"
@@ -853,9 +854,14 @@ solveGenerique(diet_profile_t* pb) {
   // IN Parameters
   diet_string_get(pb, 0, sessionKey);
   diet_string_get(pb, 1, optionValueSerialized);
+  // the page, sent only when the client restricts the listing
+  std::string pageSerialized;
+  if (pb->param_count > 2) {
+    diet_string_get(pb, 2, pageSerialized);
+  }
 
   // reset profile to handle result
-  diet_profile_reset(pb, 2);
+  diet_profile_reset(pb, 3);
 
   SessionServer sessionServer  = SessionServer(sessionKey);
 
@@ -870,6 +876,8 @@ solveGenerique(diet_profile_t* pb) {
     }
 
     QueryType query(sessionServer);
+    QueryPage page = QueryPage::deserialize(pageSerialized);
+    query.setPage(page);
 
     // MAPPER CREATION
     Mapper *mapper = MapperRegistry::getInstance()->getMapper(UMSMAPPERNAME);
@@ -878,6 +886,7 @@ solveGenerique(diet_profile_t* pb) {
     cmd = mapper->finalize(mapperkey);
 
     list = query.list(options);
+    page.project(list);
 
     ::ecorecpp::serializer::serializer _ser;
     listSerialized =  _ser.serialize_str(list);
@@ -885,11 +894,12 @@ solveGenerique(diet_profile_t* pb) {
     // OUT Parameter
     diet_string_set(pb, 0, "success");
     diet_string_set(pb, 1, listSerialized);
+    diet_string_set(pb, 2, query.getNextToken());
     // To save the connection
-    sessionServer.finish(cmd, UMS, vishnu::CMDSUCCESS);
+    sessionServer.finishQuery(cmd, UMS, vishnu::CMDSUCCESS);
   } catch (VishnuException& ex) {
     try {
-      sessionServer.finish(cmd, UMS, vishnu::CMDFAILED);
+      sessionServer.finishQuery(cmd, UMS, vishnu::CMDFAILED);
     } catch (VishnuException& fe) {
       ex.appendMsgComp(fe.what());
     }
@@ -1351,7 +1361,6 @@ solveExport(diet_profile_t* pb){
   std::string sessionKey;
   std::string oldSessionId;
   std::string filename ;
-  std::string content;
   int mapperkey;
   std::string cmd;
   std::string error;
@@ -1377,11 +1386,12 @@ solveExport(diet_profile_t* pb){
     // Creating the process server with the options
     ExportServer* exp = ExportFactory::getExporter(userServer);
 
-    // Exporting and setting the results in content
+    // Exporting the results, written in the response as they are read
+    std::ostringstream content;
     exp->exporte(oldSessionId, content);
 
     // Setting out diet param
-    diet_string_set(pb,3, content.c_str());
+    diet_string_set(pb,3, content.str());
     diet_string_set(pb,4, retErr.c_str());
 
     // Finishing the command as a success
@@ -9,6 +9,7 @@
 #include "CommServer.hpp"
 #include "tmsUtils.hpp"
 #include "Logger.hpp"
+#include "DbFactory.hpp"
 
 
 
@@ -174,6 +175,9 @@ main(int argc, char* argv[], char* envp[]) {
         kill(pid, SIGTERM);
       }
 
+      // exit() does not destroy the server, commit the deferred writes
+      DbFactory factory;
+      factory.closeWriteBehindInstance();
       exit(0);
     } else {
       std::cerr << "There was a problem during services initialization\n";
@@ -0,0 +1,135 @@
+#include "AffinityRouter.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <boost/thread/locks.hpp>
+
+const int AffinityRouter::defaultMaxLoad = 125;  //%RELAX<MISRA_0_1_3> Used in this file
+
+AffinityRouter::AffinityRouter(policy_t policy, int maxLoad)
+  : mpolicy(policy), mmaxLoad(maxLoad), mtotalLoad(0) {
+  // a bound below the average load could never be satisfied
+  if (mmaxLoad < 100) {
+    mmaxLoad = 100;
+  }
+}
+
+bool
+AffinityRouter::parsePolicy(const std::string& name, policy_t& policy) {
+  if (name == "first") {
+    policy = FIRST;
+  } else if (name == "session") {
+    policy = SESSION;
+  } else if (name == "machine") {
+    policy = MACHINE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string
+AffinityRouter::getKey(const diet_profile_t* profile) const {
+  switch (mpolicy) {
+  case MACHINE: {
+    // machine specific services are registered as <service>@<machineid>
+    std::string::size_type pos = profile->name.rfind('@');
+    if (pos != std::string::npos) {
+      return profile->name.substr(pos + 1);
+    }
+  }
+    // Intentional fallthrough, no machine in the service: use the session
+  case SESSION:
+    // authenticated services carry the session key as first parameter
+    if (!profile->params.empty()) {
+      return profile->params[0];
+    }
+    return "";
+  case FIRST:
+    // Intentional fallthrough
+  default:
+    return "";
+  }
+}
+
+boost::uint64_t
+AffinityRouter::score(const std::string& key, const std::string& uri) {
+  // FNV-1a over key and uri, then a splitmix64 finalizer to spread the
+  // scores of uris sharing a long common prefix
+  boost::uint64_t hash = 14695981039346656037ULL;
+  std::string::const_iterator c;
+  for (c = key.begin(); c != key.end(); ++c) {
+    hash ^= static_cast<unsigned char>(*c);
+    hash *= 1099511628211ULL;
+  }
+  hash ^= '#';
+  hash *= 1099511628211ULL;
+  for (c = uri.begin(); c != uri.end(); ++c) {
+    hash ^= static_cast<unsigned char>(*c);
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+std::string
+AffinityRouter::acquire(const std::vector<boost::shared_ptr<Server> >& serv,
+                        const std::string& key) {
+  if (serv.empty()) {
+    return "";
+  }
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::string elected = serv.at(0)->getURI();
+  if (mpolicy != FIRST && !key.empty() && serv.size() > 1) {
+    // ceil(maxLoad% of the average load once this request is accounted)
+    int capacity = ((mtotalLoad + 1) * mmaxLoad + 100 * static_cast<int>(serv.size()) - 1)
+      / (100 * static_cast<int>(serv.size()));
+
+    // walk the replicas by decreasing score, spilling over loaded ones
+    std::vector<std::pair<boost::uint64_t, std::string> > ranked;
+    std::vector<boost::shared_ptr<Server> >::const_iterator it;
+    for (it = serv.begin(); it != serv.end(); ++it) {
+      ranked.push_back(std::make_pair(score(key, (*it)->getURI()), (*it)->getURI()));
+    }
+    std::sort(ranked.rbegin(), ranked.rend());
+
+    elected = ranked.front().second;
+    std::vector<std::pair<boost::uint64_t, std::string> >::const_iterator r;
+    for (r = ranked.begin(); r != ranked.end(); ++r) {
+      std::map<std::string, int>::const_iterator load = mload.find(r->second);
+      if (load == mload.end() || load->second < capacity) {
+        elected = r->second;
+        break;
+      }
+    }
+  }
+
+  ++mload[elected];
+  ++mtotalLoad;
+  return elected;
+}
+
+void
+AffinityRouter::release(const std::string& uri) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, int>::iterator it = mload.find(uri);
+  if (it == mload.end()) {
+    return;
+  }
+  --mtotalLoad;
+  if (--(it->second) <= 0) {
+    mload.erase(it);
+  }
+}
+
+int
+AffinityRouter::getLoad(const std::string& uri) const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, int>::const_iterator it = mload.find(uri);
+  return (it == mload.end()) ? 0 : it->second;
+}
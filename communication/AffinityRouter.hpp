@@ -0,0 +1,161 @@
+/**
+ * \file AffinityRouter.hpp
+ * \brief This file defines the session-affinity routing policy of the dispatcher
+ */
+#ifndef __AFFINITYROUTER__H__
+#define __AFFINITYROUTER__H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Server.hpp"
+#include "DIET_client.h"
+
+/**
+ * \class AffinityRouter
+ * \brief Elects a server by consistently hashing a routing key onto the
+ * replicas offering a service, so that requests of a same session (or
+ * targeting a same machine) always land on the same server while it is
+ * alive. Rendezvous hashing is used: adding or removing a replica only
+ * moves the keys it owned. A replica already holding more than
+ * maxLoad percent of the average in-flight load is skipped in favor of
+ * the next one in the key's preference order.
+ */
+class AffinityRouter : public boost::noncopyable {
+public:
+  /**
+   * \brief The routing key
+   */
+  typedef enum {
+    FIRST,   // no affinity: first registered server
+    SESSION, // hash the session key of the request
+    MACHINE  // hash the machine the service targets
+  } policy_t;
+
+  /**
+   * \brief Default bound on a replica load, in percent of the average load
+   */
+  static const int defaultMaxLoad;
+
+  /**
+   * \brief Constructor
+   * \param policy the routing key
+   * \param maxLoad bound on a replica load, in percent of the average load
+   */
+  AffinityRouter(policy_t policy, int maxLoad = defaultMaxLoad);
+
+  /**
+   * \brief Parse a routing policy name
+   * \param name 'first', 'session' or 'machine'
+   * \param policy OUT, the matching policy
+   * \return false if the name is unknown
+   */
+  static bool
+  parsePolicy(const std::string& name, policy_t& policy);
+
+  /**
+   * \brief Extract the routing key of a request
+   * \param profile the request
+   * \return the key, empty if the request carries none
+   */
+  std::string
+  getKey(const diet_profile_t* profile) const;
+
+  /**
+   * \brief Elect a server and account for the request it will handle
+   * The caller MUST call release() with the returned uri when the request
+   * is over, see AffinityRouter::Guard
+   * \param serv list of eligible servers
+   * \param key the routing key, the first server is elected when empty
+   * \return the uri of the elected server, empty if there is none
+   */
+  std::string
+  acquire(const std::vector<boost::shared_ptr<Server> >& serv,
+          const std::string& key);
+
+  /**
+   * \brief Release a request accounted by acquire()
+   * \param uri the uri of the server
+   */
+  void
+  release(const std::string& uri);
+
+  /**
+   * \brief Get the number of in-flight requests of a server
+   * \param uri the uri of the server
+   * \return the number of requests
+   */
+  int
+  getLoad(const std::string& uri) const;
+
+  /**
+   * \class Guard
+   * \brief Releases an elected server when going out of scope
+   */
+  class Guard : public boost::noncopyable {
+  public:
+    /**
+     * \brief Constructor
+     * \param router the router, may be NULL
+     * \param uri the uri returned by acquire()
+     */
+    Guard(AffinityRouter* router, const std::string& uri)
+      : mrouter(router), muri(uri) {}
+
+    /**
+     * \brief Destructor
+     */
+    ~Guard() {
+      if (mrouter && !muri.empty()) {
+        mrouter->release(muri);
+      }
+    }
+
+  private:
+    /**
+     * \brief The router
+     */
+    AffinityRouter* mrouter;
+    /**
+     * \brief The elected uri
+     */
+    std::string muri;
+  };
+
+private:
+  /**
+   * \brief Score of a server for a key, the highest score wins
+   * \param key the routing key
+   * \param uri the uri of the server
+   * \return the score
+   */
+  static boost::uint64_t
+  score(const std::string& key, const std::string& uri);
+
+  /**
+   * \brief The routing key
+   */
+  policy_t mpolicy;
+  /**
+   * \brief Bound on a replica load, in percent of the average load
+   */
+  int mmaxLoad;
+  /**
+   * \brief In-flight requests per server uri
+   */
+  std::map<std::string, int> mload;
+  /**
+   * \brief Total of in-flight requests
+   */
+  int mtotalLoad;
+  /**
+   * \brief mutex to protect the loads
+   */
+  mutable boost::mutex mmutex;
+};
+
+#endif // __AFFINITYROUTER__H__
@@ -48,10 +48,52 @@ Annuary::add(const std::string& name, const std::string& uri,
   if (it == mservers.end()) {
     mservers.push_back(boost::make_shared<Server>(name, services, uri));
     std::cerr << "[INFO]: added " << name << "@" << uri << "\n";
+  } else if ((*it)->getVersion() != Server::computeVersion(services)) {
+    // full re-registration after a failed renewal: replace the entry
+    *it = boost::make_shared<Server>(name, services, uri);
+    std::cerr << "[INFO]: updated " << name << "@" << uri << "\n";
   }
   return 0;
 }
 
+int
+Annuary::renew(const std::string& name, const std::string& uri,
+               boost::uint64_t version) {
+  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
+  is_server helper(name, uri);
+  std::vector<boost::shared_ptr<Server> >::iterator it =
+    std::find_if(mservers.begin(), mservers.end(), helper);
+  if (it == mservers.end() || (*it)->getVersion() != version) {
+    return 1;
+  }
+  return 0;
+}
+
+int
+Annuary::update(const std::string& name, const std::string& uri,
+                boost::uint64_t baseVersion,
+                const std::vector<std::string>& added,
+                const std::vector<std::string>& removed) {
+  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
+  is_server helper(name, uri);
+  std::vector<boost::shared_ptr<Server> >::iterator it =
+    std::find_if(mservers.begin(), mservers.end(), helper);
+  if (it == mservers.end() || (*it)->getVersion() != baseVersion) {
+    return 1;
+  }
+
+  // copy-on-write: readers of get() may still hold the current entry
+  boost::shared_ptr<Server> server =
+    boost::make_shared<Server>((*it)->getName(), (*it)->getServices(), (*it)->getURI());
+  std::for_each(removed.begin(), removed.end(),
+                boost::bind(&Server::remove, server.get(), _1));
+  std::for_each(added.begin(), added.end(),
+                boost::bind(&Server::add, server.get(), _1));
+  *it = server;
+  std::cerr << "[INFO]: updated " << name << "@" << uri << "\n";
+  return 0;
+}
+
 int
 Annuary::remove(const std::string& name, const std::string& uri) {
   boost::lock_guard<boost::recursive_mutex> lock(mmutex);
@@ -7,6 +7,7 @@
 #define __ANNUARY__H__
 
 #include "Server.hpp"
+#include "AffinityRouter.hpp"
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -44,6 +45,33 @@ public:
   add(const std::string& name, const std::string& uri,
       const std::vector<std::string>& services);
 
+  /**
+   * \brief Renew the registration lease of a server without resending its services
+   * \param name The name of the server (e.g. UMS, TMS, dispatcher)
+   * \param uri The uri the server is running
+   * \param version The version of the service set known by the server
+   * \return 0 if the server is known with the same version, 1 if it must re-register
+   */
+  int
+  renew(const std::string& name, const std::string& uri,
+        boost::uint64_t version);
+
+  /**
+   * \brief Apply a delta to the services of a registered server
+   * \param name The name of the server (e.g. UMS, TMS, dispatcher)
+   * \param uri The uri the server is running
+   * \param baseVersion The version the delta applies to
+   * \param added The services to add
+   * \param removed The services to remove
+   * \return 0 on success, 1 if the server is unknown or its version differs
+   * from baseVersion, in which case it must re-register
+   */
+  int
+  update(const std::string& name, const std::string& uri,
+         boost::uint64_t baseVersion,
+         const std::vector<std::string>& added,
+         const std::vector<std::string>& removed);
+
   /**
    * \brief Remove the server called name listening on port at address of the annuary
    * \param name The name of the server (e.g. UMS, TMS, dispatcher)
@@ -86,6 +114,20 @@ public:
   void
   print();
 
+  /**
+   * \brief Set the routing policy used to elect a server among replicas
+   * \param router the router, NULL to elect the first server
+   */
+  void
+  setRouter(boost::shared_ptr<AffinityRouter> router) { mrouter = router; }
+
+  /**
+   * \brief Get the routing policy used to elect a server among replicas
+   * \return the router, NULL when the first server is elected
+   */
+  boost::shared_ptr<AffinityRouter>
+  getRouter() const { return mrouter; }
+
 private :
   /**
    * \brief Fill the services for a given server name. Function used to easily create services from given names
@@ -102,6 +144,11 @@ private :
    */
   std::vector<boost::shared_ptr<Server> > mservers;
 
+  /**
+   * \brief The routing policy
+   */
+  boost::shared_ptr<AffinityRouter> mrouter;
+
   /**
    * \brief mutex to lock the annuary
    */
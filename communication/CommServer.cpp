@@ -3,6 +3,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include <unistd.h> // for sleep
+#include <algorithm>
+#include <iterator>
 
 #include "Database.hpp"
 #include "DbFactory.hpp"
@@ -74,47 +76,37 @@ registerSeD(const std::string& sedUri,
   return 0;
 }
 
-void
-keepRegistered(const std::string& sedType,
-               const ExecConfiguration& config,
-               const std::string& sedUri,
-               boost::shared_ptr<SeD> server){
-  std::vector<std::string> services = server.get()->getServices();
-  int timeout  = vishnu::DEFAUT_TIMEOUT;
-  config.getConfigValue<int>(vishnu::TIMEOUT, timeout);
-  std::string dispUri;
-  config.getRequiredConfigValue<std::string>(vishnu::DISP_URISUBS, dispUri);
-  boost::shared_ptr<Server> srv = boost::make_shared<Server>(sedType, services, sedUri);
-  std::string requestData = "1" + srv.get()->toString(); /* prefixed with 1 to say registering request */
-
-  std::string response;
-  bool useSsl = false;
-  bool connected(false);
-  while (true){
+namespace {
+  /**
+   * \brief Send a subscription message to the dispatcher
+   * \param config the configuration file
+   * \param dispUri The URI to subscribe to the Dispatcher
+   * \param timeout the request timeout
+   * \param requestData the message, prefixed by its mode
+   * \return the response of the dispatcher, empty on failure
+   */
+  std::string
+  sendToDispatcher(const ExecConfiguration& config,
+                   const std::string& dispUri,
+                   int timeout,
+                   const std::string& requestData) {
+    std::string response;
+    bool useSsl = false;
     if (config.getConfigValue<bool>(vishnu::USE_SSL, useSsl) && useSsl) {
-
-      std::string host;
-      int port;
-      host = vishnu::getHostFromUri(dispUri);
-      port = vishnu::getPortFromUri(dispUri);
+      std::string host = vishnu::getHostFromUri(dispUri);
+      int port = vishnu::getPortFromUri(dispUri);
 
       /* Get TLS trust store if set */
       std::string cafile;
       config.getConfigValue<std::string>(vishnu::SSL_CA, cafile);
-      /* Logging */
       /* Now create a TLS client and go ahead */
       TlsClient tlsClient(host, port, cafile);
-      requestData.append("\n\n");      /* required for the internal protocol */
-      if (tlsClient.send(requestData) == 0) {
+      /* "\n\n" is required for the internal protocol */
+      if (tlsClient.send(requestData + "\n\n") == 0) {
         response = tlsClient.recv();
-        if (response == "OK\n") { // \n at the end because it's in response see sslhelpers.cpp, \n is added at end of message
-          if (!connected) {
-            LOG("[INFO] Registered in dispatcher", LogInfo);
-          }
-          connected = true;
-        } else {
-          connected = false;
-          LOG("[WARN] Not registered in dispatcher", LogInfo);
+        // \n is added at the end of the message, see sslhelpers.cpp
+        if (!response.empty() && response[response.size() - 1] == '\n') {
+          response.erase(response.size() - 1);
         }
       }
     } else {
@@ -122,15 +114,81 @@ keepRegistered(const std::string& sedType,
       LazyPirateClient lpc(ctx, dispUri, timeout);
       lpc.send(requestData);
       response = lpc.recv();
-      if (response == "OK") {
-        if (!connected) {
-          LOG("[INFO] Registered in dispatcher", LogInfo);
-        }
-        connected = true;
-      } else {
-        connected = false;
-        LOG("[WARN] Not registered in dispatcher", LogInfo);
+    }
+    return response;
+  }
+
+  /**
+   * \brief Compute the services to add and remove to go from one set to another
+   * \param from the registered services
+   * \param to the current services
+   * \param added OUT, the services in to but not in from
+   * \param removed OUT, the services in from but not in to
+   */
+  void
+  servicesDelta(std::vector<std::string> from,
+                std::vector<std::string> to,
+                std::vector<std::string>& added,
+                std::vector<std::string>& removed) {
+    std::sort(from.begin(), from.end());
+    std::sort(to.begin(), to.end());
+    std::set_difference(to.begin(), to.end(), from.begin(), from.end(),
+                        std::back_inserter(added));
+    std::set_difference(from.begin(), from.end(), to.begin(), to.end(),
+                        std::back_inserter(removed));
+  }
+}
+
+void
+keepRegistered(const std::string& sedType,
+               const ExecConfiguration& config,
+               const std::string& sedUri,
+               boost::shared_ptr<SeD> server){
+  int timeout  = vishnu::DEFAUT_TIMEOUT;
+  config.getConfigValue<int>(vishnu::TIMEOUT, timeout);
+  std::string dispUri;
+  config.getRequiredConfigValue<std::string>(vishnu::DISP_URISUBS, dispUri);
+
+  // services acknowledged by the dispatcher
+  std::vector<std::string> registered;
+  bool connected(false);
+  // dispatchers predating modes 4 and 5 answer "OK" to them as a no-op
+  bool legacyDispatcher(false);
+  while (true){
+    std::vector<std::string> services = server.get()->getServices();
+    std::string requestData;
+    if (!connected || legacyDispatcher) {
+      /* prefixed with 1 to say registering request */
+      Server srv(sedType, services, sedUri);
+      requestData = "1" + srv.toString();
+    } else {
+      /* prefixed with 4 for a lease renewal, 5 for a delta */
+      std::vector<std::string> added;
+      std::vector<std::string> removed;
+      servicesDelta(registered, services, added, removed);
+      requestData = (added.empty() && removed.empty()) ? "4" : "5";
+      requestData += Server::deltaToString(sedType, sedUri,
+                                           Server::computeVersion(registered),
+                                           added, removed);
+    }
+
+    std::string response = sendToDispatcher(config, dispUri, timeout, requestData);
+    if (response == "OK" || response == "ACK") {
+      if (!connected) {
+        LOG("[INFO] Registered in dispatcher", LogInfo);
       }
+      if (response == "OK" && requestData[0] != '1') {
+        legacyDispatcher = true;
+      }
+      connected = true;
+      registered = services;
+    } else if (response == "RESYNC") {
+      // the dispatcher lost or diverged from our entry: register again now
+      connected = false;
+      continue;
+    } else {
+      connected = false;
+      LOG("[WARN] Not registered in dispatcher", LogInfo);
     }
     sleep(timeout);
   }
@@ -18,12 +18,14 @@ typedef std::vector<std::string> Services;
 Server::Server(const std::string& name, const std::vector<std::string> &serv,
                const std::string& uri) :
     mname(name), mservices(serv), muri(uri) {
+  mversion = computeVersion(mservices);
 }
 
 Server::Server(Server& serv){
   mname = serv.getName();
   mservices = serv.getServices();
   muri = serv.getURI();
+  mversion = serv.getVersion();
 }
 
 Server::~Server(){
@@ -37,6 +39,7 @@ Server::add(const std::string& service) {
 
   if (it == mservices.end()) {
     mservices.push_back(service);
+    mversion = computeVersion(mservices);
   }
 
   return 0;
@@ -48,7 +51,10 @@ Server::remove(const std::string& service) {
   Services::iterator it =
     std::remove(mservices.begin(), mservices.end(), service);
 
-  mservices.erase(it, mservices.end());
+  if (it != mservices.end()) {
+    mservices.erase(it, mservices.end());
+    mversion = computeVersion(mservices);
+  }
 
   return 0;
 }
@@ -77,6 +83,33 @@ Server::getServices() {
   return mservices;
 }
 
+boost::uint64_t
+Server::getVersion() const {
+  return mversion;
+}
+
+// FNV-1a over the sorted services: stable across processes and builds,
+// unlike boost::hash
+boost::uint64_t
+Server::computeVersion(const std::vector<std::string>& services) {
+  Services sorted(services);
+  std::sort(sorted.begin(), sorted.end());
+
+  boost::uint64_t hash = 14695981039346656037ULL;
+  Services::const_iterator it;
+  for (it = sorted.begin(); it != sorted.end(); ++it) {
+    std::string::const_iterator c;
+    for (c = it->begin(); c != it->end(); ++c) {
+      hash ^= static_cast<unsigned char>(*c);
+      hash *= 1099511628211ULL;
+    }
+    // separator so that {"ab"} and {"a", "b"} differ
+    hash ^= '\n';
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 
 std::string
 Server::toString() {
@@ -116,3 +149,57 @@ Server::fromString(const std::string& prof) {
   }
   return res;
 }
+
+std::string
+Server::deltaToString(const std::string& name, const std::string& uri,
+                      boost::uint64_t baseVersion,
+                      const std::vector<std::string>& added,
+                      const std::vector<std::string>& removed) {
+  std::stringstream res;
+  res << name << "$$$"
+      << uri << "$$$"
+      << baseVersion << "$$$";
+  Services::const_iterator it;
+  for (it = added.begin(); it != added.end(); ++it) {
+    res << "+" << *it << "$$$";
+  }
+  for (it = removed.begin(); it != removed.end(); ++it) {
+    res << "-" << *it << "$$$";
+  }
+  return res.str();
+}
+
+bool
+Server::deltaFromString(const std::string& prof, std::string& name,
+                        std::string& uri, boost::uint64_t& baseVersion,
+                        std::vector<std::string>& added,
+                        std::vector<std::string>& removed) {
+  using boost::algorithm::split_regex;
+
+  std::vector<std::string> vecString;
+  split_regex(vecString, prof, boost::regex("\\${3}"));
+  if (vecString.size() < 3) {
+    return false;
+  }
+
+  Services::iterator it = vecString.begin();
+  name = *(it++);
+  uri = *(it++);
+  try {
+    baseVersion = boost::lexical_cast<boost::uint64_t>(*(it++));
+  } catch (const boost::bad_lexical_cast&) {
+    return false;
+  }
+
+  for (; it != vecString.end(); ++it) {
+    if (it->size() < 2) {
+      continue;
+    }
+    if ((*it)[0] == '+') {
+      added.push_back(it->substr(1));
+    } else if ((*it)[0] == '-') {
+      removed.push_back(it->substr(1));
+    }
+  }
+  return true;
+}
@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 
 /**
  * \class Server
@@ -25,6 +26,47 @@ public:
   static boost::shared_ptr<Server>
   fromString(const std::string& prof);
 
+  /**
+   * \brief Compute the registration version of a set of services
+   * The version only depends on the content of the set, not on its order,
+   * so that the dispatcher and the server can compute it independently
+   * \param services The services offered by a server
+   * \return The version of the service set
+   */
+  static boost::uint64_t
+  computeVersion(const std::vector<std::string>& services);
+
+  /**
+   * \brief Serialize a registration delta (a lease renewal when both lists are empty)
+   * \param name The name of the server
+   * \param uri The uri the server is running
+   * \param baseVersion The version the delta applies to
+   * \param added The services to add
+   * \param removed The services to remove
+   * \return The serialized delta
+   */
+  static std::string
+  deltaToString(const std::string& name, const std::string& uri,
+                boost::uint64_t baseVersion,
+                const std::vector<std::string>& added,
+                const std::vector<std::string>& removed);
+
+  /**
+   * \brief Deserialize a registration delta
+   * \param prof The serialized delta
+   * \param name OUT, the name of the server
+   * \param uri OUT, the uri the server is running
+   * \param baseVersion OUT, the version the delta applies to
+   * \param added OUT, the services to add
+   * \param removed OUT, the services to remove
+   * \return false if the delta is malformed
+   */
+  static bool
+  deltaFromString(const std::string& prof, std::string& name,
+                  std::string& uri, boost::uint64_t& baseVersion,
+                  std::vector<std::string>& added,
+                  std::vector<std::string>& removed);
+
   /**
    * \brief Constructor
    * \param name The name of the server
@@ -86,6 +128,13 @@ public:
   std::string
   getURI() const;
 
+  /**
+   * \brief Getter for the registration version
+   * \return The version of the current service set
+   */
+  boost::uint64_t
+  getVersion() const;
+
   /**
    * \brief DEPRECATED Serializer for the server object
    * \return The serialized server
@@ -106,6 +155,10 @@ private:
    * \brief The uri the server is running over
    */
   std::string muri;
+  /**
+   * \brief The registration version, derived from the services
+   */
+  boost::uint64_t mversion;
 };
 
 #endif // __SERVER__H__
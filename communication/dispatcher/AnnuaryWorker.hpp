@@ -93,9 +93,16 @@ private:
     boost::shared_ptr<diet_profile_t> profile = my_deserialize(data);
     std::string servname = profile->name;
     std::vector<boost::shared_ptr<Server> > serv = mann_->get(servname);
-    std::string uriServer = elect(serv);
+    boost::shared_ptr<AffinityRouter> router = mann_->getRouter();
+    std::string uriServer;
+    if (router) {
+      uriServer = router->acquire(serv, router->getKey(profile.get()));
+    } else {
+      uriServer = elect(serv);
+    }
 
     if (!uriServer.empty()) {
+      AffinityRouter::Guard guard(router.get(), uriServer);
       abstract_call_gen(profile.get(), uriServer);
       return my_serialize(profile.get());
     } else {
@@ -182,6 +189,10 @@ private:
     case 3:
       result = boost::str(boost::format("%1%") % VISHNU_VERSION);
       break;
+    case 4:  // lease renewal
+    case 5:  // services delta
+      result = updateServer(data);
+      break;
     default:  // NOOP
       std::cerr << "[ERROR]: unrecognized command\n";
     }
@@ -201,6 +212,34 @@ private:
     mann_->add(server->getName(), server->getURI(),  services);
   }
 
+  /**
+   * \brief Renew a registration or apply a delta to its services
+   * \param data the serialized delta, prefixed by its mode
+   * \return "ACK" on success, "RESYNC" if the server must send a full
+   * registration (mode 1) because the dispatcher does not know its version
+   */
+  std::string
+  updateServer(const std::string& data) {
+    std::string name;
+    std::string uri;
+    boost::uint64_t baseVersion;
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    if (!Server::deltaFromString(data.substr(1), name, uri, baseVersion,
+                                 added, removed)) {
+      std::cerr << "[ERROR]: malformed registration delta\n";
+      return "RESYNC";
+    }
+
+    int rv;
+    if (added.empty() && removed.empty()) {
+      rv = mann_->renew(name, uri, baseVersion);
+    } else {
+      rv = mann_->update(name, uri, baseVersion, added, removed);
+    }
+    return rv ? "RESYNC" : "ACK";
+  }
+
   std::string
   listServer(const std::string& data) {
     std::vector<boost::shared_ptr<Server> > list = mann_->get();
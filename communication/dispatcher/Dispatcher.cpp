@@ -59,6 +59,20 @@ Dispatcher::configureAnnuary() {
     ann->setInitConfig("umssed", cfgInfo, mid);
     cfgInfo.clear();
   }
+
+  std::string policyName;
+  if (config.getConfigValue<std::string>(vishnu::DISP_ROUTING_POLICY, policyName)) {
+    AffinityRouter::policy_t policy;
+    if (!AffinityRouter::parsePolicy(policyName, policy)) {
+      throw UserException(ERRCODE_INVALID_PARAM,
+                          "Invalid routing policy (must be 'first', 'session' or 'machine')");
+    }
+    int maxLoad = AffinityRouter::defaultMaxLoad;
+    config.getConfigValue<int>(vishnu::DISP_ROUTING_MAXLOAD, maxLoad);
+    ann->setRouter(boost::make_shared<AffinityRouter>(policy, maxLoad));
+    LOG(boost::str(boost::format("[INFO] Routing policy: %1% (max load %2%%%)")
+                   % policyName % maxLoad), LogInfo);
+  }
   ann->print();
 }
 
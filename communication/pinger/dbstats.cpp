@@ -0,0 +1,23 @@
+#include "DIET_client.h"
+
+int
+main(int argc, char** argv){
+  diet_profile_t* profile = NULL;
+  std::string msg;
+
+  if (argc<3 ||
+      strcmp(argv[1],"-h") ==0){
+    std::cout << "usage : " << argv[0] << " <confFile> <mid> " << std::endl;
+    exit(-1);
+  }
+  std::string mid(argv[2]);
+  profile = diet_profile_alloc(std::string("dbstatsxmssed@")+mid, 0);
+  diet_initialize(argv[1], 0, NULL);
+  if(diet_call(profile)){
+    std::cout << "\nFailed to get the database statistics " << std::endl;
+    exit(-1);
+  }
+  diet_string_get(profile, profile->param_count-1, msg);
+  std::cout << msg;
+  return 0;
+}
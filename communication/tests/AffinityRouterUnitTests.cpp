@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include "AffinityRouter.hpp"
+
+class AffinityRouterFixture {
+public:
+  AffinityRouterFixture(){
+    std::vector<std::string> services;
+    services.push_back("loup");
+    replicas.push_back(boost::make_shared<Server>("xmssed", services, "tcp://10.0.0.1:5555"));
+    replicas.push_back(boost::make_shared<Server>("xmssed", services, "tcp://10.0.0.2:5555"));
+    replicas.push_back(boost::make_shared<Server>("xmssed", services, "tcp://10.0.0.3:5555"));
+  }
+
+  std::vector<boost::shared_ptr<Server> > replicas;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( affinity_router_unit_tests, AffinityRouterFixture )
+
+
+BOOST_AUTO_TEST_CASE( test_parsePolicy_n )
+{
+  AffinityRouter::policy_t policy;
+  BOOST_REQUIRE(AffinityRouter::parsePolicy("session", policy));
+  BOOST_REQUIRE_EQUAL(policy, AffinityRouter::SESSION);
+  BOOST_REQUIRE(AffinityRouter::parsePolicy("machine", policy));
+  BOOST_REQUIRE_EQUAL(policy, AffinityRouter::MACHINE);
+  BOOST_REQUIRE(!AffinityRouter::parsePolicy("lapin", policy));
+}
+
+BOOST_AUTO_TEST_CASE( test_getKey_n )
+{
+  diet_profile_t profile;
+  profile.name = "jobSubmit@cluster1";
+  profile.params.push_back("sessionkey");
+
+  AffinityRouter bySession(AffinityRouter::SESSION);
+  AffinityRouter byMachine(AffinityRouter::MACHINE);
+  AffinityRouter first(AffinityRouter::FIRST);
+  BOOST_REQUIRE_EQUAL(bySession.getKey(&profile), "sessionkey");
+  BOOST_REQUIRE_EQUAL(byMachine.getKey(&profile), "cluster1");
+  BOOST_REQUIRE_EQUAL(first.getKey(&profile), "");
+
+  profile.name = "sessionClose";
+  BOOST_REQUIRE_EQUAL(byMachine.getKey(&profile), "sessionkey");
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_sticky_n )
+{
+  AffinityRouter router(AffinityRouter::SESSION);
+  std::string uri = router.acquire(replicas, "sessionkey");
+  router.release(uri);
+  for (int i = 0; i < 10; ++i) {
+    std::string other = router.acquire(replicas, "sessionkey");
+    router.release(other);
+    BOOST_REQUIRE_EQUAL(uri, other);
+  }
+  BOOST_REQUIRE_EQUAL(router.getLoad(uri), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_consistent_n )
+{
+  AffinityRouter router(AffinityRouter::SESSION);
+  std::string uri = router.acquire(replicas, "sessionkey");
+  router.release(uri);
+
+  // removing another replica does not move the key
+  std::vector<boost::shared_ptr<Server> > fewer;
+  for (unsigned int i = 0; i < replicas.size(); ++i) {
+    if (replicas[i]->getURI() == uri || fewer.empty()) {
+      fewer.push_back(replicas[i]);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(router.acquire(fewer, "sessionkey"), uri);
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_spillover_n )
+{
+  AffinityRouter router(AffinityRouter::SESSION, 100);
+  // without releases, the same key must spread over all replicas
+  std::string first = router.acquire(replicas, "sessionkey");
+  std::string second = router.acquire(replicas, "sessionkey");
+  std::string third = router.acquire(replicas, "sessionkey");
+  BOOST_REQUIRE(first != second);
+  BOOST_REQUIRE(second != third);
+  BOOST_REQUIRE(first != third);
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_empty_bad )
+{
+  AffinityRouter router(AffinityRouter::SESSION);
+  std::vector<boost::shared_ptr<Server> > none;
+  BOOST_REQUIRE(router.acquire(none, "sessionkey").empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -120,6 +120,82 @@ BOOST_AUTO_TEST_CASE( test_remove_bad_empty )
   BOOST_REQUIRE(ann.get().empty());
 }
 
+BOOST_AUTO_TEST_CASE( test_renew_n )
+{
+  Annuary ann(mservers);
+  BOOST_REQUIRE_EQUAL(ann.renew(name, uri, Server::computeVersion(services)), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_renew_bad_version )
+{
+  Annuary ann(mservers);
+  std::vector<std::string> servicesTmp(services);
+  servicesTmp.push_back("toto");
+  BOOST_REQUIRE_EQUAL(ann.renew(name, uri, Server::computeVersion(servicesTmp)), 1);
+  BOOST_REQUIRE_EQUAL(ann.renew(name+"1", uri, Server::computeVersion(services)), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_update_n )
+{
+  Annuary ann(mservers);
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  added.push_back("toto");
+  removed.push_back("loup");
+  BOOST_REQUIRE_EQUAL(ann.update(name, uri, Server::computeVersion(services),
+                                 added, removed), 0);
+  BOOST_REQUIRE(ann.get("loup").empty());
+  BOOST_REQUIRE_EQUAL(ann.get("toto").size(), 1);
+
+  std::vector<std::string> servicesTmp;
+  servicesTmp.push_back("toto");
+  servicesTmp.push_back("belette");
+  BOOST_REQUIRE_EQUAL(ann.renew(name, uri, Server::computeVersion(servicesTmp)), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_update_bad_version )
+{
+  Annuary ann(mservers);
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  added.push_back("toto");
+  BOOST_REQUIRE_EQUAL(ann.update(name, uri, 0, added, removed), 1);
+  BOOST_REQUIRE(ann.get("toto").empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_add_refresh_n )
+{
+  Annuary ann(mservers);
+  std::vector<std::string> servicesTmp;
+  servicesTmp.push_back("toto");
+  ann.add(name, uri, servicesTmp);
+  BOOST_REQUIRE_EQUAL(ann.get().size(), 1);
+  BOOST_REQUIRE(ann.get("loup").empty());
+  BOOST_REQUIRE_EQUAL(ann.get("toto").size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_delta_serialization_n )
+{
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  added.push_back("toto");
+  removed.push_back("loup");
+  std::string msg = Server::deltaToString(name, uri, 42, added, removed);
+
+  std::string nameTmp;
+  std::string uriTmp;
+  boost::uint64_t version;
+  std::vector<std::string> addedTmp;
+  std::vector<std::string> removedTmp;
+  BOOST_REQUIRE(Server::deltaFromString(msg, nameTmp, uriTmp, version,
+                                        addedTmp, removedTmp));
+  BOOST_REQUIRE_EQUAL(nameTmp, name);
+  BOOST_REQUIRE_EQUAL(uriTmp, uri);
+  BOOST_REQUIRE_EQUAL(version, 42);
+  BOOST_REQUIRE(addedTmp == added);
+  BOOST_REQUIRE(removedTmp == removed);
+}
+
 BOOST_AUTO_TEST_CASE( test_setInitConfig_TMS_n )
 {
   Annuary ann;
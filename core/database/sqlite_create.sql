@@ -0,0 +1,528 @@
+-- This script is for initialization of the VISHNU SQLite database
+-- Script name          : sqlite_create.sql
+-- Script owner         : SysFera SA
+
+-- Usage                : sqlite3 <databaseName> < sqlite_create.sql
+-- The tables are those of postgre_create.sql, the identifiers generated by
+-- a sequence are INTEGER PRIMARY KEY AUTOINCREMENT (never reused), the
+-- constraints are declared in the tables as SQLite cannot add them later.
+
+-- WAL is kept in the database file, the servers also set it at connection
+PRAGMA journal_mode=WAL;
+PRAGMA foreign_keys=ON;
+
+BEGIN TRANSACTION;
+
+CREATE TABLE account (
+    numaccountid INTEGER PRIMARY KEY AUTOINCREMENT,
+    aclogin VARCHAR(255),
+    home VARCHAR(255),
+    machine_nummachineid BIGINT NOT NULL,
+    sshpathkey VARCHAR(255),
+    users_numuserid BIGINT NOT NULL,
+    status INTEGER,
+    CONSTRAINT fkb9d38a2d1cfedefc FOREIGN KEY (machine_nummachineid) REFERENCES machine (nummachineid) ON DELETE CASCADE,
+    CONSTRAINT fkb9d38a2da63719f2 FOREIGN KEY (users_numuserid) REFERENCES users (numuserid) ON DELETE CASCADE
+);
+
+CREATE TABLE acl_class (
+    id INTEGER PRIMARY KEY,
+    class VARCHAR(255) NOT NULL
+);
+
+CREATE TABLE acl_entry (
+    id INTEGER PRIMARY KEY,
+    ace_order INTEGER NOT NULL,
+    acl_object_identity BIGINT NOT NULL,
+    audit_failure BOOLEAN NOT NULL,
+    audit_success BOOLEAN NOT NULL,
+    granting BOOLEAN NOT NULL,
+    mask INTEGER NOT NULL,
+    sid BIGINT NOT NULL,
+    CONSTRAINT acl_entry_acl_object_identity_ace_order_key UNIQUE (acl_object_identity, ace_order),
+    CONSTRAINT fk5302d47d8fdb88d5 FOREIGN KEY (sid) REFERENCES acl_sid (id),
+    CONSTRAINT fk5302d47db0d9dc4d FOREIGN KEY (acl_object_identity) REFERENCES acl_object_identity (id)
+);
+
+CREATE TABLE acl_object_identity (
+    id INTEGER PRIMARY KEY,
+    object_id_class BIGINT NOT NULL,
+    entries_inheriting BOOLEAN NOT NULL,
+    object_id_identity BIGINT NOT NULL,
+    owner_sid BIGINT,
+    parent_object BIGINT,
+    CONSTRAINT acl_object_identity_object_id_class_object_id_identity_key UNIQUE (object_id_class, object_id_identity),
+    CONSTRAINT fk2a2bb00970422cc5 FOREIGN KEY (object_id_class) REFERENCES acl_class (id),
+    CONSTRAINT fk2a2bb00990ec1949 FOREIGN KEY (owner_sid) REFERENCES acl_sid (id),
+    CONSTRAINT fk2a2bb009a50290b8 FOREIGN KEY (parent_object) REFERENCES acl_object_identity (id)
+);
+
+CREATE TABLE acl_sid (
+    id INTEGER PRIMARY KEY,
+    principal BOOLEAN NOT NULL,
+    sid VARCHAR(255) NOT NULL,
+    CONSTRAINT acl_sid_sid_principal_key UNIQUE (sid, principal)
+);
+
+CREATE TABLE application (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    deleted BOOLEAN NOT NULL,
+    description TEXT,
+    identifier VARCHAR(255) NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    class VARCHAR(255) NOT NULL,
+    author_id BIGINT,
+    project_id BIGINT,
+    CONSTRAINT application_identifier_key UNIQUE (identifier),
+    CONSTRAINT fk5ca40550bd4995a3 FOREIGN KEY (project_id) REFERENCES project (id),
+    CONSTRAINT fk5ca40550e1f3ba8c FOREIGN KEY (author_id) REFERENCES users (numuserid)
+);
+
+CREATE TABLE application_parameter (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    application_id BIGINT NOT NULL,
+    default_value VARCHAR(255),
+    description TEXT,
+    editable BOOLEAN NOT NULL,
+    format VARCHAR(255) NOT NULL,
+    hidden BOOLEAN NOT NULL,
+    label VARCHAR(255) NOT NULL,
+    max_len BIGINT NOT NULL,
+    min_len BIGINT NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    optionnal BOOLEAN NOT NULL,
+    pos BIGINT NOT NULL,
+    possible_values VARCHAR(255),
+    regex VARCHAR(255),
+    type VARCHAR(255) NOT NULL,
+    CONSTRAINT fkfa594f7a3462ea58 FOREIGN KEY (application_id) REFERENCES application_version (id)
+);
+
+CREATE TABLE application_version (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    application_id BIGINT NOT NULL,
+    date_created TIMESTAMP NOT NULL,
+    last_updated TIMESTAMP NOT NULL,
+    pre_script VARCHAR(255),
+    pre_script_path VARCHAR(255),
+    script VARCHAR(255) NOT NULL,
+    script_path VARCHAR(255) NOT NULL,
+    validation_script VARCHAR(255),
+    validation_script_path VARCHAR(255),
+    CONSTRAINT fkc5b678e99fcaff4 FOREIGN KEY (application_id) REFERENCES application (id)
+);
+
+CREATE TABLE authaccount (
+    authaccountid INTEGER PRIMARY KEY AUTOINCREMENT,
+    aclogin VARCHAR(255),
+    authsystem_authsystemid BIGINT NOT NULL,
+    users_numuserid BIGINT NOT NULL,
+    status INTEGER,
+    CONSTRAINT fk2c887f85a63719f2 FOREIGN KEY (users_numuserid) REFERENCES users (numuserid) ON DELETE CASCADE,
+    CONSTRAINT fk2c887f85fc5a9563 FOREIGN KEY (authsystem_authsystemid) REFERENCES authsystem (numauthsystemid) ON DELETE CASCADE
+);
+
+CREATE TABLE authsystem (
+    numauthsystemid INTEGER PRIMARY KEY AUTOINCREMENT,
+    authlogin VARCHAR(255),
+    authpassword VARCHAR(255),
+    authsystemid VARCHAR(255),
+    authtype INTEGER,
+    name VARCHAR(255),
+    status INTEGER,
+    uri VARCHAR(255),
+    userpwdencryption INTEGER,
+    vishnu_vishnuid BIGINT NOT NULL,
+    CONSTRAINT fkadc771d7c2584ca8 FOREIGN KEY (vishnu_vishnuid) REFERENCES vishnu (vishnuid)
+);
+
+CREATE TABLE clmachine (
+    numclmachineid INTEGER PRIMARY KEY AUTOINCREMENT,
+    name VARCHAR(255),
+    sshkey VARCHAR(255)
+);
+
+CREATE TABLE command (
+    numcommandid INTEGER PRIMARY KEY AUTOINCREMENT,
+    ctype INTEGER,
+    description TEXT,
+    endtime TIMESTAMP,
+    starttime TIMESTAMP,
+    status INTEGER,
+    vishnuobjectid VARCHAR(255),
+    vsession_numsessionid BIGINT NOT NULL,
+    CONSTRAINT fk38a5df4bf58538bc FOREIGN KEY (vsession_numsessionid) REFERENCES vsession (numsessionid) ON DELETE CASCADE
+);
+
+CREATE TABLE description (
+    numdescriptionid INTEGER PRIMARY KEY AUTOINCREMENT,
+    description TEXT,
+    lang VARCHAR(255),
+    machine_nummachineid BIGINT NOT NULL,
+    CONSTRAINT fk993583fc1cfedefc FOREIGN KEY (machine_nummachineid) REFERENCES machine (nummachineid) ON DELETE CASCADE
+);
+
+CREATE TABLE filetransfer (
+    numfiletransferid INTEGER PRIMARY KEY AUTOINCREMENT,
+    clientmachineid VARCHAR(255),
+    destinationfilepath VARCHAR(255),
+    destinationmachineid VARCHAR(255),
+    errormsg TEXT,
+    filesize INTEGER,
+    processid INTEGER,
+    sourcefilepath VARCHAR(255),
+    sourcemachineid VARCHAR(255),
+    starttime TIMESTAMP,
+    status INTEGER,
+    transferid VARCHAR(255),
+    trcommand INTEGER,
+    userid VARCHAR(255),
+    vsession_numsessionid BIGINT NOT NULL,
+    CONSTRAINT fkfce97167f58538bc FOREIGN KEY (vsession_numsessionid) REFERENCES vsession (numsessionid) ON DELETE CASCADE
+);
+
+CREATE TABLE global_project_role (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    description TEXT,
+    is_built_in BOOLEAN NOT NULL,
+    is_default BOOLEAN NOT NULL,
+    label VARCHAR(255) NOT NULL,
+    member_specific BOOLEAN NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    pos BIGINT NOT NULL
+);
+
+CREATE TABLE global_project_role_permissions (
+    global_project_role_id BIGINT,
+    permissions_string VARCHAR(255),
+    CONSTRAINT fk74e3bbd8d89fc97 FOREIGN KEY (global_project_role_id) REFERENCES global_project_role (id)
+);
+
+CREATE TABLE job (
+    numjobid INTEGER PRIMARY KEY AUTOINCREMENT,
+    batchjobid VARCHAR(255),
+    batchtype INTEGER,
+    enddate TIMESTAMP,
+    errorpath VARCHAR(255),
+    groupname VARCHAR(255),
+    job_owner_id BIGINT,
+    jobdescription TEXT,
+    jobid VARCHAR(255),
+    jobname VARCHAR(255),
+    jobpath VARCHAR(255),
+    jobprio INTEGER,
+    jobqueue VARCHAR(255),
+    jobworkingdir VARCHAR(255),
+    machine_id BIGINT,
+    memlimit INTEGER,
+    nbcpus INTEGER,
+    nbnodes INTEGER,
+    nbnodesandcpupernode VARCHAR(255),
+    outputdir VARCHAR(255),
+    outputpath VARCHAR(255),
+    owner VARCHAR(255),
+    scriptcontent TEXT,
+    status INTEGER,
+    submitdate TIMESTAMP,
+    submitmachineid VARCHAR(255),
+    submitmachinename VARCHAR(255),
+    vsession_numsessionid BIGINT NOT NULL,
+    wallclocklimit INTEGER,
+    workid BIGINT,
+    vmId VARCHAR(255),
+    vmIp VARCHAR(255),
+    relatedSteps VARCHAR(255),
+    CONSTRAINT fk19bbd355bf2a6 FOREIGN KEY (job_owner_id) REFERENCES users (numuserid),
+    CONSTRAINT fk19bbd9207fb3b FOREIGN KEY (machine_id) REFERENCES machine (nummachineid),
+    CONSTRAINT fk19bbdf381dc90 FOREIGN KEY (workid) REFERENCES work (id),
+    CONSTRAINT fk19bbdf58538bc FOREIGN KEY (vsession_numsessionid) REFERENCES vsession (numsessionid) ON DELETE CASCADE
+);
+
+CREATE TABLE ldapauthsystem (
+    ldapauthsystid INTEGER PRIMARY KEY AUTOINCREMENT,
+    authsystem_authsystemid BIGINT NOT NULL,
+    ldapbase VARCHAR(255),
+    CONSTRAINT fk30e4e8befc5a9563 FOREIGN KEY (authsystem_authsystemid) REFERENCES authsystem (numauthsystemid) ON DELETE CASCADE
+);
+
+CREATE TABLE machine (
+    nummachineid INTEGER PRIMARY KEY AUTOINCREMENT,
+    diskspace INTEGER,
+    machineid VARCHAR(255),
+    memory INTEGER,
+    name VARCHAR(255),
+    network INTEGER,
+    site VARCHAR(255),
+    sshpublickey TEXT,
+    status INTEGER,
+    vishnu_vishnuid BIGINT NOT NULL,
+    CONSTRAINT fk31314447c2584ca8 FOREIGN KEY (vishnu_vishnuid) REFERENCES vishnu (vishnuid)
+);
+
+CREATE TABLE notification (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    clazz VARCHAR(255) NOT NULL,
+    content VARCHAR(255) NOT NULL,
+    date_created TIMESTAMP NOT NULL,
+    link_to VARCHAR(255) NOT NULL,
+    notifier_id BIGINT,
+    object_id INTEGER NOT NULL,
+    project_id BIGINT NOT NULL,
+    type VARCHAR(255) NOT NULL,
+    CONSTRAINT fk237a88eb7276891 FOREIGN KEY (notifier_id) REFERENCES users (numuserid),
+    CONSTRAINT fk237a88ebbd4995a3 FOREIGN KEY (project_id) REFERENCES project (id)
+);
+
+CREATE TABLE optionu (
+    numoptionid INTEGER PRIMARY KEY AUTOINCREMENT,
+    defaultvalue INTEGER,
+    description TEXT,
+    optionid INTEGER
+);
+
+CREATE TABLE optionvalue (
+    numoptionvalueid INTEGER PRIMARY KEY AUTOINCREMENT,
+    optionu_numoptionid BIGINT NOT NULL,
+    users_numuserid BIGINT NOT NULL,
+    value INTEGER,
+    CONSTRAINT fkebde0a1ca63719f2 FOREIGN KEY (users_numuserid) REFERENCES users (numuserid) ON DELETE CASCADE,
+    CONSTRAINT fkebde0a1cbe23b1a5 FOREIGN KEY (optionu_numoptionid) REFERENCES optionu (numoptionid)
+);
+
+CREATE TABLE parameter_value (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    parent_id BIGINT NOT NULL,
+    type_id BIGINT NOT NULL,
+    value VARCHAR(255) NOT NULL,
+    CONSTRAINT fk2e32855b3ccf497f FOREIGN KEY (type_id) REFERENCES application_parameter (id),
+    CONSTRAINT fk2e32855b9d863974 FOREIGN KEY (parent_id) REFERENCES work (id)
+);
+
+CREATE TABLE permission (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    label VARCHAR(255) NOT NULL,
+    member_required BOOLEAN NOT NULL,
+    module_id BIGINT NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    pos BIGINT NOT NULL,
+    project_required BOOLEAN NOT NULL,
+    CONSTRAINT permission_name_key UNIQUE (name),
+    CONSTRAINT fke125c5cf6e594880 FOREIGN KEY (module_id) REFERENCES permission_module (id)
+);
+
+CREATE TABLE permission_module (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    pos BIGINT NOT NULL,
+    CONSTRAINT permission_module_name_key UNIQUE (name)
+);
+
+CREATE TABLE process (
+    numprocess INTEGER PRIMARY KEY AUTOINCREMENT,
+    dietname VARCHAR(255),
+    launchscript TEXT,
+    machineid VARCHAR(255),
+    pstatus INTEGER,
+    uptime TIMESTAMP,
+    vishnuname VARCHAR(255)
+);
+
+CREATE TABLE project (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    closed BOOLEAN NOT NULL,
+    date_created TIMESTAMP NOT NULL,
+    deleted BOOLEAN NOT NULL,
+    description TEXT NOT NULL,
+    identifier VARCHAR(255) NOT NULL,
+    is_public BOOLEAN NOT NULL,
+    last_updated TIMESTAMP NOT NULL,
+    name VARCHAR(30) NOT NULL,
+    parent_id INTEGER NOT NULL,
+    CONSTRAINT project_identifier_key UNIQUE (identifier),
+    CONSTRAINT project_name_key UNIQUE (name)
+);
+
+CREATE TABLE project_application (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    application_id BIGINT NOT NULL,
+    project_id BIGINT NOT NULL,
+    CONSTRAINT fkfad3d12a9fcaff4 FOREIGN KEY (application_id) REFERENCES application (id),
+    CONSTRAINT fkfad3d12abd4995a3 FOREIGN KEY (project_id) REFERENCES project (id)
+);
+
+CREATE TABLE project_machine (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    machine_id BIGINT NOT NULL,
+    project_id BIGINT NOT NULL,
+    CONSTRAINT fka2850d219207fb3b FOREIGN KEY (machine_id) REFERENCES machine (nummachineid),
+    CONSTRAINT fka2850d21bd4995a3 FOREIGN KEY (project_id) REFERENCES project (id)
+);
+
+CREATE TABLE project_member (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    date_created TIMESTAMP NOT NULL,
+    last_updated TIMESTAMP NOT NULL,
+    mail_notifications BOOLEAN NOT NULL,
+    member_id BIGINT NOT NULL,
+    project_id BIGINT NOT NULL,
+    CONSTRAINT fk2ec53e80bd4995a3 FOREIGN KEY (project_id) REFERENCES project (id),
+    CONSTRAINT fk2ec53e80da00831d FOREIGN KEY (member_id) REFERENCES users (numuserid)
+);
+
+CREATE TABLE project_member_project_role (
+    project_member_roles_id BIGINT,
+    project_role_id BIGINT,
+    CONSTRAINT fk19b3b13b9edd7798 FOREIGN KEY (project_member_roles_id) REFERENCES project_member (id),
+    CONSTRAINT fk19b3b13bc94ba396 FOREIGN KEY (project_role_id) REFERENCES project_role (id)
+);
+
+CREATE TABLE project_role (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    description TEXT,
+    is_built_in BOOLEAN NOT NULL,
+    is_default BOOLEAN NOT NULL,
+    label VARCHAR(255) NOT NULL,
+    member_specific BOOLEAN NOT NULL,
+    name VARCHAR(255) NOT NULL,
+    pos BIGINT NOT NULL,
+    class VARCHAR(255) NOT NULL,
+    project_id BIGINT,
+    CONSTRAINT fk37fff5dcbd4995a3 FOREIGN KEY (project_id) REFERENCES project (id)
+);
+
+CREATE TABLE project_role_permissions (
+    project_role_id BIGINT,
+    permissions_string VARCHAR(255),
+    CONSTRAINT fkadd15ea1c94ba396 FOREIGN KEY (project_role_id) REFERENCES project_role (id)
+);
+
+CREATE TABLE role (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    authority VARCHAR(255) NOT NULL,
+    description TEXT NOT NULL,
+    CONSTRAINT role_authority_key UNIQUE (authority)
+);
+
+CREATE TABLE state (
+    numstateid INTEGER PRIMARY KEY AUTOINCREMENT,
+    cpuload INTEGER,
+    diskspace INTEGER,
+    machine_nummachineid BIGINT NOT NULL,
+    memory INTEGER,
+    "time" TIMESTAMP,
+    CONSTRAINT fk68ac4911cfedefc FOREIGN KEY (machine_nummachineid) REFERENCES machine (nummachineid) ON DELETE CASCADE
+);
+
+CREATE TABLE test_report (
+    id INTEGER PRIMARY KEY,
+    version BIGINT NOT NULL,
+    name VARCHAR(255) NOT NULL
+);
+
+CREATE TABLE threshold (
+    thresholdid INTEGER PRIMARY KEY AUTOINCREMENT,
+    machine_nummachineid BIGINT NOT NULL,
+    typet INTEGER,
+    users_numuserid BIGINT NOT NULL,
+    value INTEGER,
+    CONSTRAINT fka3e1e46b1cfedefc FOREIGN KEY (machine_nummachineid) REFERENCES machine (nummachineid) ON DELETE CASCADE,
+    CONSTRAINT fka3e1e46ba63719f2 FOREIGN KEY (users_numuserid) REFERENCES users (numuserid)
+);
+
+CREATE TABLE user_role (
+    role_id BIGINT NOT NULL,
+    user_id BIGINT NOT NULL,
+    CONSTRAINT user_role_pkey PRIMARY KEY (role_id, user_id),
+    CONSTRAINT fk143bf46a813ac84c FOREIGN KEY (user_id) REFERENCES users (numuserid) ON DELETE CASCADE,
+    CONSTRAINT fk143bf46adc10046c FOREIGN KEY (role_id) REFERENCES role (id) ON DELETE CASCADE
+);
+
+CREATE TABLE users (
+    numuserid INTEGER PRIMARY KEY AUTOINCREMENT,
+    account_expired BOOLEAN,
+    account_locked BOOLEAN,
+    confirm_code VARCHAR(255),
+    date_created TIMESTAMP,
+    email VARCHAR(255),
+    enabled BOOLEAN,
+    firstname VARCHAR(255),
+    last_updated TIMESTAMP,
+    lastname VARCHAR(255),
+    pwd VARCHAR(255) NOT NULL,
+    password_expired BOOLEAN,
+    passwordstate INTEGER,
+    privilege INTEGER,
+    status INTEGER,
+    userid VARCHAR(255) NOT NULL,
+    vishnu_vishnuid BIGINT NOT NULL,
+    CONSTRAINT fk6a68e08c2584ca8 FOREIGN KEY (vishnu_vishnuid) REFERENCES vishnu (vishnuid)
+);
+
+CREATE TABLE vishnu (
+    vishnuid INTEGER PRIMARY KEY AUTOINCREMENT,
+    formatidauth VARCHAR(255),
+    formatidfiletransfer VARCHAR(255),
+    formatidjob VARCHAR(255),
+    formatidmachine VARCHAR(255),
+    formatiduser VARCHAR(255),
+    formatidwork VARCHAR(255),
+    updatefreq INTEGER
+);
+
+CREATE TABLE vsession (
+    numsessionid INTEGER PRIMARY KEY AUTOINCREMENT,
+    authid VARCHAR(255),
+    clmachine_numclmachineid BIGINT NOT NULL,
+    closepolicy INTEGER,
+    closure TIMESTAMP,
+    creation TIMESTAMP,
+    lastconnect TIMESTAMP,
+    sessionkey VARCHAR(255),
+    state INTEGER,
+    timeout INTEGER,
+    users_numuserid BIGINT NOT NULL,
+    vsessionid VARCHAR(255),
+    CONSTRAINT fk581b3160a63719f2 FOREIGN KEY (users_numuserid) REFERENCES users (numuserid) ON DELETE CASCADE,
+    CONSTRAINT fk581b3160c401bd40 FOREIGN KEY (clmachine_numclmachineid) REFERENCES clmachine (numclmachineid)
+);
+
+CREATE TABLE work (
+    id INTEGER PRIMARY KEY,
+    application_id BIGINT,
+    date_created TIMESTAMP NOT NULL,
+    date_ended TIMESTAMP,
+    date_started TIMESTAMP,
+    description TEXT,
+    done_ratio BIGINT NOT NULL,
+    due_date TIMESTAMP,
+    identifier VARCHAR(255) NOT NULL,
+    last_updated TIMESTAMP NOT NULL,
+    machine_id BIGINT,
+    nbcpus INTEGER NOT NULL,
+    owner_id BIGINT NOT NULL,
+    project_id BIGINT,
+    start_date TIMESTAMP,
+    status INTEGER NOT NULL,
+    subject VARCHAR(255) NOT NULL,
+    submit_date TIMESTAMP,
+    CONSTRAINT fk37c7113462ea58 FOREIGN KEY (application_id) REFERENCES application_version (id),
+    CONSTRAINT fk37c7119207fb3b FOREIGN KEY (machine_id) REFERENCES machine (nummachineid) ON DELETE CASCADE,
+    CONSTRAINT fk37c711bd4995a3 FOREIGN KEY (project_id) REFERENCES project (id) ON DELETE CASCADE,
+    CONSTRAINT fk37c711ed217864 FOREIGN KEY (owner_id) REFERENCES users (numuserid) ON DELETE CASCADE
+);
+
+COMMIT;
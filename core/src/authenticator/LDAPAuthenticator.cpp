@@ -7,10 +7,20 @@
 
 #include "LDAPAuthenticator.hpp"
 
+#include <deque>
 #include <string>
 #include <vector>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/format.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "ldap/LDAPProxy.hpp"
 #include "DatabaseResult.hpp"
@@ -20,6 +30,211 @@
 #include "SystemException.hpp"
 
 
+namespace {
+  /**
+   * \brief The outcome of the binds of a user on the LDAP systems
+   */
+  typedef struct fanout_t {
+    /**
+     * \brief Protects the outcome
+     */
+    boost::mutex mutex;
+    /**
+     * \brief Signaled when a bind is done
+     */
+    boost::condition_variable done;
+    /**
+     * \brief The number of binds running
+     */
+    size_t pending;
+    /**
+     * \brief The first system which authenticated the user, -1 if none
+     */
+    int winner;
+    /**
+     * \brief Whether the login stopped waiting for the binds
+     */
+    bool abandoned;
+    /**
+     * \brief Whether a system could not be reached
+     */
+    bool failed;
+    /**
+     * \brief The error of the last system which could not be reached
+     */
+    SystemException systemError;
+    /**
+     * \brief Whether a system refused the user
+     */
+    bool refused;
+    /**
+     * \brief The error of the last system which refused the user
+     */
+    UserException userError;
+  } fanout_t;
+
+  /**
+   * \brief Bind a user on a LDAP system and record the outcome
+   * \param fanout The outcome, shared by the binds of the user
+   * \param index The index of the system
+   * \param uri The LDAP uri of the system
+   * \param login The login of the user on the system
+   * \param password The password of the user
+   * \param ldapbase The ldapbase of the system
+   */
+  void
+  bindLDAP(boost::shared_ptr<fanout_t> fanout, int index, const std::string uri,
+           const std::string login, const std::string password, const std::string ldapbase) {
+    bool success = false;
+    bool failed = false;
+    SystemException systemError;
+    bool refused = false;
+    UserException userError;
+    bool skipped;
+    {
+      // queued after another system authenticated the user, or too long
+      boost::lock_guard<boost::mutex> lock(fanout->mutex);
+      skipped = (fanout->winner >= 0 || fanout->abandoned);
+    }
+    if (!skipped) {
+      try {
+        LDAPProxy ldapPoxy(uri, login, "", password);
+        ldapPoxy.connectLDAP(ldapbase);
+        success = true;
+      } catch (SystemException& e) {
+        failed = true;
+        systemError = e;
+      } catch (UserException& e) {
+        refused = true;
+        userError = e;
+      }
+    }
+
+    boost::lock_guard<boost::mutex> lock(fanout->mutex);
+    if (success && fanout->winner < 0) {
+      fanout->winner = index;
+    }
+    if (failed) {
+      fanout->failed = true;
+      fanout->systemError = systemError;
+    }
+    if (refused) {
+      fanout->refused = true;
+      fanout->userError = userError;
+    }
+    --fanout->pending;
+    fanout->done.notify_all();
+  }
+
+  /**
+   * \brief The number of binds running at once in the process
+   */
+  const unsigned maxConcurrentBinds = 8;  //%RELAX<MISRA_0_1_3> Used in this file
+
+  /**
+   * \brief The number of seconds a login waits for the binds
+   */
+  const unsigned loginTimeout = 30;  //%RELAX<MISRA_0_1_3> Used in this file
+
+  /**
+   * \class BindPool
+   * \brief A bounded number of threads binding on the LDAP systems: a login
+   * queues a bind per system, so that at most that many binds run at once
+   * however many users log in
+   */
+  class BindPool : public boost::noncopyable {
+  public:
+    /**
+     * \brief Constructor, starts the threads
+     * \param nbThreads the number of threads
+     */
+    explicit BindPool(unsigned nbThreads) {
+      for (unsigned i = 0; i < nbThreads; ++i) {
+        mthreads.create_thread(boost::bind(&BindPool::run, this));
+      }
+    }
+
+    /**
+     * \brief Queue a bind, it records its outcome itself
+     * \param bind the bind
+     */
+    void
+    queue(const boost::function0<void>& bind) {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      mbinds.push_back(bind);
+      mpending.notify_one();
+    }
+
+    /**
+     * \brief Get the pool of the process, created at the first call
+     * \return the pool
+     */
+    static BindPool&
+    getInstance() {
+      boost::call_once(&BindPool::createInstance, minstanceFlag);
+      return *minstance;
+    }
+
+  private:
+    /**
+     * \brief The body of the threads
+     */
+    void
+    run() {
+      while (true) {
+        boost::function0<void> bind;
+        {
+          boost::unique_lock<boost::mutex> lock(mmutex);
+          while (mbinds.empty()) {
+            mpending.wait(lock);
+          }
+          bind = mbinds.front();
+          mbinds.pop_front();
+        }
+        bind();
+      }
+    }
+
+    /**
+     * \brief Create the pool of the process
+     */
+    static void
+    createInstance() {
+      // never destroyed, the threads may bind until the exit
+      minstance = new BindPool(maxConcurrentBinds);
+    }
+
+    /**
+     * \brief The pool of the process
+     */
+    static BindPool* minstance;
+    /**
+     * \brief Guards the creation of the pool of the process
+     */
+    static boost::once_flag minstanceFlag;
+
+    /**
+     * \brief Protects the binds
+     */
+    boost::mutex mmutex;
+    /**
+     * \brief Signaled when a bind is queued
+     */
+    boost::condition_variable mpending;
+    /**
+     * \brief The binds waiting for a thread
+     */
+    std::deque<boost::function0<void> > mbinds;
+    /**
+     * \brief The threads
+     */
+    boost::thread_group mthreads;
+  };
+
+  BindPool* BindPool::minstance = NULL;  //%RELAX<MISRA_0_1_3> Used in this file
+  boost::once_flag BindPool::minstanceFlag = BOOST_ONCE_INIT;
+}
+
 LDAPAuthenticator::LDAPAuthenticator(){
 }
 
@@ -29,7 +244,6 @@ LDAPAuthenticator::~LDAPAuthenticator(){
 bool
 LDAPAuthenticator::authenticate(UMS_Data::User& user) {
   bool authenticated = false;
-  std::string uri, authlogin, authpassword, ldapbase, authSystemStatus, userid, pwd;
 
   DbFactory factory;
   Database* databaseVishnu = factory.getDatabaseInstance();
@@ -52,48 +266,59 @@ LDAPAuthenticator::authenticate(UMS_Data::User& user) {
     throw e;
   }
 
-  std::vector<std::string> tmp;
-  std::vector<std::string>::iterator ii;
-  for (int i = 0; i < static_cast <int> (result->getNbTuples()); ++i) {
-    tmp.clear();
-    tmp = result->get(i);
-
-    ii=tmp.begin();
-    uri = *ii;
-    authlogin = *(++ii);
-    authpassword = *(++ii);
-    ldapbase = *(++ii);
-    authSystemStatus = *(++ii);
-    userid = *(++ii);
-    pwd = *(++ii);
-
-    if (vishnu::convertToInt(authSystemStatus) != vishnu::STATUS_ACTIVE) {
-      UMSVishnuException e (ERRCODE_UNKNOWN_AUTH_SYSTEM, "It is locked");
-      throw e;
+  // the binds run at once on the active systems, in the threads of the
+  // pool, the first success wins
+  std::vector<std::vector<std::string> > rows;
+  bool locked = false;
+  for (size_t i = 0; i < result->getNbTuples(); ++i) {
+    std::vector<std::string> row = result->get(i);
+    if (vishnu::convertToInt(row.at(4)) != vishnu::STATUS_ACTIVE) {
+      locked = true;
+    } else {
+      rows.push_back(row);
     }
+  }
 
-    try {
-      LDAPProxy ldapPoxy(uri,
-                         user.getUserId(),
-                         "",
-                         user.getPassword());
-      ldapPoxy.connectLDAP(ldapbase);
-      authenticated = true;
-      user.setUserId(userid);
-      user.setPassword(pwd);
-      break;
-    }
-    catch (UMSVishnuException& e) {
-      if (e.getMsgI() != ERRCODE_UNKNOWN_USER) {
-        throw UMSVishnuException(e);
-      }
+  boost::shared_ptr<fanout_t> fanout(new fanout_t());
+  fanout->pending = rows.size();
+  fanout->winner = -1;
+  fanout->abandoned = false;
+  fanout->failed = false;
+  fanout->refused = false;
+  if (rows.size() == 1) {
+    bindLDAP(fanout, 0, rows[0][0], user.getUserId(), user.getPassword(), rows[0][3]);
+  } else {
+    BindPool& pool = BindPool::getInstance();
+    for (size_t i = 0; i < rows.size(); ++i) {
+      // the slower binds end after the return, those queued are skipped
+      pool.queue(boost::bind(&bindLDAP, fanout, static_cast<int>(i), rows[i][0],
+                             user.getUserId(), user.getPassword(), rows[i][3]));
     }
-    catch (SystemException& e) {
-      //If there is a connection problem to LDAP and it is not the last LDAP account to check
-      if ((e.getMsgI() == ERRCODE_AUTHENTERR) && (i == (static_cast <int> (result->getNbTuples())-1))) {
-        throw SystemException(e);
-      }
+  }
+
+  // the binds time out on their own, but may wait for a thread of the pool
+  boost::system_time deadline = boost::get_system_time()
+    + boost::posix_time::seconds(loginTimeout);
+  boost::unique_lock<boost::mutex> lock(fanout->mutex);
+  while (fanout->winner < 0 && fanout->pending > 0) {
+    if (!fanout->done.timed_wait(lock, deadline)
+        && fanout->winner < 0 && fanout->pending > 0) {
+      fanout->abandoned = true;
+      throw SystemException(ERRCODE_AUTHENTERR, "Timeout waiting for the LDAP systems");
     }
   }
+
+  if (fanout->winner >= 0) {
+    authenticated = true;
+    user.setUserId(rows[fanout->winner][5]);
+    user.setPassword(rows[fanout->winner][6]);
+  } else if (locked) {
+    UMSVishnuException e (ERRCODE_UNKNOWN_AUTH_SYSTEM, "It is locked");
+    throw e;
+  } else if (fanout->failed) {
+    throw SystemException(fanout->systemError);
+  } else if (fanout->refused) {
+    throw UserException(fanout->userError);
+  }
   return authenticated;
 }
@@ -0,0 +1,145 @@
+/**
+  * \file LDAPConnectionManager.cpp
+  * \brief This file implements the manager of the LDAP connections
+  */
+
+#include "LDAPConnectionManager.hpp"
+
+#include <sys/time.h>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/once.hpp>
+
+#include "HashingPool.hpp"
+#include "utilVishnu.hpp"
+
+const size_t LDAPConnectionManager::maxIdle = 4;  //%RELAX<MISRA_0_1_3> Used in this file
+const long LDAPConnectionManager::bindLifetime = 60;  //%RELAX<MISRA_0_1_3> Used in this file
+const size_t LDAPConnectionManager::maxBinds = 10000;  //%RELAX<MISRA_0_1_3> Used in this file
+const long LDAPConnectionManager::connectTimeout = 10;  //%RELAX<MISRA_0_1_3> Used in this file
+const long LDAPConnectionManager::bindTimeout = 10;  //%RELAX<MISRA_0_1_3> Used in this file
+
+LDAPConnectionManager* LDAPConnectionManager::minstance = NULL;  //%RELAX<MISRA_0_1_3> Used in this file
+
+namespace {
+  /**
+   * \brief Guards the creation of the manager of the process
+   */
+  boost::once_flag instanceFlag = BOOST_ONCE_INIT;
+
+  /**
+   * \brief The LDAP protocol version used
+   */
+  const int protocolVersion = LDAP_VERSION3;
+}
+
+LDAPConnectionManager::LDAPConnectionManager() {
+  // a cheap SHA-512 crypt: the keys only live in the memory of the process
+  msalt = "$6$rounds=1000$" + vishnu::generateToken(16) + "$";
+}
+
+LDAPConnectionManager::~LDAPConnectionManager() {
+  std::map<std::string, std::vector<LDAP*> >::iterator it;
+  for (it = midle.begin(); it != midle.end(); ++it) {
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      ldap_unbind_ext_s(it->second[i], NULL, NULL);
+    }
+  }
+}
+
+LDAP*
+LDAPConnectionManager::acquire(const std::string& uri, bool& reused) {
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::vector<LDAP*>& idle = midle[uri];
+    if (!idle.empty()) {
+      LDAP* ld = idle.back();
+      idle.pop_back();
+      reused = true;
+      return ld;
+    }
+  }
+
+  reused = false;
+  LDAP* ld = NULL;
+  if (ldap_initialize(&ld, uri.c_str()) != LDAP_SUCCESS) {
+    return NULL;
+  }
+  ldap_set_option(ld, LDAP_OPT_PROTOCOL_VERSION, &protocolVersion);
+  struct timeval timeout;
+  timeout.tv_sec = connectTimeout;
+  timeout.tv_usec = 0;
+  ldap_set_option(ld, LDAP_OPT_NETWORK_TIMEOUT, &timeout);
+  timeout.tv_sec = bindTimeout;
+  ldap_set_option(ld, LDAP_OPT_TIMEOUT, &timeout);
+  return ld;
+}
+
+void
+LDAPConnectionManager::release(const std::string& uri, LDAP* ld, bool reusable) {
+  if (ld == NULL) {
+    return;
+  }
+  if (reusable) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::vector<LDAP*>& idle = midle[uri];
+    if (idle.size() < maxIdle) {
+      idle.push_back(ld);
+      return;
+    }
+  }
+  ldap_unbind_ext_s(ld, NULL, NULL);
+}
+
+std::string
+LDAPConnectionManager::getBindKey(const std::string& uri,
+                                  const std::string& dn,
+                                  const std::string& password) {
+  return HashingPool::getInstance().hash(uri + "\n" + dn + "\n" + password, msalt);
+}
+
+bool
+LDAPConnectionManager::isBound(const std::string& key) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, boost::posix_time::ptime>::iterator it = mbinds.find(key);
+  if (it == mbinds.end()) {
+    return false;
+  }
+  if (it->second <= boost::posix_time::second_clock::universal_time()) {
+    mbinds.erase(it);
+    return false;
+  }
+  return true;
+}
+
+void
+LDAPConnectionManager::setBound(const std::string& key) {
+  boost::posix_time::ptime now = boost::posix_time::second_clock::universal_time();
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (mbinds.size() >= maxBinds) {
+    std::map<std::string, boost::posix_time::ptime>::iterator it = mbinds.begin();
+    while (it != mbinds.end()) {
+      if (it->second <= now) {
+        mbinds.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    // all recent: forget them rather than growing
+    if (mbinds.size() >= maxBinds) {
+      mbinds.clear();
+    }
+  }
+  mbinds[key] = now + boost::posix_time::seconds(bindLifetime);
+}
+
+LDAPConnectionManager&
+LDAPConnectionManager::getInstance() {
+  boost::call_once(&LDAPConnectionManager::createInstance, instanceFlag);
+  return *minstance;
+}
+
+void
+LDAPConnectionManager::createInstance() {
+  // never destroyed, the authentications may run until the exit
+  minstance = new LDAPConnectionManager();
+}
@@ -0,0 +1,141 @@
+/**
+  * \file LDAPConnectionManager.hpp
+  * \brief This file defines the manager of the LDAP connections
+  */
+
+#ifndef _LDAP_CONNECTION_MANAGER_H
+#define _LDAP_CONNECTION_MANAGER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+extern "C" {
+#include <ldap.h>
+}
+
+/**
+ * \class LDAPConnectionManager
+ * \brief Keeps the connections to each LDAP server open between the
+ * authentications, and remembers the recent successful binds. A bind is
+ * remembered by a salted hash of its credentials, never by the password.
+ */
+class LDAPConnectionManager : public boost::noncopyable {
+public:
+  /**
+   * \brief The maximum number of idle connections kept per server
+   */
+  static const size_t maxIdle;
+  /**
+   * \brief The number of seconds a successful bind is remembered
+   */
+  static const long bindLifetime;
+  /**
+   * \brief The maximum number of binds remembered
+   */
+  static const size_t maxBinds;
+  /**
+   * \brief The number of seconds to open a connection to a server
+   */
+  static const long connectTimeout;
+  /**
+   * \brief The number of seconds to wait for the answer to a bind, an idle
+   * connection may have been dropped silently by a firewall
+   */
+  static const long bindTimeout;
+
+  /**
+   * \brief Constructor
+   */
+  LDAPConnectionManager();
+
+  /**
+   * \brief Destructor, closes the idle connections
+   */
+  ~LDAPConnectionManager();
+
+  /**
+   * \brief Function to get a connection to a server, an idle one if any
+   * \param uri The LDAP uri of the server
+   * \param reused Set to true if the connection was idle, it may have been
+   * closed by the server since
+   * \return The connection, its operations time out after bindTimeout seconds
+   */
+  LDAP*
+  acquire(const std::string& uri, bool& reused);
+
+  /**
+   * \brief Function to give back a connection
+   * \param uri The LDAP uri of the server
+   * \param ld The connection
+   * \param reusable false if the connection failed, it is then closed
+   */
+  void
+  release(const std::string& uri, LDAP* ld, bool reusable);
+
+  /**
+   * \brief Function to get the key of a bind
+   * \param uri The LDAP uri of the server
+   * \param dn The distinguished name bound
+   * \param password The password
+   * \return The salted hash of the credentials
+   */
+  std::string
+  getBindKey(const std::string& uri, const std::string& dn, const std::string& password);
+
+  /**
+   * \brief Function to know if a bind succeeded recently
+   * \param key The key of the bind
+   * \return true if the bind succeeded less than bindLifetime seconds ago
+   */
+  bool
+  isBound(const std::string& key);
+
+  /**
+   * \brief Function to remember a successful bind
+   * \param key The key of the bind
+   */
+  void
+  setBound(const std::string& key);
+
+  /**
+   * \brief Get the manager of the process, created at the first call
+   * \return the manager
+   */
+  static LDAPConnectionManager&
+  getInstance();
+
+private:
+  /**
+   * \brief Create the manager of the process
+   */
+  static void
+  createInstance();
+
+  /**
+   * \brief The manager of the process
+   */
+  static LDAPConnectionManager* minstance;
+
+  /**
+   * \brief Protects the connections and the binds
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief The idle connections, by uri
+   */
+  std::map<std::string, std::vector<LDAP*> > midle;
+  /**
+   * \brief The expiry of the successful binds, by key
+   */
+  std::map<std::string, boost::posix_time::ptime> mbinds;
+  /**
+   * \brief The salt of the keys, drawn at the creation
+   */
+  std::string msalt;
+};
+
+#endif // _LDAP_CONNECTION_MANAGER_H
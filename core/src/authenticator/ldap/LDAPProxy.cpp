@@ -9,6 +9,7 @@
 
 #include <string>
 
+#include "LDAPConnectionManager.hpp"
 #include "SystemException.hpp"
 #include "UMSVishnuException.hpp"
 
@@ -31,7 +32,7 @@ LDAPProxy::LDAPProxy(const string& uri,
                      LDAPControl* serverCtrls,
                      LDAPControl* clientCtrls) :
   muri(uri), muserName(userName),
-  mauthMechanism(authMechanism), mpwd(password)
+  mauthMechanism(authMechanism), mpwd(password), mreusable(false)
 {
 
    mld = NULL;
@@ -48,20 +49,35 @@ LDAPProxy::connectLDAP(const string& ldapbase) {
   string fullPath;
   extract(ldapbase, fullPath);
 
-  /* Initialize the LDAP session */
-  if ((ldap_initialize(&mld, const_cast<char*>(muri.c_str()))) != LDAP_SUCCESS) {
-      throw SystemException(ERRCODE_AUTHENTERR, "LDAP session initialization failed");
+  LDAPConnectionManager& manager = LDAPConnectionManager::getInstance();
+  string key = manager.getBindKey(muri, fullPath, mpwd);
+  if (manager.isBound(key)) {
+    return 0;
   }
 
-  ldap_set_option(mld, LDAP_OPT_PROTOCOL_VERSION, &desired_version);
+  /* Bind on an idle connection, the server may have closed it meanwhile,
+     or a firewall dropped it without a word: the bind then times out */
+  bool reused = true;
+  do {
+    if (mld != NULL) {
+      manager.release(muri, mld, false);
+    }
+    mld = manager.acquire(muri, reused);
+    if (mld == NULL) {
+      throw SystemException(ERRCODE_AUTHENTERR, "LDAP session initialization failed");
+    }
+    ret = bind(fullPath);
+  } while (reused && (ret == LDAP_SERVER_DOWN || ret == LDAP_CONNECT_ERROR || ret == LDAP_TIMEOUT));
 
-  ret = bind(fullPath);
+  // the server answered: the connection can serve the next bind
+  mreusable = (ret == LDAP_SUCCESS || ret == LDAP_INVALID_CREDENTIALS);
   if (ret != LDAP_SUCCESS ) {
     if (ret != LDAP_INVALID_CREDENTIALS ) {
       throw SystemException(ERRCODE_AUTHENTERR, ldap_err2string(ret));
     }
     throw UserException(ERRCODE_UNKNOWN_USER, "The user is unrecognized on LDAP system");
   }
+  manager.setBound(key);
   return 0;
 }
 
@@ -85,9 +101,7 @@ LDAPProxy::bind(string& fullUserPath) {
 }
 
 LDAPProxy::~LDAPProxy() {
-  if (mld != NULL) {
-    ldap_unbind_ext_s ( mld, NULL, NULL );
-  }
+  LDAPConnectionManager::getInstance().release(muri, mld, mreusable);
 }
 
 void
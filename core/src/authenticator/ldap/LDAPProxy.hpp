@@ -15,8 +15,6 @@ extern "C" {
 #include <lber.h>
 }
 
-static const int desired_version = LDAP_VERSION3;
-
 /**
  * \class LDAPProxy
  * \brief LDAPProxy class implementation
@@ -43,7 +41,8 @@ class LDAPProxy {
                     );
 
   /**
-  * \brief Function to initialize a connection on a LDAP server
+  * \brief Function to bind on a LDAP server, on a connection kept by the
+  * LDAPConnectionManager. A bind which succeeded recently is not redone.
   * \param ldapbase the ldapbase of the ldap system
   * \return If the connection was a succes or an error code
   */
@@ -51,7 +50,7 @@ class LDAPProxy {
   connectLDAP(const std::string& ldapbase);
 
   /**
-    * \brief Destructor
+    * \brief Destructor, gives the connection back to the manager
     */
   ~LDAPProxy();
 
@@ -96,6 +95,10 @@ class LDAPProxy {
   * \brief the credential to use for authentication
   */
    std::string mpwd;
+  /**
+  * \brief Whether the connection can be kept for the next bind
+  */
+   bool mreusable;
 
 /**
  * \brief the server controls
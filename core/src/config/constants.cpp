@@ -50,7 +50,23 @@ namespace vishnu {
     /* [38] */ {OPTION_SESSION_TIMEOUT, "sessionTimeout", INT_PARAMETER},
     /* [39] */ {OPTION_TRANSFER_TIMEOUT, "transferTimeout", INT_PARAMETER},
     /* [40] */ {OPTION_DEFAULT_TRANSFER_CMD, "defaultTransferCommand", INT_PARAMETER},
-    /* [41] */ {OPTION_DEFAULT_CONNECTION_CLOSE_POLICY, "defaultConnectionClosePolicy", INT_PARAMETER}
+    /* [41] */ {OPTION_DEFAULT_CONNECTION_CLOSE_POLICY, "defaultConnectionClosePolicy", INT_PARAMETER},
+    /* [42] */ {DISP_ROUTING_POLICY, "disp_routingPolicy", STRING_PARAMETER},
+    /* [43] */ {DISP_ROUTING_MAXLOAD, "disp_routingMaxLoad", INT_PARAMETER},
+    /* [44] */ {DBPOOLTIMEOUT, "databaseConnectionTimeout", INT_PARAMETER},
+    /* [45] */ {DBWRITEBEHINDINTERVAL, "databaseWriteBehindInterval", INT_PARAMETER},
+    /* [46] */ {DBWRITEBEHINDCAPACITY, "databaseWriteBehindCapacity", INT_PARAMETER},
+    /* [47] */ {DBSCHEMAUPGRADE, "databaseSchemaUpgrade", BOOL_PARAMETER},
+    /* [48] */ {DBIDBLOCKSIZE, "databaseIdBlockSize", INT_PARAMETER},
+    /* [49] */ {DBREPLICAHOSTS, "databaseReplicaHosts", STRING_PARAMETER},
+    /* [50] */ {DBREPLICAMAXLAG, "databaseReplicaMaxLag", INT_PARAMETER},
+    /* [51] */ {DBSESSIONCACHETTL, "databaseSessionCacheTtl", INT_PARAMETER},
+    /* [52] */ {DBSESSIONCACHESIZE, "databaseSessionCacheSize", INT_PARAMETER},
+    /* [53] */ {DBREFERENCECACHETTL, "databaseReferenceCacheTtl", INT_PARAMETER},
+    /* [54] */ {DBREFERENCECACHESIZE, "databaseReferenceCacheSize", INT_PARAMETER},
+    /* [55] */ {DBARCHIVEAGE, "databaseArchiveAge", INT_PARAMETER},
+    /* [56] */ {DBARCHIVEBATCHSIZE, "databaseArchiveBatchSize", INT_PARAMETER},
+    /* [57] */ {DBSLOWQUERYTHRESHOLD, "databaseSlowQueryThreshold", INT_PARAMETER}
   };
 
   std::map<cloud_env_vars_t, std::string> CLOUD_ENV_VARS =  boost::assign::map_list_of
@@ -63,7 +63,23 @@ namespace vishnu {
     OPTION_SESSION_TIMEOUT,
     OPTION_TRANSFER_TIMEOUT,
     OPTION_DEFAULT_TRANSFER_CMD,
-    OPTION_DEFAULT_CONNECTION_CLOSE_POLICY
+    OPTION_DEFAULT_CONNECTION_CLOSE_POLICY,
+    DISP_ROUTING_POLICY,
+    DISP_ROUTING_MAXLOAD,
+    DBPOOLTIMEOUT,
+    DBWRITEBEHINDINTERVAL,
+    DBWRITEBEHINDCAPACITY,
+    DBSCHEMAUPGRADE,
+    DBIDBLOCKSIZE,
+    DBREPLICAHOSTS,
+    DBREPLICAMAXLAG,
+    DBSESSIONCACHETTL,
+    DBSESSIONCACHESIZE,
+    DBREFERENCECACHETTL,
+    DBREFERENCECACHESIZE,
+    DBARCHIVEAGE,
+    DBARCHIVEBATCHSIZE,
+    DBSLOWQUERYTHRESHOLD
   };
 
   /**
@@ -1,7 +1,164 @@
 #include "Database.hpp"
 
-Database:: Database(){};
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <boost/scoped_ptr.hpp>
+#include "DbTransaction.hpp"
+#include "SystemException.hpp"
+
+const size_t Database::maxInsertRows = 500;  //%RELAX<MISRA_0_1_3> Used in this file
+
+Database:: Database() : mprofiler(NULL) {};
 
 Database::~Database(){};
 
+DbConnectionPool::stats_t
+Database::getPoolStats() {
+  DbConnectionPool::stats_t stats = DbConnectionPool::stats_t();
+  return stats;
+}
+
+void
+Database::setProfiler(DbProfiler* profiler) {
+  mprofiler = profiler;
+}
+
+int
+Database::processPrepared(const std::string& request,
+                          const std::vector<std::string>& params,
+                          int transacId) {
+  return process(bindParams(request, params), transacId);
+}
+
+DatabaseResult*
+Database::getPreparedResult(const std::string& request,
+                            const std::vector<std::string>& params,
+                            int transacId) {
+  return getResult(bindParams(request, params), transacId);
+}
+
+int
+Database::processBatch(const std::vector<std::string>& requests, int transacId) {
+  if (requests.empty()) {
+    return SUCCESS;
+  }
+  std::string batch = joinRequests(requests);
+  if (transacId != -1) {
+    return process(batch, transacId);
+  }
+  // the statements of a multi-statement request are committed one by one
+  DbTransaction transaction(this);
+  process(batch, transaction.getId());
+  transaction.commit();
+  return SUCCESS;
+}
+
+int
+Database::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                     const std::vector<std::vector<std::string> >& rows, int transacId) {
+  return insertRows(table, columns, rows, std::vector<std::vector<bool> >(), transacId);
+}
+
+int
+Database::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                     const std::vector<std::vector<std::string> >& rows,
+                     const std::vector<std::vector<bool> >& nulls, int transacId) {
+  if (rows.empty()) {
+    return SUCCESS;
+  }
+  if (!nulls.empty() && nulls.size() != rows.size()) {
+    throw SystemException(ERRCODE_DBERR, "The NULL values do not match the rows of table " + table);
+  }
+  std::string head = "INSERT INTO " + table + " (";
+  for (size_t i = 0; i < columns.size(); ++i) {
+    head += (i == 0 ? "" : ", ") + columns[i];
+  }
+  head += ") VALUES ";
+
+  // the multi-row requests are bounded, e.g. by the compound limit of SQLite
+  std::vector<std::string> requests;
+  for (size_t first = 0; first < rows.size(); first += maxInsertRows) {
+    std::string request = head;
+    size_t last = std::min(rows.size(), first + maxInsertRows);
+    for (size_t row = first; row < last; ++row) {
+      if (rows[row].size() != columns.size()
+          || (!nulls.empty() && nulls[row].size() != columns.size())) {
+        throw SystemException(ERRCODE_DBERR, "The values of a row do not match the columns of table " + table);
+      }
+      request += (row == first) ? "(" : ", (";
+      for (size_t i = 0; i < columns.size(); ++i) {
+        request += (i == 0) ? "" : ", ";
+        if (!nulls.empty() && nulls[row][i]) {
+          request += "NULL";
+        } else {
+          request += "'" + escapeData(rows[row][i]) + "'";
+        }
+      }
+      request += ")";
+    }
+    requests.push_back(request);
+  }
+  if (requests.size() == 1) {
+    return process(requests.front(), transacId);
+  }
+  return processBatch(requests, transacId);
+}
+
+std::string
+Database::joinRequests(const std::vector<std::string>& requests) {
+  std::string batch;
+  std::vector<std::string>::const_iterator it;
+  for (it = requests.begin(); it != requests.end(); ++it) {
+    std::string::size_type end = it->find_last_not_of("; \t\n");
+    if (end != std::string::npos) {
+      batch.append(*it, 0, end + 1);
+      batch += ";\n";
+    }
+  }
+  return batch;
+}
+
+size_t
+Database::forEachRow(const std::string& request, const RowHandler& handler,
+                     int transacId) {
+  // no streaming in this backend, the result is loaded first
+  boost::scoped_ptr<DatabaseResult> result(getResult(request, transacId));
+  for (size_t i = 0; i < result->getNbTuples(); ++i) {
+    handler(result->getRow(i));
+  }
+  return result->getNbTuples();
+}
+
+std::string
+Database::addParam(std::vector<std::string>& params, const std::string& value) {
+  params.push_back(value);
+  std::ostringstream ref;
+  ref << "$" << params.size();
+  return ref.str();
+}
 
+std::string
+Database::bindParams(const std::string& request, const std::vector<std::string>& params) {
+  std::string bound;
+  bound.reserve(request.size());
+  std::string::size_type pos = 0;
+  while (pos < request.size()) {
+    std::string::size_type end = pos + 1;
+    while (end < request.size() && isdigit(static_cast<unsigned char>(request[end]))) {
+      ++end;
+    }
+    if (request[pos] != '$' || end == pos + 1) {
+      bound += request[pos++];
+      continue;
+    }
+    size_t index = strtoul(request.substr(pos + 1, end - pos - 1).c_str(), NULL, 10);
+    if (index == 0 || index > params.size()) {
+      throw SystemException(ERRCODE_DBERR, "Missing value for parameter " + request.substr(pos, end - pos));
+    }
+    bound += "'" + escapeData(params[index - 1]) + "'";
+    pos = end;
+  }
+  return bound;
+}
@@ -9,8 +9,13 @@
 #define _ABSTRACTDATABASE_H_
 
 #include <string>
+#include <vector>
+#include <boost/function.hpp>
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
+#include "DbConnectionPool.hpp"
+
+class DbProfiler;
 
 static const int SUCCESS = 0;
 /**
@@ -19,6 +24,17 @@ static const int SUCCESS = 0;
  */
 class Database{
 public :
+  /**
+   * \brief Maximum number of rows inserted by a request of insertRows
+   */
+  static const size_t maxInsertRows;
+
+  /**
+   * \brief Callback receiving the tuples of a streamed request, the view is
+   * only valid during the call
+   */
+  typedef boost::function<void (const DatabaseResult::Row&)> RowHandler;
+
   /**
    * \brief Function to process the request in the database
    * \param request The request to process (must contain a SINGLE SQL statement without a semicolumn)
@@ -41,6 +57,80 @@ public :
   */
   virtual DatabaseResult*
   getResult(std::string request, int transacId = -1) = 0;
+  /**
+   * \brief Function to process a parameterized request, the backend may keep
+   * it prepared on the connection for the next calls
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters, bound as text
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& request,
+                  const std::vector<std::string>& params,
+                  int transacId = -1);
+  /**
+   * \brief To get the result of a parameterized select request
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters, bound as text
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& request,
+                    const std::vector<std::string>& params,
+                    int transacId = -1);
+  /**
+   * \brief Function to process several requests in a single round trip
+   * Without transaction, the requests are applied atomically: if one fails
+   * none is applied
+   * \param requests The requests to process, a single SQL statement each
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processBatch(const std::vector<std::string>& requests, int transacId = -1);
+  /**
+   * \brief Function to insert several rows in a table in a single round trip,
+   * with requests of maxInsertRows rows at most. Without transaction, the
+   * rows are inserted atomically.
+   * \param table The table
+   * \param columns The columns given for each row
+   * \param rows The values of the columns of each row, bound as text
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  int
+  insertRows(const std::string& table, const std::vector<std::string>& columns,
+             const std::vector<std::vector<std::string> >& rows, int transacId = -1);
+  /**
+   * \brief Function to insert several rows in a table, some values being
+   * NULL, in a single round trip as above
+   * \param table The table
+   * \param columns The columns given for each row
+   * \param rows The values of the columns of each row, bound as text
+   * \param nulls Whether each value of each row is NULL, its text is then
+   * ignored, empty if no value is NULL
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  insertRows(const std::string& table, const std::vector<std::string>& columns,
+             const std::vector<std::vector<std::string> >& rows,
+             const std::vector<std::vector<bool> >& nulls, int transacId = -1);
+  /**
+   * \brief To stream the result of a select request, the tuples are given
+   * to the handler as they are fetched so that the memory does not grow
+   * with the size of the result. The handler must not stream another
+   * request in the same transaction.
+   * \param request The request to process (a single SELECT)
+   * \param handler The callback called for each tuple
+   * \param transacId the id of the transaction if one is used
+   * \return the number of tuples
+   */
+  virtual size_t
+  forEachRow(const std::string& request, const RowHandler& handler,
+             int transacId = -1);
   /**
    * \brief To get the type of database
    * \return An enum identifying the type of database
@@ -53,8 +143,9 @@ public :
      */
 virtual ~Database();
 /**
- * \brief Start a transaction
- * \return The transaction ID
+ * \brief Start a transaction, pinned to a connection of the pool until it
+ * is ended or cancelled. See DbTransaction for a scope guard.
+ * \return The transaction ID, to give to the requests of the transaction
  */
   virtual int
   startTransaction() = 0;
@@ -102,6 +193,29 @@ virtual ~Database();
    */
   virtual std::string escapeData(const std::string& data) = 0;
 
+  /**
+   * \brief To get the usage metrics of the connection pool
+   * \return the metrics, all null if the database has no pool
+   */
+  virtual DbConnectionPool::stats_t
+  getPoolStats();
+
+  /**
+   * \brief To time the requests of the database
+   * \param profiler the statistics of the requests, nil if they are not timed
+   */
+  void
+  setProfiler(DbProfiler* profiler);
+
+  /**
+   * \brief To append a value to the parameters of a request
+   * \param params The parameters of the request
+   * \param value The value to add
+   * \return the reference to the parameter to put in the request ($1, $2...)
+   */
+  static std::string
+  addParam(std::vector<std::string>& params, const std::string& value);
+
 
 protected :
   /**
@@ -109,6 +223,29 @@ protected :
    */
   Database();
 
+  /**
+   * \brief To replace the parameters of a request by escaped literals,
+   * for the backends without parameterized requests
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters
+   * \return the request to process
+   */
+  std::string
+  bindParams(const std::string& request, const std::vector<std::string>& params);
+
+  /**
+   * \brief To build a multi-statement request
+   * \param requests The requests, a single SQL statement each
+   * \return the requests separated by semicolons
+   */
+  static std::string
+  joinRequests(const std::vector<std::string>& requests);
+
+  /**
+   * \brief The statistics of the requests, nil if they are not timed
+   */
+  DbProfiler* mprofiler;
+
 private :
   /**
    * \brief To disconnect from the database
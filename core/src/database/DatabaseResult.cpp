@@ -6,9 +6,16 @@
  */
 #include "DatabaseResult.hpp"
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
+#include "SystemException.hpp"
+#include "utilVishnu.hpp"
+
 /**
  * \brief Constructor, raises an exception on error
  */
@@ -16,6 +23,12 @@ DatabaseResult::DatabaseResult(const std::vector<std::vector<std::string> >& res
                                const std::vector<std::string>& namesAttributes)
   : fields(0), tuples(0), results(res), attributesNames(namesAttributes) {}
 
+/**
+ * \brief Constructor for the results kept by the backends
+ */
+DatabaseResult::DatabaseResult()
+  : fields(0), tuples(0) {}
+
 /**
  * \brief Destructor, raises an exception on error
  */
@@ -28,16 +41,10 @@ DatabaseResult::~DatabaseResult() {}
  */
 void
 DatabaseResult::print() {
-  std::vector<std::string> tmp;
-  std::vector<std::string>::iterator ii;
-
   if (getNbTuples() != 0) {
-    for (int i = 0; i < static_cast <int> (results.size()); ++i) {
-      tmp.clear();
-      tmp = results[i];
-
-      for(ii=tmp.begin();ii!=tmp.end();++ii){
-        std::cout << *ii <<"  ";
+    for (size_t i = 0; i < getNbTuples(); ++i) {
+      for (size_t j = 0; j < getNbFields(); ++j) {
+        std::cout << getCell(i, j) <<"  ";
       }
       std::cout << std::endl;
     }
@@ -54,10 +61,8 @@ DatabaseResult::print() {
  */
 void
 DatabaseResult::printAttributesNames() {
-  std::vector<std::string>::iterator ii;
-
-  for(ii=attributesNames.begin();ii!=attributesNames.end();++ii) {
-    std::cout << *ii <<"  ";
+  for (size_t j = 0; j < getNbFields(); ++j) {
+    std::cout << getAttributeName(j) <<"  ";
   }
   std::cout << std::endl;
 }
@@ -88,16 +93,13 @@ DatabaseResult::get(size_t position) const{
 
   std::vector<std::string> tmp;
 
-  // size_t always >= 0 since it's an unsigned (Cf. stddef.h)
-  if (position > getNbTuples()) {
-    return std::vector<std::string>();
-  }
-  else {
-    if (position < getNbTuples()) {
-    tmp = results[position];
+  if (position < getNbTuples()) {
+    tmp.reserve(getNbFields());
+    for (size_t j = 0; j < getNbFields(); ++j) {
+      tmp.push_back(std::string(getCell(position, j), getCellLength(position, j)));
     }
-    return tmp;
   }
+  return tmp;
 }
 /**
  * \brief To get the number of fields
@@ -105,7 +107,12 @@ DatabaseResult::get(size_t position) const{
  */
 std::vector<std::vector<std::string> >
 DatabaseResult::getResults() const{
-  return results;
+  std::vector<std::vector<std::string> > all;
+  all.reserve(getNbTuples());
+  for (size_t i = 0; i < getNbTuples(); ++i) {
+    all.push_back(get(i));
+  }
+  return all;
 }
 
 /**
@@ -114,14 +121,113 @@ DatabaseResult::getResults() const{
  */
 std::string
 DatabaseResult::getFirstElement() const {
-  std::vector<std::string>::iterator ii;
-
-  if (getNbTuples() != 0) {
-    std::vector<std::string> tmp = get(0);
-    ii=tmp.begin();
-    return (*ii);
+  if (getNbTuples() != 0 && getNbFields() != 0) {
+    return std::string(getCell(0, 0), getCellLength(0, 0));
   }
   else {
     return "";
   }
 }
+
+DatabaseResult::Row
+DatabaseResult::getRow(size_t position) const {
+  if (position >= getNbTuples()) {
+    throw SystemException(ERRCODE_DBERR, "Tuple out of the range of the result");
+  }
+  return Row(*this, position);
+}
+
+const char*
+DatabaseResult::getCell(size_t position, size_t field) const {
+  return results[position][field].c_str();
+}
+
+size_t
+DatabaseResult::getCellLength(size_t position, size_t field) const {
+  return results[position][field].size();
+}
+
+bool
+DatabaseResult::isCellNull(size_t position, size_t field) const {
+  // the copied results do not keep NULL apart from empty strings
+  return false;
+}
+
+std::string
+DatabaseResult::getAttributeName(size_t field) const {
+  return attributesNames[field];
+}
+
+const char*
+DatabaseResult::Row::getValue(size_t field) const {
+  if (field >= mresult.getNbFields()) {
+    throw SystemException(ERRCODE_DBERR, "Field out of the range of the result");
+  }
+  return mresult.getCell(mposition, field);
+}
+
+size_t
+DatabaseResult::Row::getLength(size_t field) const {
+  if (field >= mresult.getNbFields()) {
+    throw SystemException(ERRCODE_DBERR, "Field out of the range of the result");
+  }
+  return mresult.getCellLength(mposition, field);
+}
+
+bool
+DatabaseResult::Row::isNull(size_t field) const {
+  if (field >= mresult.getNbFields()) {
+    throw SystemException(ERRCODE_DBERR, "Field out of the range of the result");
+  }
+  return mresult.isCellNull(mposition, field);
+}
+
+std::string
+DatabaseResult::Row::getString(size_t field) const {
+  return std::string(getValue(field), getLength(field));
+}
+
+int
+DatabaseResult::Row::getInt(size_t field) const {
+  long long value = getLong(field);
+  if (value < INT_MIN || value > INT_MAX) {
+    return -1;
+  }
+  return static_cast<int>(value);
+}
+
+long long
+DatabaseResult::Row::getLong(size_t field) const {
+  // same conventions as vishnu::convertToInt, without the copy
+  const char* value = getValue(field);
+  char* end = NULL;
+  errno = 0;
+  long long converted = strtoll(value, &end, 10);
+  if (end == value || *end != '\0' || errno == ERANGE) {
+    return -1;
+  }
+  return converted;
+}
+
+double
+DatabaseResult::Row::getDouble(size_t field) const {
+  const char* value = getValue(field);
+  char* end = NULL;
+  double converted = strtod(value, &end);
+  if (end == value || *end != '\0') {
+    return 0.0;
+  }
+  return converted;
+}
+
+bool
+DatabaseResult::Row::getBool(size_t field) const {
+  const char* value = getValue(field);
+  return (strcmp(value, "t") == 0 || strcmp(value, "true") == 0
+          || strcmp(value, "y") == 0 || strcmp(value, "1") == 0);
+}
+
+time_t
+DatabaseResult::Row::getTimestamp(size_t field) const {
+  return vishnu::string_to_time_t(getString(field));
+}
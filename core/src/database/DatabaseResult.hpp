@@ -8,15 +8,106 @@
 #ifndef _DATABASERESULT_H_
 #define _DATABASERESULT_H_
 
+#include <ctime>
 #include <string>
 #include <vector>
 
 /**
  * \class DatabaseResult
  * \brief This class describes the object which encapsulates the database results
+ * The backends may keep their native result and give access to its cells
+ * without copying them, use getRow() rather than get() to read them.
  */
 class DatabaseResult{
 public :
+  /**
+   * \class Row
+   * \brief A view on a tuple of a result, valid while the result lives
+   */
+  class Row {
+  public :
+    /**
+     * \brief Constructor
+     * \param result The result
+     * \param position The position of the tuple
+     */
+    Row(const DatabaseResult& result, size_t position)
+      : mresult(result), mposition(position) {}
+    /**
+     * \brief To get the value of a field, without copy
+     * \param field The position of the field
+     * \return a null-terminated string, empty for NULL
+     */
+    const char*
+    getValue(size_t field) const;
+    /**
+     * \brief To get the length of the value of a field
+     * \param field The position of the field
+     * \return the length in bytes
+     */
+    size_t
+    getLength(size_t field) const;
+    /**
+     * \brief To know whether a field is NULL
+     * \param field The position of the field
+     * \return true if the field is NULL
+     */
+    bool
+    isNull(size_t field) const;
+    /**
+     * \brief To get a copy of the value of a field
+     * \param field The position of the field
+     * \return the value
+     */
+    std::string
+    getString(size_t field) const;
+    /**
+     * \brief To get the value of an integer field
+     * \param field The position of the field
+     * \return the value, -1 if it is not an integer
+     */
+    int
+    getInt(size_t field) const;
+    /**
+     * \brief To get the value of a bigint field
+     * \param field The position of the field
+     * \return the value, -1 if it is not an integer
+     */
+    long long
+    getLong(size_t field) const;
+    /**
+     * \brief To get the value of a floating point field
+     * \param field The position of the field
+     * \return the value, 0 if it is not a number
+     */
+    double
+    getDouble(size_t field) const;
+    /**
+     * \brief To get the value of a boolean field
+     * \param field The position of the field
+     * \return true for 't', 'true', 'y' or '1'
+     */
+    bool
+    getBool(size_t field) const;
+    /**
+     * \brief To get the value of a timestamp field
+     * \param field The position of the field
+     * \return the date, the epoch if it is not a timestamp
+     */
+    time_t
+    getTimestamp(size_t field) const;
+
+  private :
+    /**
+     * \brief The result
+     */
+    const DatabaseResult& mresult;
+    /**
+     * \brief The position of the tuple
+     */
+    size_t mposition;
+  };
+
   /**
    * \brief Function to print the database results
    */
@@ -31,15 +122,23 @@ public :
    * \brief To get the number of tuples
    * \return 0 on success, an error code otherwise
    */
-  size_t
+  virtual size_t
   getNbTuples() const;
   /**
    * \brief To get the number of fields
    * \return 0 on success, an error code otherwise
    */
-  size_t
+  virtual size_t
   getNbFields() const;
 
+  /**
+   * \brief To get a view on a tuple, raises an exception if out of range
+   * \param position The position of the tuple
+   * \return the view on the tuple, valid while the result lives
+   */
+  Row
+  getRow(size_t position) const;
+
   /**
    * \brief To get a specific results using its position
    * \param position The position of the request
@@ -67,7 +166,45 @@ public :
   /**
    * \brief Destructor, raises an exception on error
    */
- ~DatabaseResult();
+  virtual ~DatabaseResult();
+
+protected :
+  /**
+   * \brief Constructor for the results kept by the backends
+   */
+  DatabaseResult();
+  /**
+   * \brief To get the value of a cell
+   * \param position The position of the tuple
+   * \param field The position of the field
+   * \return a null-terminated string, empty for NULL
+   */
+  virtual const char*
+  getCell(size_t position, size_t field) const;
+  /**
+   * \brief To get the length of the value of a cell
+   * \param position The position of the tuple
+   * \param field The position of the field
+   * \return the length in bytes
+   */
+  virtual size_t
+  getCellLength(size_t position, size_t field) const;
+  /**
+   * \brief To know whether a cell is NULL
+   * \param position The position of the tuple
+   * \param field The position of the field
+   * \return true if the cell is NULL
+   */
+  virtual bool
+  isCellNull(size_t position, size_t field) const;
+  /**
+   * \brief To get the name of a field
+   * \param field The position of the field
+   * \return the name
+   */
+  virtual std::string
+  getAttributeName(size_t field) const;
+
 private :
   /////////////////////////////////
   // Attributes
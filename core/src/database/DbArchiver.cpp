@@ -0,0 +1,111 @@
+/**
+ * \file DbArchiver.cpp
+ * \brief This file implements the archival of the history tables
+ */
+#include "DbArchiver.hpp"
+
+#include <iostream>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "constants.hpp"
+#include "Database.hpp"
+#include "DbTransaction.hpp"
+#include "SystemException.hpp"
+
+const unsigned DbArchiver::archiveInterval = 60;  //%RELAX<MISRA_0_1_3> Used in this file
+
+DbArchiver::DbArchiver(Database* database, unsigned age, unsigned batchSize)
+  : mdatabase(database), mage(age), mbatchSize(batchSize), mnextRun(0), mwarned(false) {
+}
+
+int
+DbArchiver::archive() {
+  time_t now = time(NULL);
+  if (now < mnextRun) {
+    return 0;
+  }
+
+  time_t limit = now - static_cast<time_t>(mage) * 24 * 3600;
+  struct tm date;
+  char cutoff[32];
+  localtime_r(&limit, &date);
+  strftime(cutoff, sizeof(cutoff), "%Y-%m-%d %H:%M:%S", &date);
+
+  int moved = 0;
+  bool full = false;
+  try {
+    // the sessions last, once the rows referring to them are gone
+    int count = archiveTable("job", "numjobid", boost::str(
+        boost::format("status IN (%1%, %2%, %3%) AND enddate < '%4%'")
+        % vishnu::STATE_CANCELLED % vishnu::STATE_DOWNLOADED % vishnu::STATE_FAILED % cutoff));
+    moved += count;
+    full = full || count == static_cast<int>(mbatchSize);
+
+    count = archiveTable("command", "numcommandid", boost::str(
+        boost::format("endtime IS NOT NULL AND endtime < '%1%'") % cutoff));
+    moved += count;
+    full = full || count == static_cast<int>(mbatchSize);
+
+    count = archiveTable("filetransfer", "numfiletransferid", boost::str(
+        boost::format("status IN (%1%, %2%, %3%) AND starttime < '%4%'")
+        % vishnu::TRANSFER_COMPLETED % vishnu::TRANSFER_CANCELLED % vishnu::TRANSFER_FAILED % cutoff));
+    moved += count;
+    full = full || count == static_cast<int>(mbatchSize);
+
+    count = archiveTable("vsession", "numsessionid", boost::str(
+        boost::format("state = %1% AND closure < '%2%'"
+                      " AND NOT EXISTS (SELECT 1 FROM job WHERE job.vsession_numsessionid = vsession.numsessionid)"
+                      " AND NOT EXISTS (SELECT 1 FROM command WHERE command.vsession_numsessionid = vsession.numsessionid)"
+                      " AND NOT EXISTS (SELECT 1 FROM filetransfer WHERE filetransfer.vsession_numsessionid = vsession.numsessionid)")
+        % vishnu::SESSION_CLOSED % cutoff));
+    moved += count;
+    full = full || count == static_cast<int>(mbatchSize);
+    mwarned = false;
+  } catch (VishnuException& ex) {
+    // e.g. the schema has not been upgraded, warn once until it works
+    if (!mwarned) {
+      mwarned = true;
+      std::cerr << "[WARN] Cannot archive the history tables: " << ex.what() << "\n";
+    }
+    full = false;
+  }
+
+  // the next batches at once while the tables are late
+  if (!full) {
+    mnextRun = now + archiveInterval;
+  }
+  return moved;
+}
+
+bool
+DbArchiver::mayBeArchived(time_t from) const {
+  return from <= 0 || from < time(NULL) - static_cast<time_t>(mage) * 24 * 3600;
+}
+
+int
+DbArchiver::archiveTable(const std::string& table, const std::string& primary,
+                         const std::string& terminal) {
+  DbTransaction transaction(mdatabase);
+  // a SQLite transaction already holds the write lock of the database
+  const char* lock = (mdatabase->getDbType() == DbConfiguration::SQLITE) ? "" : " FOR UPDATE";
+  boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(boost::str(
+      boost::format("SELECT %1% FROM %2% WHERE %3% ORDER BY %1% LIMIT %4%%5%")
+      % primary % table % terminal % mbatchSize % lock), transaction.getId()));
+  if (result->getNbTuples() == 0) {
+    return 0;
+  }
+
+  std::string ids;
+  for (size_t i = 0; i < result->getNbTuples(); ++i) {
+    ids += (i == 0 ? "" : ", ") + result->get(i).at(0);
+  }
+  mdatabase->process(boost::str(
+      boost::format("INSERT INTO %1%_archive SELECT * FROM %1% WHERE %2% IN (%3%)")
+      % table % primary % ids), transaction.getId());
+  mdatabase->process(boost::str(
+      boost::format("DELETE FROM %1% WHERE %2% IN (%3%)") % table % primary % ids),
+      transaction.getId());
+  transaction.commit();
+  return static_cast<int>(result->getNbTuples());
+}
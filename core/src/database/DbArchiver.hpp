@@ -0,0 +1,92 @@
+/**
+ * \file DbArchiver.hpp
+ * \brief This file defines the archival of the history tables
+ */
+
+#ifndef _DBARCHIVER_H_
+#define _DBARCHIVER_H_
+
+#include <ctime>
+#include <string>
+#include <boost/noncopyable.hpp>
+
+class Database;
+
+/**
+ * \class DbArchiver
+ * \brief Moves the rows of the tables job, command, filetransfer and
+ * vsession which have reached a terminal state for a given age to the
+ * tables of the same name suffixed by _archive, so that the hot tables
+ * only hold the active work. The views suffixed by _history join both
+ * for the listings asking for old data. A session is archived once no
+ * hot row refers to it. The rows are moved in bounded batches, one
+ * transaction per batch, and concurrent servers lock the rows they move.
+ */
+class DbArchiver : public boost::noncopyable {
+public:
+  /**
+   * \brief Time between two passes once the tables hold no row to move,
+   * in seconds
+   */
+  static const unsigned archiveInterval;
+
+  /**
+   * \brief Constructor
+   * \param database the database storing the tables
+   * \param age the number of days a terminal row stays in the hot tables
+   * \param batchSize the maximum number of rows of a table moved at once
+   */
+  DbArchiver(Database* database, unsigned age, unsigned batchSize);
+
+  /**
+   * \brief Move a batch of each table if a pass is due, to call
+   * periodically by a single thread
+   * \return the number of rows moved
+   */
+  int
+  archive();
+
+  /**
+   * \brief Check whether the rows dated after a given time may have been
+   * archived
+   * \param from the time, 0 or less if there is none
+   * \return true if the history views must be read
+   */
+  bool
+  mayBeArchived(time_t from) const;
+
+private:
+  /**
+   * \brief Move a batch of a table
+   * \param table the table
+   * \param primary the primary key of the table
+   * \param terminal the condition of the rows to move
+   * \return the number of rows moved
+   */
+  int
+  archiveTable(const std::string& table, const std::string& primary,
+               const std::string& terminal);
+
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+  /**
+   * \brief The number of days a terminal row stays in the hot tables
+   */
+  unsigned mage;
+  /**
+   * \brief The maximum number of rows of a table moved at once
+   */
+  unsigned mbatchSize;
+  /**
+   * \brief When the next pass is due
+   */
+  time_t mnextRun;
+  /**
+   * \brief Whether the failure of the last pass has been reported
+   */
+  bool mwarned;
+};
+
+#endif // _DBARCHIVER_H_
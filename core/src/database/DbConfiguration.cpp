@@ -13,6 +13,16 @@
 using namespace std;
 
 const unsigned DbConfiguration::defaultDbPoolSize = 10;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbPoolTimeout = 60;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbWriteBehindCapacity = 1000;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbIdBlockSize = 50;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbReplicaMaxLag = 5;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbSessionCacheTtl = 30;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbSessionCacheSize = 10000;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbReferenceCacheTtl = 60;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbReferenceCacheSize = 10000;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbArchiveBatchSize = 1000;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned DbConfiguration::defaultDbSlowQueryThreshold = 1000;  //%RELAX<MISRA_0_1_3> Used in this file
 
 /**
  * \brief Constructor
@@ -23,6 +33,19 @@ DbConfiguration::DbConfiguration(const ExecConfiguration& execConfig)
   mdbType(POSTGRESQL),
   mdbPort(0),
   mdbPoolSize(defaultDbPoolSize),
+  mdbPoolTimeout(defaultDbPoolTimeout),
+  mdbWriteBehindInterval(0),
+  mdbWriteBehindCapacity(defaultDbWriteBehindCapacity),
+  mdbSchemaUpgrade(true),
+  mdbIdBlockSize(defaultDbIdBlockSize),
+  mdbReplicaMaxLag(defaultDbReplicaMaxLag),
+  mdbSessionCacheTtl(defaultDbSessionCacheTtl),
+  mdbSessionCacheSize(defaultDbSessionCacheSize),
+  mdbReferenceCacheTtl(defaultDbReferenceCacheTtl),
+  mdbReferenceCacheSize(defaultDbReferenceCacheSize),
+  mdbArchiveAge(0),
+  mdbArchiveBatchSize(defaultDbArchiveBatchSize),
+  mdbSlowQueryThreshold(defaultDbSlowQueryThreshold),
   museSsl(false)
 {
 }
@@ -40,17 +63,61 @@ void DbConfiguration::check() throw (UserException)
     mdbType = DbConfiguration::POSTGRESQL;
   } else if (dbTypeStr == "mysql") {
     mdbType = DbConfiguration::MYSQL;
+  } else if (dbTypeStr == "sqlite") {
+    mdbType = DbConfiguration::SQLITE;
   } else {
-    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database type is invalid (must be 'oracle' or 'postgresql' or 'mysql')");
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database type is invalid (must be 'oracle' or 'postgresql' or 'mysql' or 'sqlite')");
   }
 
   // Common params
-  mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBHOST, mdbHost);
-  mexecConfig.getConfigValue<unsigned>(vishnu::DBPORT, mdbPort);
   mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBNAME, mdbName);
-  mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBUSERNAME, mdbUserName);
-  mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBPASSWORD, mdbPassword);
+  if (mdbType == DbConfiguration::SQLITE) {
+    // embedded, the name is the path of the database file
+    mexecConfig.getConfigValue<std::string>(vishnu::DBHOST, mdbHost);
+    mexecConfig.getConfigValue<std::string>(vishnu::DBUSERNAME, mdbUserName);
+    mexecConfig.getConfigValue<std::string>(vishnu::DBPASSWORD, mdbPassword);
+  } else {
+    mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBHOST, mdbHost);
+    mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBUSERNAME, mdbUserName);
+    mexecConfig.getRequiredConfigValue<std::string>(vishnu::DBPASSWORD, mdbPassword);
+  }
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBPORT, mdbPort);
   mexecConfig.getConfigValue<unsigned>(vishnu::DBPOOLSIZE, mdbPoolSize);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBPOOLTIMEOUT, mdbPoolTimeout);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBWRITEBEHINDINTERVAL, mdbWriteBehindInterval);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBWRITEBEHINDCAPACITY, mdbWriteBehindCapacity);
+  mexecConfig.getConfigValue<bool>(vishnu::DBSCHEMAUPGRADE, mdbSchemaUpgrade);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBIDBLOCKSIZE, mdbIdBlockSize);
+  mexecConfig.getConfigValues(vishnu::DBREPLICAHOSTS, mdbReplicaHosts);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBREPLICAMAXLAG, mdbReplicaMaxLag);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBSESSIONCACHETTL, mdbSessionCacheTtl);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBSESSIONCACHESIZE, mdbSessionCacheSize);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBREFERENCECACHETTL, mdbReferenceCacheTtl);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBREFERENCECACHESIZE, mdbReferenceCacheSize);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBARCHIVEAGE, mdbArchiveAge);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBARCHIVEBATCHSIZE, mdbArchiveBatchSize);
+  mexecConfig.getConfigValue<unsigned>(vishnu::DBSLOWQUERYTHRESHOLD, mdbSlowQueryThreshold);
+  if (mdbPoolSize == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database connections number is invalid (must be positive)");
+  }
+  if (mdbWriteBehindCapacity == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database write-behind capacity is invalid (must be positive)");
+  }
+  if (mdbIdBlockSize == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database id block size is invalid (must be positive)");
+  }
+  if (mdbSessionCacheSize == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database session cache size is invalid (must be positive)");
+  }
+  if (mdbReferenceCacheSize == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database reference cache size is invalid (must be positive)");
+  }
+  if (mdbArchiveBatchSize == 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database archive batch size is invalid (must be positive)");
+  }
+  if (mdbType == DbConfiguration::SQLITE && !mdbReplicaHosts.empty()) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Configuration for database replicas is invalid (not supported by sqlite)");
+  }
 
   // SSL params
   bool ret = mexecConfig.getConfigValue<bool>(vishnu::DB_USE_SSL, museSsl);
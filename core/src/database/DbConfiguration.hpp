@@ -8,6 +8,8 @@
 #ifndef _DBCONFIGURATION_HPP_
 #define _DBCONFIGURATION_HPP_
 
+#include <string>
+#include <vector>
 #include "ExecConfiguration.hpp"
 #include "UserException.hpp"
 
@@ -25,7 +27,8 @@ public:
   typedef enum {
     POSTGRESQL,
     ORACLE,
-    MYSQL
+    MYSQL,
+    SQLITE
   } db_type_t;
 
   /**
@@ -33,6 +36,56 @@ public:
    */
   static const unsigned defaultDbPoolSize;
 
+  /**
+   * \brief Default value for the time to wait for a free db connection
+   */
+  static const unsigned defaultDbPoolTimeout;
+
+  /**
+   * \brief Default value for the number of pending writes triggering a flush
+   */
+  static const unsigned defaultDbWriteBehindCapacity;
+
+  /**
+   * \brief Default value for the number of object counters reserved at once
+   */
+  static const unsigned defaultDbIdBlockSize;
+
+  /**
+   * \brief Default value for the staleness bound of the read replicas
+   */
+  static const unsigned defaultDbReplicaMaxLag;
+
+  /**
+   * \brief Default value for the lifetime of the validated sessions kept in memory
+   */
+  static const unsigned defaultDbSessionCacheTtl;
+
+  /**
+   * \brief Default value for the number of validated sessions kept in memory
+   */
+  static const unsigned defaultDbSessionCacheSize;
+
+  /**
+   * \brief Default value for the lifetime of the reference values kept in memory
+   */
+  static const unsigned defaultDbReferenceCacheTtl;
+
+  /**
+   * \brief Default value for the number of reference values kept in memory
+   */
+  static const unsigned defaultDbReferenceCacheSize;
+
+  /**
+   * \brief Default value for the number of rows of a table archived at once
+   */
+  static const unsigned defaultDbArchiveBatchSize;
+
+  /**
+   * \brief Default value for the time from which a request is logged
+   */
+  static const unsigned defaultDbSlowQueryThreshold;
+
   /**
    * \brief Constructor
    * \param execConfig  the configuration of the program
@@ -62,6 +115,13 @@ public:
    */
   unsigned getDbPort() const { return mdbPort; }
 
+  /**
+   * \brief Set the database host, e.g. to connect to a read replica
+   * \param host: database host
+   * \param port: database port, 0 for the default port
+   */
+  void setDbHost(const std::string& host, unsigned port) { mdbHost = host; mdbPort = port; }
+
   /**
    * \brief Get the database name
    * \return database name
@@ -93,6 +153,90 @@ public:
    */
   unsigned getDbPoolSize() { return mdbPoolSize; }
 
+  /**
+   * \brief Get the time to wait for a free connection of the pool
+   * \return timeout in seconds, 0 means to wait forever
+   */
+  unsigned getDbPoolTimeout() const { return mdbPoolTimeout; }
+
+  /**
+   * \brief Get the time between two flushes of the deferred writes
+   * \return interval in milliseconds, 0 means that writes are not deferred
+   */
+  unsigned getDbWriteBehindInterval() const { return mdbWriteBehindInterval; }
+
+  /**
+   * \brief Get the number of deferred writes triggering a flush
+   * \return the number of writes
+   */
+  unsigned getDbWriteBehindCapacity() const { return mdbWriteBehindCapacity; }
+
+  /**
+   * \brief Whether the schema must be upgraded at startup
+   * \return true to apply the missing migrations
+   */
+  bool getDbSchemaUpgrade() const { return mdbSchemaUpgrade; }
+
+  /**
+   * \brief Get the number of object counters reserved at once
+   * \return the size of a block
+   */
+  unsigned getDbIdBlockSize() const { return mdbIdBlockSize; }
+
+  /**
+   * \brief Get the read replicas of the database
+   * \return the replicas, as host or host:port
+   */
+  const std::vector<std::string>& getDbReplicaHosts() const { return mdbReplicaHosts; }
+
+  /**
+   * \brief Get the maximum replication lag of a replica that is read
+   * \return the lag in seconds
+   */
+  unsigned getDbReplicaMaxLag() const { return mdbReplicaMaxLag; }
+
+  /**
+   * \brief Get the lifetime of the validated sessions kept in memory
+   * \return the lifetime in seconds, 0 if they are not kept
+   */
+  unsigned getDbSessionCacheTtl() const { return mdbSessionCacheTtl; }
+
+  /**
+   * \brief Get the number of validated sessions kept in memory
+   * \return the number of sessions
+   */
+  unsigned getDbSessionCacheSize() const { return mdbSessionCacheSize; }
+
+  /**
+   * \brief Get the lifetime of the reference values kept in memory
+   * \return the lifetime in seconds, 0 if they are not kept
+   */
+  unsigned getDbReferenceCacheTtl() const { return mdbReferenceCacheTtl; }
+
+  /**
+   * \brief Get the number of reference values kept in memory
+   * \return the number of values
+   */
+  unsigned getDbReferenceCacheSize() const { return mdbReferenceCacheSize; }
+
+  /**
+   * \brief Get the age of the terminal rows moved to the archive tables
+   * \return the age in days, 0 if they are never moved
+   */
+  unsigned getDbArchiveAge() const { return mdbArchiveAge; }
+
+  /**
+   * \brief Get the number of rows of a table archived at once
+   * \return the number of rows
+   */
+  unsigned getDbArchiveBatchSize() const { return mdbArchiveBatchSize; }
+
+  /**
+   * \brief Get the time from which a request is logged as slow
+   * \return the time in milliseconds, 0 if none is logged
+   */
+  unsigned getDbSlowQueryThreshold() const { return mdbSlowQueryThreshold; }
+
   /**
    * \brief Gets the value of the property museSsl
    * \return the value of the property museSsl
@@ -151,6 +295,76 @@ protected:
    */
   unsigned mdbPoolSize;
 
+  /**
+   * \brief Attribute time to wait for a free db connection
+   */
+  unsigned mdbPoolTimeout;
+
+  /**
+   * \brief Attribute time between two flushes of the deferred writes
+   */
+  unsigned mdbWriteBehindInterval;
+
+  /**
+   * \brief Attribute number of deferred writes triggering a flush
+   */
+  unsigned mdbWriteBehindCapacity;
+
+  /**
+   * \brief Attribute whether the schema is upgraded at startup
+   */
+  bool mdbSchemaUpgrade;
+
+  /**
+   * \brief Attribute number of object counters reserved at once
+   */
+  unsigned mdbIdBlockSize;
+
+  /**
+   * \brief Attribute read replicas of the database
+   */
+  std::vector<std::string> mdbReplicaHosts;
+
+  /**
+   * \brief Attribute maximum replication lag of a replica that is read
+   */
+  unsigned mdbReplicaMaxLag;
+
+  /**
+   * \brief Attribute lifetime of the validated sessions kept in memory
+   */
+  unsigned mdbSessionCacheTtl;
+
+  /**
+   * \brief Attribute number of validated sessions kept in memory
+   */
+  unsigned mdbSessionCacheSize;
+
+  /**
+   * \brief Attribute lifetime of the reference values kept in memory
+   */
+  unsigned mdbReferenceCacheTtl;
+
+  /**
+   * \brief Attribute number of reference values kept in memory
+   */
+  unsigned mdbReferenceCacheSize;
+
+  /**
+   * \brief Attribute age in days of the terminal rows moved to the archive tables
+   */
+  unsigned mdbArchiveAge;
+
+  /**
+   * \brief Attribute number of rows of a table archived at once
+   */
+  unsigned mdbArchiveBatchSize;
+
+  /**
+   * \brief Attribute time in milliseconds from which a request is logged as slow
+   */
+  unsigned mdbSlowQueryThreshold;
+
   /**
    * \brief Sets whether to use SSL
    */
@@ -0,0 +1,90 @@
+/**
+ * \file DbConnectionPool.cpp
+ * \brief This file implements the pool of slots shared by the database connections
+ */
+#include "DbConnectionPool.hpp"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/thread_time.hpp>
+
+#include "SystemException.hpp"
+
+const unsigned DbConnectionPool::healthCheckInterval = 30;  //%RELAX<MISRA_0_1_3> Used in this file
+
+DbConnectionPool::DbConnectionPool(unsigned size, unsigned timeout)
+  : msize(size), mtimeout(timeout), mlastUsed(size, 0) {
+  // the first positions are pushed last so that they are served first
+  for (int i = static_cast<int>(size) - 1; i >= 0; --i) {
+    mfree.push_back(i);
+  }
+  mstats.size = size;
+  mstats.inUse = 0;
+  mstats.peakInUse = 0;
+  mstats.acquisitions = 0;
+  mstats.waits = 0;
+  mstats.timeouts = 0;
+  mstats.totalWaitUs = 0;
+  mstats.maxWaitUs = 0;
+}
+
+int
+DbConnectionPool::acquire() {
+  using boost::posix_time::ptime;
+  using boost::posix_time::microsec_clock;
+
+  boost::unique_lock<boost::mutex> lock(mmutex);
+  if (mfree.empty()) {
+    ptime start = microsec_clock::universal_time();
+    boost::system_time deadline = boost::get_system_time()
+      + boost::posix_time::seconds(mtimeout);
+    ++mstats.waits;
+    while (mfree.empty()) {
+      if (mtimeout == 0) {
+        mreleased.wait(lock);
+      } else if (!mreleased.timed_wait(lock, deadline) && mfree.empty()) {
+        ++mstats.timeouts;
+        throw SystemException(ERRCODE_DBCONN,
+                              "Timeout waiting for an available database connection");
+      }
+    }
+    boost::uint64_t waited = (microsec_clock::universal_time() - start).total_microseconds();
+    mstats.totalWaitUs += waited;
+    if (waited > mstats.maxWaitUs) {
+      mstats.maxWaitUs = waited;
+    }
+  }
+
+  int pos = mfree.back();
+  mfree.pop_back();
+  ++mstats.acquisitions;
+  ++mstats.inUse;
+  if (mstats.inUse > mstats.peakInUse) {
+    mstats.peakInUse = mstats.inUse;
+  }
+  return pos;
+}
+
+void
+DbConnectionPool::release(int pos) {
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mfree.push_back(pos);
+    mlastUsed[pos] = time(NULL);
+    --mstats.inUse;
+  }
+  mreleased.notify_one();
+}
+
+bool
+DbConnectionPool::needsCheck(int pos) const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mlastUsed[pos] != 0
+    && time(NULL) - mlastUsed[pos] >= static_cast<time_t>(healthCheckInterval);
+}
+
+DbConnectionPool::stats_t
+DbConnectionPool::getStats() const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mstats;
+}
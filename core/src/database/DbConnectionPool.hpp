@@ -0,0 +1,143 @@
+/**
+ * \file DbConnectionPool.hpp
+ * \brief This file defines the pool of slots shared by the database connections
+ */
+
+#ifndef _DBCONNECTIONPOOL_H_
+#define _DBCONNECTIONPOOL_H_
+
+#include <ctime>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * \class DbConnectionPool
+ * \brief Hands out the positions of the connections of a database backend.
+ * Callers wait on a condition variable until a position is released or the
+ * acquire timeout expires. The backend keeps the connection handles, indexed
+ * by position, and uses needsCheck() to lazily probe connections that stayed
+ * idle for a while.
+ */
+class DbConnectionPool : public boost::noncopyable {
+public:
+  /**
+   * \brief Usage metrics of the pool, to tune its size
+   */
+  typedef struct stats_t {
+    /**
+     * \brief The number of connections
+     */
+    unsigned size;
+    /**
+     * \brief The number of connections currently acquired
+     */
+    unsigned inUse;
+    /**
+     * \brief The highest number of connections acquired at once
+     */
+    unsigned peakInUse;
+    /**
+     * \brief The number of successful acquisitions
+     */
+    boost::uint64_t acquisitions;
+    /**
+     * \brief The number of acquisitions that had to wait for a release
+     */
+    boost::uint64_t waits;
+    /**
+     * \brief The number of acquisitions that timed out
+     */
+    boost::uint64_t timeouts;
+    /**
+     * \brief The cumulated waiting time, in microseconds
+     */
+    boost::uint64_t totalWaitUs;
+    /**
+     * \brief The longest waiting time, in microseconds
+     */
+    boost::uint64_t maxWaitUs;
+  } stats_t;
+
+  /**
+   * \brief Idle time after which a connection is probed before use, in seconds
+   */
+  static const unsigned healthCheckInterval;
+
+  /**
+   * \brief Constructor
+   * \param size the number of connections
+   * \param timeout the acquire timeout in seconds, 0 to wait forever
+   */
+  DbConnectionPool(unsigned size, unsigned timeout);
+
+  /**
+   * \brief Wait for a free connection
+   * \return the position of the connection, raises an exception on timeout
+   */
+  int
+  acquire();
+
+  /**
+   * \brief Release a connection
+   * \param pos the position of the connection
+   */
+  void
+  release(int pos);
+
+  /**
+   * \brief Whether a connection stayed idle long enough to be probed
+   * \param pos the position of an acquired connection
+   * \return true if the connection must be checked before use
+   */
+  bool
+  needsCheck(int pos) const;
+
+  /**
+   * \brief Get the usage metrics
+   * \return a snapshot of the metrics
+   */
+  stats_t
+  getStats() const;
+
+  /**
+   * \brief Get the number of connections
+   * \return the number of connections
+   */
+  unsigned
+  getSize() const { return msize; }
+
+private:
+  /**
+   * \brief The number of connections
+   */
+  unsigned msize;
+  /**
+   * \brief The acquire timeout in seconds, 0 to wait forever
+   */
+  unsigned mtimeout;
+  /**
+   * \brief The free positions, the last released is reused first
+   */
+  std::vector<int> mfree;
+  /**
+   * \brief The last release date of each position
+   */
+  std::vector<time_t> mlastUsed;
+  /**
+   * \brief The metrics
+   */
+  stats_t mstats;
+  /**
+   * \brief mutex protecting the pool
+   */
+  mutable boost::mutex mmutex;
+  /**
+   * \brief condition signaled on release
+   */
+  boost::condition_variable mreleased;
+};
+
+#endif // _DBCONNECTIONPOOL_H_
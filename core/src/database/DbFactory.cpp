@@ -8,14 +8,25 @@
 #include "DbFactory.hpp"
 
 #include "SystemException.hpp"
+#include "utilVishnu.hpp"
 #ifdef USE_POSTGRES
 #include "POSTGREDatabase.hpp"
 #endif
 #ifdef USE_MYSQL
 #include "MYSQLDatabase.hpp"
 #endif
+#ifdef USE_SQLITE
+#include "SQLITEDatabase.hpp"
+#endif
 
 Database* DbFactory::mdb = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbWriteBehind* DbFactory::mwriteBehind = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbIdAllocator* DbFactory::midAllocator = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbReplicaRouter* DbFactory::mreplicaRouter = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbSessionCache* DbFactory::msessionCache = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbReferenceCache* DbFactory::mreferenceCache = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbArchiver* DbFactory::marchiver = NULL; //%RELAX<MISRA_0_1_3> Used in this file
+DbProfiler* DbFactory::mprofiler = NULL; //%RELAX<MISRA_0_1_3> Used in this file
 
 DbFactory::DbFactory(){
 }
@@ -29,27 +40,75 @@ DbFactory::createDatabaseInstance(DbConfiguration config)
   if (mdb != NULL) {
     throw SystemException(ERRCODE_DBERR, "Database instance already initialized");
   }
+  mprofiler = new DbProfiler(config.getDbSlowQueryThreshold());
+  mdb = createBackend(config);
+  if (config.getDbWriteBehindInterval() != 0) {
+    mwriteBehind = new DbWriteBehind(mdb, config.getDbWriteBehindInterval(),
+                                     config.getDbWriteBehindCapacity());
+  }
+  midAllocator = new DbIdAllocator(mdb, config.getDbIdBlockSize());
+  msessionCache = new DbSessionCache(mdb, config.getDbSessionCacheTtl(),
+                                     config.getDbSessionCacheSize());
+  mreferenceCache = new DbReferenceCache(mdb, config.getDbReferenceCacheTtl(),
+                                         config.getDbReferenceCacheSize());
+  if (config.getDbArchiveAge() != 0) {
+    marchiver = new DbArchiver(mdb, config.getDbArchiveAge(), config.getDbArchiveBatchSize());
+  }
+
+  std::vector<Database*> replicas;
+  std::vector<std::string>::const_iterator host;
+  for (host = config.getDbReplicaHosts().begin(); host != config.getDbReplicaHosts().end(); ++host) {
+    if (host->empty()) {
+      continue;
+    }
+    DbConfiguration replica(config);
+    std::string::size_type colon = host->find(':');
+    if (colon == std::string::npos) {
+      replica.setDbHost(*host, config.getDbPort());
+    } else {
+      replica.setDbHost(host->substr(0, colon), vishnu::convertToInt(host->substr(colon + 1)));
+    }
+    replicas.push_back(createBackend(replica));
+  }
+  if (!replicas.empty()) {
+    mreplicaRouter = new DbReplicaRouter(mdb, replicas, config.getDbReplicaMaxLag());
+  }
+  return mdb;
+}
+
+Database*
+DbFactory::createBackend(DbConfiguration config)
+{
+  Database* database = NULL;
   switch (config.getDbType()){
   case DbConfiguration::POSTGRESQL :
 #ifdef USE_POSTGRES
-    mdb = new POSTGREDatabase(config);
+    database = new POSTGREDatabase(config);
+    break;
 #else
     throw SystemException(ERRCODE_DBERR, "PostgreSQL is not enabled (re-compile with ENABLE_POSTGRES)");
 #endif
-    break;
   case DbConfiguration::MYSQL:
 #ifdef USE_MYSQL
-    mdb = new MYSQLDatabase(config);
+    database = new MYSQLDatabase(config);
+    break;
 #else
     throw SystemException(ERRCODE_DBERR, "MySQL is not enabled (re-compile with ENABLE_MYSQL)");
 #endif
+  case DbConfiguration::SQLITE:
+#ifdef USE_SQLITE
+    database = new SQLITEDatabase(config);
     break;
+#else
+    throw SystemException(ERRCODE_DBERR, "SQLite is not enabled (re-compile with ENABLE_SQLITE)");
+#endif
   case DbConfiguration::ORACLE:
     // Intentional fallthrough, Oracle is not managed
   default:
     throw SystemException(ERRCODE_DBERR, "Database instance type unknown or not managed");
   }
-  return mdb;
+  database->setProfiler(mprofiler);
+  return database;
 }
 
 Database* DbFactory::getDatabaseInstance()
@@ -59,3 +118,52 @@ Database* DbFactory::getDatabaseInstance()
   }
   return mdb;
 }
+
+DbWriteBehind* DbFactory::getWriteBehindInstance()
+{
+  return mwriteBehind;
+}
+
+void DbFactory::closeWriteBehindInstance()
+{
+  delete mwriteBehind;
+  mwriteBehind = NULL;
+}
+
+DbIdAllocator* DbFactory::getIdAllocatorInstance()
+{
+  return midAllocator;
+}
+
+Database* DbFactory::getReadDatabaseInstance(const std::string& sessionKey)
+{
+  if (mreplicaRouter == NULL) {
+    return getDatabaseInstance();
+  }
+  return mreplicaRouter->getDatabase(sessionKey);
+}
+
+DbReplicaRouter* DbFactory::getReplicaRouterInstance()
+{
+  return mreplicaRouter;
+}
+
+DbSessionCache* DbFactory::getSessionCacheInstance()
+{
+  return msessionCache;
+}
+
+DbReferenceCache* DbFactory::getReferenceCacheInstance()
+{
+  return mreferenceCache;
+}
+
+DbArchiver* DbFactory::getArchiverInstance()
+{
+  return marchiver;
+}
+
+DbProfiler* DbFactory::getProfilerInstance()
+{
+  return mprofiler;
+}
@@ -9,7 +9,14 @@
 #define _DBFACTORY_H_
 
 #include "Database.hpp"
+#include "DbArchiver.hpp"
 #include "DbConfiguration.hpp"
+#include "DbIdAllocator.hpp"
+#include "DbProfiler.hpp"
+#include "DbReferenceCache.hpp"
+#include "DbReplicaRouter.hpp"
+#include "DbSessionCache.hpp"
+#include "DbWriteBehind.hpp"
 
 
 /**
@@ -42,11 +49,111 @@ public :
   Database*
   getDatabaseInstance();
 
+  /**
+   * \brief Get the queue of the deferred writes of the database
+   * \return the queue or a nil pointer if writes must not be deferred
+   */
+  DbWriteBehind*
+  getWriteBehindInstance();
+
+  /**
+   * \brief Commit the deferred writes and destroy their queue, to be called
+   * before the database is closed
+   */
+  void
+  closeWriteBehindInstance();
+
+  /**
+   * \brief Get the allocator of the object counters
+   * \return the allocator or a nil pointer if the database is not created
+   */
+  DbIdAllocator*
+  getIdAllocatorInstance();
+
+  /**
+   * \brief Get the database to run a read-only request on
+   * \param sessionKey the key of the session reading, empty if none
+   * \return a read replica or the single instance of the database
+   */
+  Database*
+  getReadDatabaseInstance(const std::string& sessionKey);
+
+  /**
+   * \brief Get the router of the reads to the replicas
+   * \return the router or a nil pointer if there is no replica
+   */
+  DbReplicaRouter*
+  getReplicaRouterInstance();
+
+  /**
+   * \brief Get the cache of the validated sessions
+   * \return the cache or a nil pointer if the database is not created
+   */
+  DbSessionCache*
+  getSessionCacheInstance();
+
+  /**
+   * \brief Get the cache of the reference tables
+   * \return the cache or a nil pointer if the database is not created
+   */
+  DbReferenceCache*
+  getReferenceCacheInstance();
+
+  /**
+   * \brief Get the archiver of the history tables
+   * \return the archiver or a nil pointer if the rows are not archived
+   */
+  DbArchiver*
+  getArchiverInstance();
+
+  /**
+   * \brief Get the statistics of the requests of the database
+   * \return the statistics or a nil pointer if the database is not created
+   */
+  DbProfiler*
+  getProfilerInstance();
+
 private :
   /**
    * \brief The unique instance of the database
    */
   static Database* mdb;
+  /**
+   * \brief The queue of the deferred writes, nil if writes are not deferred
+   */
+  static DbWriteBehind* mwriteBehind;
+  /**
+   * \brief The allocator of the object counters
+   */
+  static DbIdAllocator* midAllocator;
+  /**
+   * \brief The router of the reads, nil if there is no replica
+   */
+  static DbReplicaRouter* mreplicaRouter;
+  /**
+   * \brief The cache of the validated sessions
+   */
+  static DbSessionCache* msessionCache;
+  /**
+   * \brief The cache of the reference tables
+   */
+  static DbReferenceCache* mreferenceCache;
+  /**
+   * \brief The archiver of the history tables, nil if the rows are not archived
+   */
+  static DbArchiver* marchiver;
+  /**
+   * \brief The statistics of the requests of the database and its replicas
+   */
+  static DbProfiler* mprofiler;
+
+  /**
+   * \brief Create a database of the configured type
+   * \param config the configuration of the database
+   * \return the database, not connected
+   */
+  static Database*
+  createBackend(DbConfiguration config);
 };
 
 
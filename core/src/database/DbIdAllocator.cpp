@@ -0,0 +1,95 @@
+/**
+ * \file DbIdAllocator.cpp
+ * \brief This file implements the allocator of the object counters
+ */
+#include "DbIdAllocator.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "Database.hpp"
+#include "DbTransaction.hpp"
+#include "SystemException.hpp"
+
+namespace {
+  /**
+   * \brief Whether an error of the database tells that the table of the
+   * counters does not exist
+   * \param error the error
+   * \return true if the table is missing
+   */
+  bool
+  isMissingTable(const std::string& error) {
+    // as worded by PostgreSQL, MySQL and SQLite
+    return error.find("vishnu_idblock") != std::string::npos
+      && (error.find("does not exist") != std::string::npos
+          || error.find("doesn't exist") != std::string::npos
+          || error.find("no such table") != std::string::npos);
+  }
+}
+
+DbIdAllocator::DbIdAllocator(Database* database, unsigned blockSize)
+  : mdatabase(database), mblockSize(blockSize) {
+}
+
+bool
+DbIdAllocator::next(int type, int& counter) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (munavailable.find(type) != munavailable.end()) {
+    return false;
+  }
+  std::map<int, block_t>::iterator it = mblocks.find(type);
+  if (it == mblocks.end() || it->second.next >= it->second.end) {
+    block_t block;
+    try {
+      if (!reserve(type, block)) {
+        // the schema has not been upgraded, stop asking
+        std::cerr << boost::format("[WARN] No counter of object type %1% in table vishnu_idblock,"
+                                   " they will be generated one by one\n") % type;
+        munavailable.insert(type);
+        return false;
+      }
+    } catch (VishnuException& ex) {
+      if (isMissingTable(ex.what())) {
+        std::cerr << boost::format("[WARN] Cannot reserve counters of object type %1%,"
+                                   " they will be generated one by one: %2%\n")
+          % type % ex.what();
+        munavailable.insert(type);
+      } else if (mfailing.insert(type).second) {
+        // e.g. a lost connection or a deadlock, asked again at the next call
+        std::cerr << boost::format("[WARN] Cannot reserve counters of object type %1%,"
+                                   " they are generated one by one meanwhile: %2%\n")
+          % type % ex.what();
+      }
+      return false;
+    }
+    mfailing.erase(type);
+    mblocks[type] = block;
+    it = mblocks.find(type);
+  }
+  counter = it->second.next++;
+  return true;
+}
+
+bool
+DbIdAllocator::reserve(int type, block_t& block) {
+  DbTransaction transaction(mdatabase);
+  // a SQLite transaction already holds the write lock of the database
+  const char* lock = (mdatabase->getDbType() == DbConfiguration::SQLITE) ? "" : " FOR UPDATE";
+  boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(boost::str(
+      boost::format("SELECT nextid FROM vishnu_idblock WHERE idtype=%1%%2%") % type % lock),
+      transaction.getId()));
+  if (result->getNbTuples() == 0) {
+    return false;
+  }
+  block.next = atoi(result->getFirstElement().c_str());
+  block.end = block.next + static_cast<int>(mblockSize);
+  mdatabase->process(boost::str(
+      boost::format("UPDATE vishnu_idblock SET nextid=%1% WHERE idtype=%2%") % block.end % type),
+      transaction.getId());
+  transaction.commit();
+  return true;
+}
@@ -0,0 +1,96 @@
+/**
+ * \file DbIdAllocator.hpp
+ * \brief This file defines the allocator of the object counters
+ */
+
+#ifndef _DBIDALLOCATOR_H_
+#define _DBIDALLOCATOR_H_
+
+#include <map>
+#include <set>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+class Database;
+
+/**
+ * \class DbIdAllocator
+ * \brief Hands out the counters used to generate the object identifiers.
+ * The next free counter of each object type is stored in the table
+ * vishnu_idblock. A process reserves a block of counters in one transaction
+ * and then hands them out from memory until the block is exhausted, so
+ * concurrent servers never get the same counter. Counters that are reserved
+ * but not handed out are lost when the process stops.
+ */
+class DbIdAllocator : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor
+   * \param database the database storing the counters
+   * \param blockSize the number of counters reserved at once
+   */
+  DbIdAllocator(Database* database, unsigned blockSize);
+
+  /**
+   * \brief Get the next counter of a type of object
+   * \param type the type of object (vishnu::IdType)
+   * \param counter the counter, set on success
+   * \return false if the database stores no counter for the type or if
+   * it cannot be read, the caller must then generate the counter itself.
+   * A type without counter is not asked for again, the other errors are
+   * retried at the next call
+   */
+  bool
+  next(int type, int& counter);
+
+private:
+  /**
+   * \brief The counters reserved for a type of object
+   */
+  typedef struct block_t {
+    /**
+     * \brief The next counter to hand out
+     */
+    int next;
+    /**
+     * \brief The first counter after the block
+     */
+    int end;
+  } block_t;
+
+  /**
+   * \brief Reserve a new block of counters
+   * \param type the type of object
+   * \param block the block to fill
+   * \return false if the database stores no counter for the type
+   */
+  bool
+  reserve(int type, block_t& block);
+
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+  /**
+   * \brief The number of counters reserved at once
+   */
+  unsigned mblockSize;
+  /**
+   * \brief The blocks by type of object
+   */
+  std::map<int, block_t> mblocks;
+  /**
+   * \brief The types of object without counter in the database
+   */
+  std::set<int> munavailable;
+  /**
+   * \brief The types of object whose last reservation failed, warned once
+   */
+  std::set<int> mfailing;
+  /**
+   * \brief mutex protecting the blocks
+   */
+  boost::mutex mmutex;
+};
+
+#endif // _DBIDALLOCATOR_H_
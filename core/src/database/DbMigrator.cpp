@@ -0,0 +1,220 @@
+/**
+ * \file DbMigrator.cpp
+ * \brief This file implements the upgrade of the database schema
+ */
+#include "DbMigrator.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "DbTransaction.hpp"
+#include "SystemException.hpp"
+
+namespace {
+  /**
+   * \brief Migration 1, PostgreSQL does not index the foreign keys
+   */
+  const char* const postgresqlIndexes[] = {
+    "CREATE INDEX vsession_sessionkey_idx ON vsession (sessionkey)",
+    "CREATE INDEX users_userid_idx ON users (userid)",
+    "CREATE INDEX job_jobid_idx ON job (jobid)",
+    "CREATE INDEX job_submitmachineid_status_idx ON job (submitmachineid, status)",
+    "CREATE INDEX job_vsession_idx ON job (vsession_numsessionid)",
+    "CREATE INDEX command_vsession_idx ON command (vsession_numsessionid)",
+    "CREATE INDEX filetransfer_transferid_idx ON filetransfer (transferid)",
+    "CREATE INDEX filetransfer_status_idx ON filetransfer (status)",
+    "CREATE INDEX filetransfer_vsession_idx ON filetransfer (vsession_numsessionid)",
+    NULL
+  };
+
+  /**
+   * \brief Migration 1, InnoDB already indexes the foreign keys
+   */
+  const char* const mysqlIndexes[] = {
+    "CREATE INDEX vsession_sessionkey_idx ON vsession (sessionkey)",
+    "CREATE INDEX users_userid_idx ON users (userid)",
+    "CREATE INDEX job_jobid_idx ON job (jobId)",
+    "CREATE INDEX job_submitmachineid_status_idx ON job (submitMachineId, status)",
+    "CREATE INDEX filetransfer_transferid_idx ON filetransfer (transferId)",
+    "CREATE INDEX filetransfer_status_idx ON filetransfer (status)",
+    NULL
+  };
+
+  /**
+   * \brief Migration 2, the counters start after the existing objects,
+   * idtype is a vishnu::IdType
+   */
+  const char* const idBlocks[] = {
+    "CREATE TABLE vishnu_idblock ("
+    " idtype INTEGER NOT NULL PRIMARY KEY,"
+    " nextid BIGINT NOT NULL)",
+    "INSERT INTO vishnu_idblock (idtype, nextid) SELECT 2, COALESCE(MAX(numjobid), 0) + 1 FROM job",
+    "INSERT INTO vishnu_idblock (idtype, nextid)"
+    " SELECT 3, COALESCE(MAX(numfiletransferid), 0) + 1 FROM filetransfer",
+    "INSERT INTO vishnu_idblock (idtype, nextid)"
+    " SELECT 4, COALESCE(MAX(numauthsystemid), 0) + 1 FROM authsystem",
+    "INSERT INTO vishnu_idblock (idtype, nextid) SELECT 5, COALESCE(MAX(id), 0) + 1 FROM work",
+    NULL
+  };
+
+  /**
+   * \brief Migration 3, a single row counting the changes of the sessions
+   */
+  const char* const authVersion[] = {
+    "CREATE TABLE vishnu_authversion (version BIGINT NOT NULL)",
+    "INSERT INTO vishnu_authversion (version) VALUES (0)",
+    NULL
+  };
+
+  /**
+   * \brief Migration 4, the count of the changes of each reference table
+   */
+  const char* const refVersion[] = {
+    "CREATE TABLE vishnu_refversion (tablename VARCHAR(255) NOT NULL PRIMARY KEY, version BIGINT NOT NULL)",
+    "INSERT INTO vishnu_refversion (tablename, version) VALUES ('users', 0)",
+    "INSERT INTO vishnu_refversion (tablename, version) VALUES ('machine', 0)",
+    "INSERT INTO vishnu_refversion (tablename, version) VALUES ('account', 0)",
+    "INSERT INTO vishnu_refversion (tablename, version) VALUES ('authsystem', 0)",
+    NULL
+  };
+
+  /**
+   * \brief Migration 5, the archive of each history table with the view
+   * joining both, the indexes selecting the rows to archive
+   */
+  const char* const archives[] = {
+    "CREATE TABLE job_archive AS SELECT * FROM job WHERE 1=0",
+    "CREATE TABLE command_archive AS SELECT * FROM command WHERE 1=0",
+    "CREATE TABLE filetransfer_archive AS SELECT * FROM filetransfer WHERE 1=0",
+    "CREATE TABLE vsession_archive AS SELECT * FROM vsession WHERE 1=0",
+    "CREATE INDEX job_archive_jobid_idx ON job_archive (jobid)",
+    "CREATE INDEX job_archive_vsession_idx ON job_archive (vsession_numsessionid)",
+    "CREATE INDEX command_archive_vsession_idx ON command_archive (vsession_numsessionid)",
+    "CREATE INDEX filetransfer_archive_transferid_idx ON filetransfer_archive (transferid)",
+    "CREATE INDEX vsession_archive_numsessionid_idx ON vsession_archive (numsessionid)",
+    "CREATE INDEX vsession_archive_vsessionid_idx ON vsession_archive (vsessionid)",
+    "CREATE INDEX job_status_enddate_idx ON job (status, enddate)",
+    "CREATE INDEX command_endtime_idx ON command (endtime)",
+    "CREATE INDEX vsession_state_closure_idx ON vsession (state, closure)",
+    "CREATE VIEW job_history AS SELECT * FROM job UNION ALL SELECT * FROM job_archive",
+    "CREATE VIEW command_history AS SELECT * FROM command UNION ALL SELECT * FROM command_archive",
+    "CREATE VIEW filetransfer_history AS SELECT * FROM filetransfer UNION ALL SELECT * FROM filetransfer_archive",
+    "CREATE VIEW vsession_history AS SELECT * FROM vsession UNION ALL SELECT * FROM vsession_archive",
+    NULL
+  };
+}
+
+const DbMigrator::migration_t DbMigrator::migrations[] = {  //%RELAX<MISRA_0_1_3> Used in this file
+  {1, "Secondary indexes of the session, job, command and transfer lookups",
+   postgresqlIndexes, mysqlIndexes},
+  {2, "Counters of the job, transfer, authentication system and work identifiers",
+   idBlocks, idBlocks},
+  {3, "Count of the changes invalidating the cached sessions",
+   authVersion, authVersion},
+  {4, "Counts of the changes invalidating the cached reference tables",
+   refVersion, refVersion},
+  {5, "Archive tables of the jobs, commands, file transfers and sessions",
+   archives, archives},
+  {0, NULL, NULL, NULL}
+};
+
+DbMigrator::DbMigrator(Database* database)
+  : mdatabase(database) {
+}
+
+int
+DbMigrator::upgrade() {
+  mdatabase->process("CREATE TABLE IF NOT EXISTS vishnu_schema_version ("
+                     " version INTEGER NOT NULL,"
+                     " description VARCHAR(255),"
+                     " applied TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+
+  DbTransaction transaction(mdatabase);
+  lock(transaction.getId());
+  int version;
+  try {
+    // read under the lock, another server may have upgraded meanwhile
+    version = getVersion(transaction.getId());
+    for (const migration_t* migration = migrations; migration->version != 0; ++migration) {
+      if (migration->version <= version) {
+        continue;
+      }
+      const char* const* statement = (mdatabase->getDbType() == DbConfiguration::MYSQL)
+        ? migration->mysql : migration->postgresql;
+      std::vector<std::string> requests;
+      for (; *statement != NULL; ++statement) {
+        requests.push_back(*statement);
+      }
+      requests.push_back(boost::str(
+          boost::format("INSERT INTO vishnu_schema_version (version, description) VALUES (%1%, '%2%')")
+          % migration->version
+          % mdatabase->escapeData(migration->description)));
+      mdatabase->processBatch(requests, transaction.getId());
+      version = migration->version;
+      std::cerr << boost::format("[INFO] Database schema upgraded to version %1%: %2%\n")
+        % version % migration->description;
+    }
+    unlock(transaction.getId());
+  } catch (...) {
+    try {
+      unlock(transaction.getId());
+    } catch (...) {
+      // the rollback closes the upgrade anyway
+    }
+    throw;
+  }
+  transaction.commit();
+  return version;
+}
+
+int
+DbMigrator::getVersion(int transacId) {
+  boost::scoped_ptr<DatabaseResult> result(
+      mdatabase->getResult("SELECT MAX(version) FROM vishnu_schema_version", transacId));
+  // MAX() of an empty table is NULL
+  return atoi(result->getFirstElement().c_str());
+}
+
+int
+DbMigrator::getLatestVersion() {
+  int version = 0;
+  for (const migration_t* migration = migrations; migration->version != 0; ++migration) {
+    version = migration->version;
+  }
+  return version;
+}
+
+void
+DbMigrator::lock(int transacId) {
+  switch (mdatabase->getDbType()) {
+  case DbConfiguration::MYSQL: {
+    // DDL statements commit the transaction, a table lock would not last
+    boost::scoped_ptr<DatabaseResult> result(
+        mdatabase->getResult("SELECT GET_LOCK('vishnu_schema_version', 60)", transacId));
+    if (result->getFirstElement() != "1") {
+      throw SystemException(ERRCODE_DBERR, "Timeout waiting for the upgrade of the database schema");
+    }
+    break;
+  }
+  case DbConfiguration::POSTGRESQL:
+    mdatabase->process("LOCK TABLE vishnu_schema_version IN EXCLUSIVE MODE", transacId);
+    break;
+  case DbConfiguration::SQLITE:
+    // Intentional fallthrough, the transaction holds the write lock
+  default:
+    break;
+  }
+}
+
+void
+DbMigrator::unlock(int transacId) {
+  // PostgreSQL releases the table lock at the end of the transaction
+  if (mdatabase->getDbType() == DbConfiguration::MYSQL) {
+    boost::scoped_ptr<DatabaseResult> result(
+        mdatabase->getResult("SELECT RELEASE_LOCK('vishnu_schema_version')", transacId));
+  }
+}
@@ -0,0 +1,97 @@
+/**
+ * \file DbMigrator.hpp
+ * \brief This file defines the upgrade of the database schema
+ */
+
+#ifndef _DBMIGRATOR_H_
+#define _DBMIGRATOR_H_
+
+#include "Database.hpp"
+
+/**
+ * \class DbMigrator
+ * \brief Brings the schema of the database up to date at startup.
+ * The version of the schema is recorded in the vishnu_schema_version table,
+ * one row per applied migration. The migrations are ordered, each one is
+ * applied once, with its version row, in a single batch. Concurrent servers
+ * are serialized by a lock held until the end of the upgrade.
+ */
+class DbMigrator {
+public:
+  /**
+   * \brief Constructor
+   * \param database the database to upgrade
+   */
+  explicit DbMigrator(Database* database);
+
+  /**
+   * \brief Apply the migrations that are missing
+   * \return the version of the schema, raises an exception on error
+   */
+  int
+  upgrade();
+
+  /**
+   * \brief Get the version of the schema
+   * \param transacId the id of the transaction if one is used
+   * \return the last applied migration, 0 if none
+   */
+  int
+  getVersion(int transacId = -1);
+
+  /**
+   * \brief Get the version reached once every migration is applied
+   * \return the version of the last migration
+   */
+  static int
+  getLatestVersion();
+
+private:
+  /**
+   * \brief A step of the schema history
+   */
+  typedef struct migration_t {
+    /**
+     * \brief The version reached once the migration is applied
+     */
+    int version;
+    /**
+     * \brief What the migration does
+     */
+    const char* description;
+    /**
+     * \brief The statements for PostgreSQL and SQLite, NULL terminated
+     */
+    const char* const* postgresql;
+    /**
+     * \brief The statements for MySQL, NULL terminated
+     */
+    const char* const* mysql;
+  } migration_t;
+
+  /**
+   * \brief The migrations by increasing version, terminated by version 0
+   */
+  static const migration_t migrations[];
+
+  /**
+   * \brief Serialize the upgrades of concurrent servers
+   * \param transacId the id of the transaction of the upgrade
+   */
+  void
+  lock(int transacId);
+
+  /**
+   * \brief Release the lock taken by lock()
+   * \param transacId the id of the transaction of the upgrade
+   */
+  void
+  unlock(int transacId);
+
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+};
+
+#endif // _DBMIGRATOR_H_
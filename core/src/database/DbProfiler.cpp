@@ -0,0 +1,209 @@
+/**
+ * \file DbProfiler.cpp
+ * \brief This file implements the statistics of the database requests
+ */
+#include "DbProfiler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <iostream>
+#include <boost/thread/locks.hpp>
+
+const size_t DbProfiler::maxTemplates = 1000;  //%RELAX<MISRA_0_1_3> Used in this file
+const size_t DbProfiler::maxTemplateLength = 1000;  //%RELAX<MISRA_0_1_3> Used in this file
+
+boost::thread_specific_ptr<std::string> DbProfiler::mcontext;  //%RELAX<MISRA_0_1_3> Used in this file
+
+namespace {
+  /**
+   * \brief Append a value to a template, a list of values counts as one
+   * \param result the template
+   */
+  void
+  appendValue(std::string& result) {
+    std::string::size_type comma = result.find_last_not_of(' ');
+    if (comma != std::string::npos && comma > 0 && result[comma] == ',') {
+      std::string::size_type value = result.find_last_not_of(' ', comma - 1);
+      if (value != std::string::npos && result[value] == '?') {
+        result.erase(value + 1);
+        return;
+      }
+    }
+    result += '?';
+  }
+
+  /**
+   * \brief Whether a character may be part of a name
+   * \param c the character
+   * \return true if it is a letter, a digit or an underscore
+   */
+  bool
+  isNameChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+  }
+
+  /**
+   * \brief Order the statistics by cumulated time
+   * \param first the first statistics
+   * \param second the second statistics
+   * \return true if the first took longer
+   */
+  bool
+  longerThan(const DbProfiler::stats_t& first, const DbProfiler::stats_t& second) {
+    return first.totalUs > second.totalUs;
+  }
+}
+
+DbProfiler::Timer::Timer(DbProfiler* profiler, const std::string& request)
+  : mprofiler(profiler), mrequest(request) {
+  if (mprofiler != NULL) {
+    mstart = boost::posix_time::microsec_clock::universal_time();
+  }
+}
+
+DbProfiler::Timer::~Timer() {
+  if (mprofiler == NULL) {
+    return;
+  }
+  boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - mstart;
+  try {
+    mprofiler->record(mrequest, elapsed.total_microseconds(), std::uncaught_exception());
+  } catch (...) {
+    // the statistics must not hide the result of the request
+  }
+}
+
+DbProfiler::Context::Context(const std::string& name)
+  : mprevious(getContext()) {
+  mcontext.reset(new std::string(name));
+}
+
+DbProfiler::Context::~Context() {
+  if (mprevious.empty()) {
+    mcontext.reset();
+  } else {
+    mcontext.reset(new std::string(mprevious));
+  }
+}
+
+DbProfiler::DbProfiler(unsigned slowThreshold)
+  : mslowThreshold(slowThreshold), mbackslashEscapes(false) {
+}
+
+void
+DbProfiler::record(const std::string& request, boost::uint64_t elapsedUs, bool failed) {
+  bool backslashEscapes;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    backslashEscapes = mbackslashEscapes;
+  }
+  std::string key = getTemplate(request, backslashEscapes);
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::map<std::string, stats_t>::iterator it = mstats.find(key);
+    if (it == mstats.end()) {
+      if (mstats.size() >= maxTemplates) {
+        // the requests built from user data, counted together
+        key = "(other)";
+        it = mstats.find(key);
+      }
+      if (it == mstats.end()) {
+        stats_t stats = stats_t();
+        stats.request = key;
+        it = mstats.insert(std::make_pair(key, stats)).first;
+      }
+    }
+    ++it->second.count;
+    if (failed) {
+      ++it->second.errors;
+    }
+    it->second.totalUs += elapsedUs;
+    it->second.maxUs = std::max(it->second.maxUs, elapsedUs);
+  }
+
+  // the template only, the values may be secrets
+  if (mslowThreshold != 0 && elapsedUs >= static_cast<boost::uint64_t>(mslowThreshold) * 1000) {
+    std::string context = getContext();
+    std::cerr << "[WARN] Slow database request (" << elapsedUs / 1000 << " ms"
+              << (context.empty() ? "" : ", in " + context) << "): " << key << "\n";
+  }
+}
+
+void
+DbProfiler::setBackslashEscapes(bool backslashEscapes) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mbackslashEscapes = backslashEscapes;
+}
+
+std::vector<DbProfiler::stats_t>
+DbProfiler::getStats() const {
+  std::vector<stats_t> stats;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    stats.reserve(mstats.size());
+    std::map<std::string, stats_t>::const_iterator it;
+    for (it = mstats.begin(); it != mstats.end(); ++it) {
+      stats.push_back(it->second);
+    }
+  }
+  std::sort(stats.begin(), stats.end(), longerThan);
+  return stats;
+}
+
+std::string
+DbProfiler::getTemplate(const std::string& request, bool backslashEscapes) {
+  std::string result;
+  result.reserve(std::min(request.size(), maxTemplateLength));
+  std::string::size_type pos = 0;
+  while (pos < request.size() && result.size() < maxTemplateLength) {
+    char c = request[pos];
+    bool number = isdigit(static_cast<unsigned char>(c)) && (pos == 0 || !isNameChar(request[pos - 1]));
+    // $1 for the parameters, %1% for the VR_* requests
+    bool param = (c == '$' || c == '%') && pos + 1 < request.size()
+                 && isdigit(static_cast<unsigned char>(request[pos + 1]));
+    if (c == '\'') {
+      // the quotes are doubled in a string, or escaped by a backslash if
+      // the backend reads it so
+      ++pos;
+      while (pos < request.size()) {
+        if (backslashEscapes && request[pos] == '\\') {
+          pos += 2;
+        } else if (request[pos] == '\'' && pos + 1 < request.size() && request[pos + 1] == '\'') {
+          pos += 2;
+        } else if (request[pos++] == '\'') {
+          break;
+        }
+      }
+      appendValue(result);
+    } else if (number || param) {
+      ++pos;
+      while (pos < request.size() && (isNameChar(request[pos]) || request[pos] == '.')) {
+        ++pos;
+      }
+      if (c == '%' && pos < request.size() && request[pos] == '%') {
+        ++pos;
+      }
+      appendValue(result);
+    } else if (isspace(static_cast<unsigned char>(c))) {
+      while (pos < request.size() && isspace(static_cast<unsigned char>(request[pos]))) {
+        ++pos;
+      }
+      result += ' ';
+    } else {
+      result += c;
+      ++pos;
+    }
+  }
+  std::string::size_type end = result.find_last_not_of("; ");
+  result.erase(end == std::string::npos ? 0 : end + 1);
+  std::string::size_type start = result.find_first_not_of(' ');
+  return result.substr(start == std::string::npos ? result.size() : start);
+}
+
+std::string
+DbProfiler::getContext() {
+  std::string* context = mcontext.get();
+  return (context == NULL) ? "" : *context;
+}
@@ -0,0 +1,198 @@
+/**
+ * \file DbProfiler.hpp
+ * \brief This file defines the statistics of the database requests
+ */
+
+#ifndef _DBPROFILER_H_
+#define _DBPROFILER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+/**
+ * \class DbProfiler
+ * \brief Times the requests of the database and aggregates them by
+ * template, the request whose literals are replaced by '?', so that the
+ * requests built from the same VR_* request or the same code share their
+ * statistics. The requests slower than a threshold are logged with their
+ * template and the service being called.
+ */
+class DbProfiler : public boost::noncopyable {
+public:
+  /**
+   * \brief The statistics of a template
+   */
+  typedef struct stats_t {
+    /**
+     * \brief The template of the requests
+     */
+    std::string request;
+    /**
+     * \brief The number of requests
+     */
+    boost::uint64_t count;
+    /**
+     * \brief The number of requests that failed
+     */
+    boost::uint64_t errors;
+    /**
+     * \brief The cumulated time of the requests, in microseconds
+     */
+    boost::uint64_t totalUs;
+    /**
+     * \brief The longest time of a request, in microseconds
+     */
+    boost::uint64_t maxUs;
+  } stats_t;
+
+  /**
+   * \class Timer
+   * \brief Scope guard timing a request, the request fails if the scope
+   * is left by an exception
+   */
+  class Timer : public boost::noncopyable {
+  public:
+    /**
+     * \brief Constructor, starts the timer
+     * \param profiler the profiler, nil if the requests are not timed
+     * \param request the request, must live as long as the timer
+     */
+    Timer(DbProfiler* profiler, const std::string& request);
+
+    /**
+     * \brief Destructor, records the request
+     */
+    ~Timer();
+
+  private:
+    /**
+     * \brief The profiler
+     */
+    DbProfiler* mprofiler;
+    /**
+     * \brief The request
+     */
+    const std::string& mrequest;
+    /**
+     * \brief When the request started
+     */
+    boost::posix_time::ptime mstart;
+  };
+
+  /**
+   * \class Context
+   * \brief Scope guard naming the work of the current thread, e.g. the
+   * service being called, for the log of the slow requests
+   */
+  class Context : public boost::noncopyable {
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the work
+     */
+    explicit Context(const std::string& name);
+
+    /**
+     * \brief Destructor, restores the previous name
+     */
+    ~Context();
+
+  private:
+    /**
+     * \brief The previous name
+     */
+    std::string mprevious;
+  };
+
+  /**
+   * \brief Maximum number of templates, the next ones are counted together
+   */
+  static const size_t maxTemplates;
+
+  /**
+   * \brief Maximum length of a template, longer ones are truncated
+   */
+  static const size_t maxTemplateLength;
+
+  /**
+   * \brief Constructor
+   * \param slowThreshold the time from which a request is logged, in
+   * milliseconds, 0 if none is logged
+   */
+  explicit DbProfiler(unsigned slowThreshold);
+
+  /**
+   * \brief Record a request
+   * \param request the request
+   * \param elapsedUs the time of the request, in microseconds
+   * \param failed whether the request failed
+   */
+  void
+  record(const std::string& request, boost::uint64_t elapsedUs, bool failed);
+
+  /**
+   * \brief Set how the backend reads the backslashes in the strings, once
+   * it is connected
+   * \param backslashEscapes whether a backslash escapes the next character,
+   * as in MySQL or in PostgreSQL without standard_conforming_strings
+   */
+  void
+  setBackslashEscapes(bool backslashEscapes);
+
+  /**
+   * \brief Get the statistics of the templates
+   * \return the statistics, the longest cumulated time first
+   */
+  std::vector<stats_t>
+  getStats() const;
+
+  /**
+   * \brief Get the template of a request: the quoted strings, the numbers
+   * and the parameters are replaced by '?', the lists of values by a
+   * single one and the blanks by a space
+   * \param request the request
+   * \param backslashEscapes whether a backslash escapes the next character
+   * of a string, otherwise it is an ordinary character
+   * \return the template
+   */
+  static std::string
+  getTemplate(const std::string& request, bool backslashEscapes = false);
+
+  /**
+   * \brief Get the name of the work of the current thread
+   * \return the name, empty if none is set
+   */
+  static std::string
+  getContext();
+
+private:
+  /**
+   * \brief The name of the work of each thread
+   */
+  static boost::thread_specific_ptr<std::string> mcontext;
+
+  /**
+   * \brief The time from which a request is logged, in milliseconds
+   */
+  unsigned mslowThreshold;
+  /**
+   * \brief Whether a backslash escapes the next character of a string
+   */
+  bool mbackslashEscapes;
+  /**
+   * \brief Protects the statistics
+   */
+  mutable boost::mutex mmutex;
+  /**
+   * \brief The statistics by template
+   */
+  std::map<std::string, stats_t> mstats;
+};
+
+#endif // _DBPROFILER_H_
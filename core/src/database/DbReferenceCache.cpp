@@ -0,0 +1,66 @@
+/**
+ * \file DbReferenceCache.cpp
+ * \brief This file implements the cache of the reference tables
+ */
+#include "DbReferenceCache.hpp"
+
+#include <cstdlib>
+#include <boost/scoped_ptr.hpp>
+
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+DbReferenceCache::DbReferenceCache(Database* database, unsigned ttl, size_t capacity)
+  : DbVersionedCache(database, ttl, capacity, "the reference tables") {
+}
+
+std::string
+DbReferenceCache::getFirstElement(const std::string& table, const std::string& request) {
+  std::vector<std::string> row = getFirstRow(table, request);
+  return row.empty() ? "" : row.at(0);
+}
+
+std::vector<std::string>
+DbReferenceCache::getFirstRow(const std::string& table, const std::string& request) {
+  if (!isEnabled()) {
+    return readFirstRow(request);
+  }
+  std::vector<std::string> row;
+  unsigned long generation;
+  if (lookup(table, request, row, generation)) {
+    return row;
+  }
+  // no result is kept too
+  row = readFirstRow(request);
+  store(table, request, row, generation);
+  return row;
+}
+
+void
+DbReferenceCache::invalidate(const std::string& table) {
+  discard(table);
+}
+
+void
+DbReferenceCache::readVersions(std::map<std::string, long long>& versions) {
+  boost::scoped_ptr<DatabaseResult> result(
+      mdatabase->getResult("SELECT tablename, version FROM vishnu_refversion"));
+  for (size_t i = 0; i < result->getNbTuples(); ++i) {
+    std::vector<std::string> row = result->get(i);
+    versions[row.at(0)] = atoll(row.at(1).c_str());
+  }
+}
+
+std::string
+DbReferenceCache::getChangeRequest(const std::string& group) {
+  return "UPDATE vishnu_refversion SET version=version+1 WHERE tablename='" + group + "'";
+}
+
+std::vector<std::string>
+DbReferenceCache::readFirstRow(const std::string& request) {
+  boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(request));
+  if (result->getNbTuples() == 0) {
+    return std::vector<std::string>();
+  }
+  return result->get(0);
+}
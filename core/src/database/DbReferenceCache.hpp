@@ -0,0 +1,83 @@
+/**
+ * \file DbReferenceCache.hpp
+ * \brief This file defines the cache of the reference tables
+ */
+
+#ifndef _DBREFERENCECACHE_H_
+#define _DBREFERENCECACHE_H_
+
+#include "DbVersionedCache.hpp"
+
+/**
+ * \class DbReferenceCache
+ * \brief Keeps in memory the values read in the tables which rarely change:
+ * the users, the machines, the local accounts and the authentication
+ * systems. The servers sharing the database count the changes of each table
+ * in table vishnu_refversion: the values of a table are discarded when its
+ * count has changed.
+ */
+class DbReferenceCache : public DbVersionedCache {
+public:
+  /**
+   * \brief Constructor
+   * \param database the database storing the tables
+   * \param ttl the time a value is kept, in seconds, 0 to keep none
+   * \param capacity the maximum number of values kept
+   */
+  DbReferenceCache(Database* database, unsigned ttl, size_t capacity);
+
+  /**
+   * \brief Get the first element of the result of a request, read in the
+   * database if it is not kept
+   * \param table the table read by the request
+   * \param request the request
+   * \return the first element or an empty string if there is no result
+   */
+  std::string
+  getFirstElement(const std::string& table, const std::string& request);
+
+  /**
+   * \brief Get the first tuple of the result of a request, read in the
+   * database if it is not kept
+   * \param table the table read by the request
+   * \param request the request
+   * \return the first tuple or an empty tuple if there is no result
+   */
+  std::vector<std::string>
+  getFirstRow(const std::string& table, const std::string& request);
+
+  /**
+   * \brief Discard the values of a table kept by every server, to call once
+   * the table has changed
+   * \param table the table
+   */
+  void
+  invalidate(const std::string& table);
+
+protected:
+  /**
+   * \brief Read the counts of changes, a group per table
+   * \param versions set to the counts by table
+   */
+  void
+  readVersions(std::map<std::string, long long>& versions);
+
+  /**
+   * \brief Get the request counting a change of a table
+   * \param group the table
+   * \return the request
+   */
+  std::string
+  getChangeRequest(const std::string& group);
+
+private:
+  /**
+   * \brief Read the first tuple of the result of a request in the database
+   * \param request the request
+   * \return the first tuple or an empty tuple if there is no result
+   */
+  std::vector<std::string>
+  readFirstRow(const std::string& request);
+};
+
+#endif // _DBREFERENCECACHE_H_
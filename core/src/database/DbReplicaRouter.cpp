@@ -0,0 +1,163 @@
+/**
+ * \file DbReplicaRouter.cpp
+ * \brief This file implements the routing of the reads to the database replicas
+ */
+#include "DbReplicaRouter.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+const unsigned DbReplicaRouter::lagCheckInterval = 1;  //%RELAX<MISRA_0_1_3> Used in this file
+
+namespace {
+  /**
+   * \brief The number of writes between two removals of the expired ones
+   */
+  const unsigned purgePeriod = 1000;
+
+  /**
+   * \brief Lag of a PostgreSQL standby, 0 when it has replayed all it received,
+   * null when it does not stream from the primary: what it received may then
+   * be as old as the disconnection
+   */
+  const char* const postgresqlLag =
+    "SELECT CASE WHEN (SELECT status FROM pg_stat_wal_receiver) IS DISTINCT FROM 'streaming' THEN NULL"
+    " WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0"
+    " ELSE EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()) END";
+
+  /**
+   * \brief Position of Seconds_Behind_Master in the status of a MySQL slave
+   */
+  const size_t mysqlLagField = 32;
+}
+
+DbReplicaRouter::DbReplicaRouter(Database* primary, const std::vector<Database*>& replicas,
+                                 unsigned maxLag)
+  : mprimary(primary), mmaxLag(maxLag), mnext(0), mwritesSincePurge(0) {
+  std::vector<Database*>::const_iterator it;
+  for (it = replicas.begin(); it != replicas.end(); ++it) {
+    replica_t replica;
+    replica.database = *it;
+    replica.connected = false;
+    replica.fresh = false;
+    replica.checking = false;
+    // measured at the first read
+    replica.nextCheck = boost::posix_time::ptime(boost::posix_time::neg_infin);
+    mreplicas.push_back(replica);
+  }
+}
+
+DbReplicaRouter::~DbReplicaRouter() {
+  std::vector<replica_t>::iterator it;
+  for (it = mreplicas.begin(); it != mreplicas.end(); ++it) {
+    delete it->database;
+  }
+}
+
+Database*
+DbReplicaRouter::getDatabase(const std::string& sessionKey) {
+  boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+  replica_t* toCheck = NULL;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::map<std::string, boost::posix_time::ptime>::const_iterator write = mwrites.find(sessionKey);
+    if (write != mwrites.end() && write->second > now) {
+      return mprimary;
+    }
+    for (size_t i = 0; i < mreplicas.size(); ++i) {
+      replica_t& replica = mreplicas[(mnext + i) % mreplicas.size()];
+      if (!replica.checking && now >= replica.nextCheck) {
+        // measured by a single reader, the others use the previous measure
+        replica.checking = true;
+        toCheck = &replica;
+      } else if (!replica.fresh) {
+        continue;
+      }
+      mnext = (mnext + i + 1) % mreplicas.size();
+      if (toCheck == NULL) {
+        return replica.database;
+      }
+      break;
+    }
+    if (toCheck == NULL) {
+      return mprimary;
+    }
+  }
+
+  bool fresh = isFresh(*toCheck);
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  toCheck->fresh = fresh;
+  toCheck->checking = false;
+  toCheck->nextCheck = now + boost::posix_time::seconds(lagCheckInterval);
+  return fresh ? toCheck->database : mprimary;
+}
+
+void
+DbReplicaRouter::noteWrite(const std::string& sessionKey) {
+  boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  // until then, a replica under the bound may not have the write
+  mwrites[sessionKey] = now + boost::posix_time::seconds(mmaxLag + lagCheckInterval);
+  if (++mwritesSincePurge < purgePeriod) {
+    return;
+  }
+  mwritesSincePurge = 0;
+  std::map<std::string, boost::posix_time::ptime>::iterator it = mwrites.begin();
+  while (it != mwrites.end()) {
+    if (it->second <= now) {
+      mwrites.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool
+DbReplicaRouter::isFresh(replica_t& replica) {
+  // warn when the replica becomes unusable, not at each measure
+  bool warn = replica.fresh || replica.nextCheck.is_special();
+  try {
+    if (!replica.connected) {
+      replica.database->connect();
+      replica.connected = true;
+    }
+    double lag;
+    if (replica.database->getDbType() == DbConfiguration::MYSQL) {
+      boost::scoped_ptr<DatabaseResult> result(replica.database->getResult("SHOW SLAVE STATUS"));
+      // not a slave, or the replication is stopped
+      if (result->getNbTuples() == 0 || result->getNbFields() <= mysqlLagField
+          || result->getRow(0).isNull(mysqlLagField)) {
+        throw SystemException(ERRCODE_DBERR, "The replication is not running");
+      }
+      lag = result->getRow(0).getDouble(mysqlLagField);
+    } else {
+      boost::scoped_ptr<DatabaseResult> result(replica.database->getResult(postgresqlLag));
+      if (result->getRow(0).isNull(0)) {
+        throw SystemException(ERRCODE_DBERR, "The database is not a standby streaming from the primary");
+      }
+      lag = result->getRow(0).getDouble(0);
+    }
+    if (lag > mmaxLag) {
+      if (!warn) {
+        return false;
+      }
+      std::cerr << boost::format("[WARN] Database replica %1% s behind, reading from the primary\n")
+        % lag;
+      return false;
+    }
+    return true;
+  } catch (VishnuException& ex) {
+    if (!warn) {
+      return false;
+    }
+    std::cerr << "[WARN] Database replica unusable, reading from the primary: "
+              << ex.what() << "\n";
+    return false;
+  }
+}
@@ -0,0 +1,127 @@
+/**
+ * \file DbReplicaRouter.hpp
+ * \brief This file defines the routing of the reads to the database replicas
+ */
+
+#ifndef _DBREPLICAROUTER_H_
+#define _DBREPLICAROUTER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+class Database;
+
+/**
+ * \class DbReplicaRouter
+ * \brief Sends the read-only requests to the read replicas of the database.
+ * A replica is used while its replication lag is under the staleness bound,
+ * the lag is measured at most once per lagCheckInterval. A session that has
+ * written is sent to the primary until its writes may have reached the
+ * replicas, so it reads its own writes. The primary is used when no replica
+ * is fresh enough.
+ */
+class DbReplicaRouter : public boost::noncopyable {
+public:
+  /**
+   * \brief Time between two measures of the lag of a replica, in seconds
+   */
+  static const unsigned lagCheckInterval;
+
+  /**
+   * \brief Constructor
+   * \param primary the database receiving the writes
+   * \param replicas the replicas, not connected yet, owned by the router
+   * \param maxLag the staleness bound, in seconds
+   */
+  DbReplicaRouter(Database* primary, const std::vector<Database*>& replicas, unsigned maxLag);
+
+  /**
+   * \brief Destructor, closes the replicas
+   */
+  ~DbReplicaRouter();
+
+  /**
+   * \brief Get the database to read from
+   * \param sessionKey the key of the session reading, empty if none
+   * \return a replica or the primary
+   */
+  Database*
+  getDatabase(const std::string& sessionKey);
+
+  /**
+   * \brief Record that a session has written to the primary
+   * \param sessionKey the key of the session
+   */
+  void
+  noteWrite(const std::string& sessionKey);
+
+private:
+  /**
+   * \brief The state of a replica
+   */
+  typedef struct replica_t {
+    /**
+     * \brief The replica
+     */
+    Database* database;
+    /**
+     * \brief Whether the connections are opened
+     */
+    bool connected;
+    /**
+     * \brief Whether the lag was under the bound at the last measure
+     */
+    bool fresh;
+    /**
+     * \brief Whether a thread is measuring the lag
+     */
+    bool checking;
+    /**
+     * \brief When the lag must be measured again
+     */
+    boost::posix_time::ptime nextCheck;
+  } replica_t;
+
+  /**
+   * \brief Measure whether a replica is usable, connects it if needed
+   * \param replica the replica, reserved by its checking flag
+   * \return true if its lag is under the bound
+   */
+  bool
+  isFresh(replica_t& replica);
+
+  /**
+   * \brief The primary database
+   */
+  Database* mprimary;
+  /**
+   * \brief The replicas
+   */
+  std::vector<replica_t> mreplicas;
+  /**
+   * \brief The staleness bound, in seconds
+   */
+  unsigned mmaxLag;
+  /**
+   * \brief The next replica to use, round robin
+   */
+  size_t mnext;
+  /**
+   * \brief The time of the last write of the sessions
+   */
+  std::map<std::string, boost::posix_time::ptime> mwrites;
+  /**
+   * \brief The number of writes noted since the expired ones were removed
+   */
+  unsigned mwritesSincePurge;
+  /**
+   * \brief mutex protecting the replicas and the writes
+   */
+  boost::mutex mmutex;
+};
+
+#endif // _DBREPLICAROUTER_H_
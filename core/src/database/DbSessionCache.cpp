@@ -0,0 +1,53 @@
+/**
+ * \file DbSessionCache.cpp
+ * \brief This file implements the cache of the validated sessions
+ */
+#include "DbSessionCache.hpp"
+
+#include <cstdlib>
+#include <boost/scoped_ptr.hpp>
+
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+DbSessionCache::DbSessionCache(Database* database, unsigned ttl, size_t capacity)
+  : DbVersionedCache(database, ttl, capacity, "the sessions") {
+}
+
+bool
+DbSessionCache::get(const std::string& key, std::vector<std::string>& row,
+                    unsigned long& generation) {
+  if (!isEnabled()) {
+    return false;
+  }
+  return lookup("", key, row, generation);
+}
+
+void
+DbSessionCache::put(const std::string& key, const std::vector<std::string>& row,
+                    unsigned long generation) {
+  if (!isEnabled()) {
+    return;
+  }
+  store("", key, row, generation);
+}
+
+void
+DbSessionCache::invalidate() {
+  discard("");
+}
+
+void
+DbSessionCache::readVersions(std::map<std::string, long long>& versions) {
+  boost::scoped_ptr<DatabaseResult> result(
+      mdatabase->getResult("SELECT version FROM vishnu_authversion"));
+  if (result->getNbTuples() == 0) {
+    throw SystemException(ERRCODE_DBERR, "No version in table vishnu_authversion");
+  }
+  versions[""] = atoll(result->getFirstElement().c_str());
+}
+
+std::string
+DbSessionCache::getChangeRequest(const std::string& group) {
+  return "UPDATE vishnu_authversion SET version=version+1";
+}
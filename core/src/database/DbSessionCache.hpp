@@ -0,0 +1,72 @@
+/**
+ * \file DbSessionCache.hpp
+ * \brief This file defines the cache of the validated sessions
+ */
+
+#ifndef _DBSESSIONCACHE_H_
+#define _DBSESSIONCACHE_H_
+
+#include "DbVersionedCache.hpp"
+
+/**
+ * \class DbSessionCache
+ * \brief Keeps in memory the tuples read to validate the session keys. The
+ * servers sharing the database count the changes of the sessions, users,
+ * machines and local accounts together in table vishnu_authversion: every
+ * tuple is discarded when the count has changed.
+ */
+class DbSessionCache : public DbVersionedCache {
+public:
+  /**
+   * \brief Constructor
+   * \param database the database storing the count of changes
+   * \param ttl the time a tuple is kept, in seconds, 0 to keep none
+   * \param capacity the maximum number of tuples kept
+   */
+  DbSessionCache(Database* database, unsigned ttl, size_t capacity);
+
+  /**
+   * \brief Get the tuple of a validated session
+   * \param key the session key and what it was validated for
+   * \param row set to the tuple
+   * \param generation set to the value to give to put() when it is missing
+   * \return true if the tuple is kept
+   */
+  bool
+  get(const std::string& key, std::vector<std::string>& row, unsigned long& generation);
+
+  /**
+   * \brief Keep the tuple of a validated session
+   * \param key the session key and what it was validated for
+   * \param row the tuple
+   * \param generation the value set by get() before the tuple was read,
+   * the tuple is ignored if the sessions have been discarded meanwhile
+   */
+  void
+  put(const std::string& key, const std::vector<std::string>& row, unsigned long generation);
+
+  /**
+   * \brief Discard the tuples kept by every server, to call once a session,
+   * a user, a machine or a local account has changed
+   */
+  void
+  invalidate();
+
+protected:
+  /**
+   * \brief Read the single count of changes, in the unnamed group
+   * \param versions set to the count
+   */
+  void
+  readVersions(std::map<std::string, long long>& versions);
+
+  /**
+   * \brief Get the request counting a change
+   * \param group the unnamed group
+   * \return the request
+   */
+  std::string
+  getChangeRequest(const std::string& group);
+};
+
+#endif // _DBSESSIONCACHE_H_
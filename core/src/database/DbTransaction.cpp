@@ -0,0 +1,34 @@
+/**
+ * \file DbTransaction.cpp
+ * \brief This file implements a scope guard over a database transaction
+ */
+#include "DbTransaction.hpp"
+
+#include <exception>
+
+DbTransaction::DbTransaction(Database* database)
+  : mdatabase(database), mid(database->startTransaction()), mpending(true) {
+}
+
+DbTransaction::~DbTransaction() {
+  if (mpending) {
+    try {
+      rollback();
+    } catch (const std::exception&) {
+      // never throw from a destructor, the connection has been released
+    }
+  }
+}
+
+void
+DbTransaction::commit() {
+  // the backends release the connection even when the commit fails
+  mpending = false;
+  mdatabase->endTransaction(mid);
+}
+
+void
+DbTransaction::rollback() {
+  mpending = false;
+  mdatabase->cancelTransaction(mid);
+}
@@ -0,0 +1,65 @@
+/**
+ * \file DbTransaction.hpp
+ * \brief This file defines a scope guard over a database transaction
+ */
+
+#ifndef _DBTRANSACTION_H_
+#define _DBTRANSACTION_H_
+
+#include <boost/noncopyable.hpp>
+#include "Database.hpp"
+
+/**
+ * \class DbTransaction
+ * \brief Starts a transaction pinned to one connection of the pool and rolls
+ * it back when going out of scope without having been committed. The id must
+ * be given to every request of the transaction.
+ */
+class DbTransaction : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor, starts the transaction
+   * \param database the database, raises an exception on error
+   */
+  explicit DbTransaction(Database* database);
+
+  /**
+   * \brief Destructor, rolls back the transaction if still pending
+   */
+  ~DbTransaction();
+
+  /**
+   * \brief Get the id to pass to the requests of the transaction
+   * \return the transaction id
+   */
+  int
+  getId() const { return mid; }
+
+  /**
+   * \brief Commit the transaction and give its connection back to the pool
+   */
+  void
+  commit();
+
+  /**
+   * \brief Roll back the transaction and give its connection back to the pool
+   */
+  void
+  rollback();
+
+private:
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+  /**
+   * \brief The transaction id
+   */
+  int mid;
+  /**
+   * \brief Whether the transaction is still pending
+   */
+  bool mpending;
+};
+
+#endif // _DBTRANSACTION_H_
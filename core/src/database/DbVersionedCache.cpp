@@ -0,0 +1,160 @@
+/**
+ * \file DbVersionedCache.cpp
+ * \brief This file implements the base of the caches invalidated by counts
+ * of changes stored in the database
+ */
+#include "DbVersionedCache.hpp"
+
+#include <iostream>
+#include <boost/thread/locks.hpp>
+
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+const unsigned DbVersionedCache::versionCheckInterval = 1;  //%RELAX<MISRA_0_1_3> Used in this file
+
+DbVersionedCache::DbVersionedCache(Database* database, unsigned ttl, size_t capacity,
+                                   const std::string& name)
+  : mdatabase(database), mttl(ttl), mcapacity(capacity), mname(name),
+    mvalid(false), mchecking(false),
+    // read at the first lookup
+    mnextCheck(boost::posix_time::neg_infin), mnotifyWarned(false) {
+}
+
+DbVersionedCache::~DbVersionedCache() {
+}
+
+bool
+DbVersionedCache::lookup(const std::string& group, const std::string& key,
+                         std::vector<std::string>& row, unsigned long& generation) {
+  boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+  bool check = false;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    if (!mchecking && now >= mnextCheck) {
+      // the other readers keep the last counts meanwhile
+      mchecking = true;
+      check = true;
+    }
+  }
+  if (check) {
+    checkVersions(now);
+  }
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  generation = mgenerations[group];
+  if (!mvalid) {
+    return false;
+  }
+  std::map<std::string, entry_t>::const_iterator it = mentries.find(key);
+  if (it == mentries.end() || it->second.expires <= now) {
+    return false;
+  }
+  row = it->second.row;
+  return true;
+}
+
+void
+DbVersionedCache::store(const std::string& group, const std::string& key,
+                        const std::vector<std::string>& row, unsigned long generation) {
+  boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (!mvalid || generation != mgenerations[group]) {
+    // read before a change
+    return;
+  }
+  std::map<std::string, entry_t>::iterator it = mentries.find(key);
+  if (it != mentries.end()) {
+    morder.erase(it->second.position);
+    mentries.erase(it);
+  }
+  // the oldest ones first, expired or not
+  while (!morder.empty()
+         && (mentries.size() >= mcapacity || mentries[morder.front()].expires <= now)) {
+    mentries.erase(morder.front());
+    morder.pop_front();
+  }
+  entry_t& entry = mentries[key];
+  entry.row = row;
+  entry.group = group;
+  entry.expires = now + boost::posix_time::seconds(mttl);
+  entry.position = morder.insert(morder.end(), key);
+}
+
+void
+DbVersionedCache::discard(const std::string& group) {
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    clear(group);
+  }
+  try {
+    mdatabase->process(getChangeRequest(group));
+  } catch (VishnuException& ex) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    if (!mnotifyWarned) {
+      mnotifyWarned = true;
+      std::cerr << "[WARN] Cannot notify the other servers of a change of " << mname
+                << (group.empty() ? "" : " (" + group + ")")
+                << ", they may use it until their cache expires: " << ex.what() << "\n";
+    }
+  }
+}
+
+void
+DbVersionedCache::checkVersions(const boost::posix_time::ptime& now) {
+  std::map<std::string, long long> versions;
+  std::string error;
+  try {
+    readVersions(versions);
+  } catch (VishnuException& ex) {
+    error = ex.what();
+  }
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (!error.empty()) {
+    // e.g. the schema has not been upgraded, warn once until it works
+    if (mvalid || mnextCheck.is_special()) {
+      std::cerr << "[WARN] Cannot read the changes of " << mname
+                << ", they are read in the database: " << error << "\n";
+    }
+    mvalid = false;
+    clearAll();
+  } else {
+    std::map<std::string, long long>::const_iterator it;
+    for (it = versions.begin(); it != versions.end(); ++it) {
+      std::map<std::string, long long>::iterator known = mversions.find(it->first);
+      if (known == mversions.end() || known->second != it->second) {
+        clear(it->first);
+      }
+    }
+    mversions.swap(versions);
+    mvalid = true;
+  }
+  mchecking = false;
+  mnextCheck = now + boost::posix_time::seconds(versionCheckInterval);
+}
+
+void
+DbVersionedCache::clear(const std::string& group) {
+  std::list<std::string>::iterator it = morder.begin();
+  while (it != morder.end()) {
+    std::map<std::string, entry_t>::iterator entry = mentries.find(*it);
+    if (entry->second.group == group) {
+      mentries.erase(entry);
+      it = morder.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ++mgenerations[group];
+}
+
+void
+DbVersionedCache::clearAll() {
+  mentries.clear();
+  morder.clear();
+  std::map<std::string, unsigned long>::iterator it;
+  for (it = mgenerations.begin(); it != mgenerations.end(); ++it) {
+    ++it->second;
+  }
+}
@@ -0,0 +1,205 @@
+/**
+ * \file DbVersionedCache.hpp
+ * \brief This file defines the base of the caches invalidated by counts of
+ * changes stored in the database
+ */
+
+#ifndef _DBVERSIONEDCACHE_H_
+#define _DBVERSIONEDCACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+class Database;
+
+/**
+ * \class DbVersionedCache
+ * \brief Keeps in memory tuples read in the database, for a bounded time
+ * and in a bounded number. The tuples belong to groups whose changes are
+ * counted in the database by the servers sharing it: the counts are read at
+ * most once per versionCheckInterval and the tuples of a group are discarded
+ * when its count has changed. While the counts cannot be read, nothing is
+ * kept. The subclasses tell how the counts are read and incremented.
+ */
+class DbVersionedCache : public boost::noncopyable {
+public:
+  /**
+   * \brief Time between two reads of the counts of changes, in seconds
+   */
+  static const unsigned versionCheckInterval;
+
+  /**
+   * \brief Destructor
+   */
+  virtual ~DbVersionedCache();
+
+protected:
+  /**
+   * \brief Constructor
+   * \param database the database storing the counts of changes
+   * \param ttl the time a tuple is kept, in seconds, 0 to keep none
+   * \param capacity the maximum number of tuples kept
+   * \param name what the tuples are, for the warnings
+   */
+  DbVersionedCache(Database* database, unsigned ttl, size_t capacity,
+                   const std::string& name);
+
+  /**
+   * \brief Whether tuples are kept at all
+   * \return false if the time a tuple is kept is 0
+   */
+  bool
+  isEnabled() const { return mttl != 0; }
+
+  /**
+   * \brief Get a tuple kept, reads the counts of changes if they are due
+   * \param group the group of the tuple
+   * \param key the key of the tuple
+   * \param row set to the tuple
+   * \param generation set to the value to give to store() when it is missing
+   * \return true if the tuple is kept
+   */
+  bool
+  lookup(const std::string& group, const std::string& key,
+         std::vector<std::string>& row, unsigned long& generation);
+
+  /**
+   * \brief Keep a tuple, discards the oldest ones if needed
+   * \param group the group of the tuple
+   * \param key the key of the tuple
+   * \param row the tuple
+   * \param generation the value set by lookup() before the tuple was read,
+   * the tuple is ignored if the group has been discarded meanwhile
+   */
+  void
+  store(const std::string& group, const std::string& key,
+        const std::vector<std::string>& row, unsigned long generation);
+
+  /**
+   * \brief Discard the tuples of a group kept by every server
+   * \param group the group
+   */
+  void
+  discard(const std::string& group);
+
+  /**
+   * \brief Read the counts of changes of the groups, raises an exception
+   * if they cannot be read
+   * \param versions set to the counts by group
+   */
+  virtual void
+  readVersions(std::map<std::string, long long>& versions) = 0;
+
+  /**
+   * \brief Get the request counting a change of a group
+   * \param group the group
+   * \return the request
+   */
+  virtual std::string
+  getChangeRequest(const std::string& group) = 0;
+
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+
+private:
+  /**
+   * \brief A tuple kept
+   */
+  typedef struct entry_t {
+    /**
+     * \brief The tuple
+     */
+    std::vector<std::string> row;
+    /**
+     * \brief The group of the tuple
+     */
+    std::string group;
+    /**
+     * \brief When the tuple must be read again
+     */
+    boost::posix_time::ptime expires;
+    /**
+     * \brief The position of the key in the insertion order
+     */
+    std::list<std::string>::iterator position;
+  } entry_t;
+
+  /**
+   * \brief Read the counts of changes, discards the tuples of the groups
+   * whose count has changed
+   * \param now the time of the read
+   */
+  void
+  checkVersions(const boost::posix_time::ptime& now);
+
+  /**
+   * \brief Discard the tuples of a group, the mutex must be held
+   * \param group the group
+   */
+  void
+  clear(const std::string& group);
+
+  /**
+   * \brief Discard all the tuples, the mutex must be held
+   */
+  void
+  clearAll();
+
+  /**
+   * \brief The time a tuple is kept, in seconds
+   */
+  unsigned mttl;
+  /**
+   * \brief The maximum number of tuples kept
+   */
+  size_t mcapacity;
+  /**
+   * \brief What the tuples are, for the warnings
+   */
+  std::string mname;
+  /**
+   * \brief The tuples by key
+   */
+  std::map<std::string, entry_t> mentries;
+  /**
+   * \brief The keys by insertion order, which is also the expiry order
+   */
+  std::list<std::string> morder;
+  /**
+   * \brief Incremented for a group each time its tuples are discarded
+   */
+  std::map<std::string, unsigned long> mgenerations;
+  /**
+   * \brief The counts of changes of the groups at the last read
+   */
+  std::map<std::string, long long> mversions;
+  /**
+   * \brief Whether the last read of the counts succeeded
+   */
+  bool mvalid;
+  /**
+   * \brief Whether a thread is reading the counts
+   */
+  bool mchecking;
+  /**
+   * \brief When the counts must be read again
+   */
+  boost::posix_time::ptime mnextCheck;
+  /**
+   * \brief Whether a failure to count a change has been reported
+   */
+  bool mnotifyWarned;
+  /**
+   * \brief mutex protecting the tuples and the counts
+   */
+  boost::mutex mmutex;
+};
+
+#endif // _DBVERSIONEDCACHE_H_
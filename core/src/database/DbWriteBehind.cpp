@@ -0,0 +1,125 @@
+/**
+ * \file DbWriteBehind.cpp
+ * \brief This file implements the write-behind queue of the database
+ */
+#include "DbWriteBehind.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "Database.hpp"
+#include "VishnuException.hpp"
+
+const unsigned DbWriteBehind::maxItemsPerStatement = 500;  //%RELAX<MISRA_0_1_3> Used in this file
+
+DbWriteBehind::DbWriteBehind(Database* database, unsigned interval, unsigned capacity)
+  : mdatabase(database), minterval(interval), mcapacity(capacity),
+    mpending(0), mstop(false) {
+  mthread.reset(new boost::thread(boost::bind(&DbWriteBehind::run, this)));
+}
+
+DbWriteBehind::~DbWriteBehind() {
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mstop = true;
+  }
+  mwake.notify_one();
+  mthread->join();
+  try {
+    flush();
+  } catch (...) {
+    std::cerr << "[ERROR] Failed to flush the pending database writes\n";
+  }
+}
+
+void
+DbWriteBehind::enqueue(const std::string& statement, const std::string& item, bool unique) {
+  bool full;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    group_t& group = mgroups[statement];
+    if (unique && !group.keys.insert(item).second) {
+      return;
+    }
+    group.items.push_back(item);
+    full = (++mpending >= mcapacity);
+  }
+  // the producer pays for the flush rather than letting the queue grow
+  if (full) {
+    flush();
+  }
+}
+
+void
+DbWriteBehind::flush() {
+  boost::lock_guard<boost::mutex> flushLock(mflushMutex);
+  std::map<std::string, group_t> groups;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    groups.swap(mgroups);
+    mpending = 0;
+  }
+  if (groups.empty()) {
+    return;
+  }
+
+  std::vector<std::string> statements;
+  std::map<std::string, group_t>::const_iterator group;
+  for (group = groups.begin(); group != groups.end(); ++group) {
+    const std::vector<std::string>& items = group->second.items;
+    for (size_t first = 0; first < items.size(); first += maxItemsPerStatement) {
+      size_t last = std::min(items.size(), first + maxItemsPerStatement);
+      std::string list = items[first];
+      for (size_t i = first + 1; i < last; ++i) {
+        list += ", " + items[i];
+      }
+      statements.push_back(boost::str(boost::format(group->first) % list));
+    }
+  }
+
+  try {
+    mdatabase->processBatch(statements);
+  } catch (VishnuException& ex) {
+    // nothing has been written, isolate the faulty items
+    std::cerr << "[WARN] Batch of pending database writes failed, retrying one by one: "
+              << ex.what() << "\n";
+    for (group = groups.begin(); group != groups.end(); ++group) {
+      std::vector<std::string>::const_iterator item;
+      for (item = group->second.items.begin(); item != group->second.items.end(); ++item) {
+        try {
+          mdatabase->process(boost::str(boost::format(group->first) % *item));
+        } catch (VishnuException& ex) {
+          std::cerr << "[ERROR] Pending database write lost: " << ex.what() << "\n";
+        }
+      }
+    }
+  }
+}
+
+unsigned
+DbWriteBehind::getPending() const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mpending;
+}
+
+void
+DbWriteBehind::run() {
+  boost::unique_lock<boost::mutex> lock(mmutex);
+  while (!mstop) {
+    mwake.timed_wait(lock, boost::posix_time::milliseconds(minterval));
+    if (mstop) {
+      break;
+    }
+    lock.unlock();
+    try {
+      flush();
+    } catch (...) {
+      std::cerr << "[ERROR] Failed to flush the pending database writes\n";
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,141 @@
+/**
+ * \file DbWriteBehind.hpp
+ * \brief This file defines the write-behind queue of the database
+ */
+
+#ifndef _DBWRITEBEHIND_H_
+#define _DBWRITEBEHIND_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+class Database;
+
+/**
+ * \class DbWriteBehind
+ * \brief Bounded queue of writes that are not needed to answer a request
+ * (command history, last connection dates).
+ * Writes sharing a statement are coalesced into a single multi-row
+ * statement, e.g. "INSERT INTO t (a, b) VALUES %1%" receives the rows
+ * "(1, 2)", "(3, 4)" and "UPDATE t SET c=1 WHERE key IN (%1%)" receives the
+ * keys "'k1'", "'k2'". A background thread commits all the pending
+ * statements in one batch every interval. The producer flushes the queue
+ * itself when it is full, so the memory used is bounded.
+ * Pending writes are lost if the process crashes: only writes that can
+ * afford it must be enqueued.
+ */
+class DbWriteBehind : public boost::noncopyable {
+public:
+  /**
+   * \brief Maximum number of items merged in one statement
+   */
+  static const unsigned maxItemsPerStatement;
+
+  /**
+   * \brief Constructor, starts the flusher thread
+   * \param database the database the writes are committed to
+   * \param interval the time between two flushes, in milliseconds
+   * \param capacity the number of pending items triggering a flush
+   */
+  DbWriteBehind(Database* database, unsigned interval, unsigned capacity);
+
+  /**
+   * \brief Destructor, stops the flusher thread and flushes the queue
+   */
+  ~DbWriteBehind();
+
+  /**
+   * \brief Enqueue a write
+   * \param statement the statement, %1% is replaced by the comma separated
+   * list of the items of the statement
+   * \param item the item to merge, already escaped
+   * \param unique true if an item enqueued twice must be written once
+   */
+  void
+  enqueue(const std::string& statement, const std::string& item, bool unique = false);
+
+  /**
+   * \brief Commit all the pending writes, returns once they are written
+   */
+  void
+  flush();
+
+  /**
+   * \brief Get the number of pending items
+   * \return the number of items
+   */
+  unsigned
+  getPending() const;
+
+private:
+  /**
+   * \brief The items of a statement
+   */
+  typedef struct group_t {
+    /**
+     * \brief The items, in enqueue order
+     */
+    std::vector<std::string> items;
+    /**
+     * \brief The items already enqueued, for unique statements
+     */
+    std::set<std::string> keys;
+  } group_t;
+
+  /**
+   * \brief Body of the flusher thread
+   */
+  void
+  run();
+
+  /**
+   * \brief The database
+   */
+  Database* mdatabase;
+  /**
+   * \brief The time between two flushes, in milliseconds
+   */
+  unsigned minterval;
+  /**
+   * \brief The number of pending items triggering a flush
+   */
+  unsigned mcapacity;
+  /**
+   * \brief The pending items by statement
+   */
+  std::map<std::string, group_t> mgroups;
+  /**
+   * \brief The number of pending items
+   */
+  unsigned mpending;
+  /**
+   * \brief Whether the flusher thread must stop
+   */
+  bool mstop;
+  /**
+   * \brief mutex protecting the queue
+   */
+  mutable boost::mutex mmutex;
+  /**
+   * \brief mutex serializing the flushes, so that flush() returns once
+   * the writes enqueued before are committed
+   */
+  boost::mutex mflushMutex;
+  /**
+   * \brief condition signaled to wake up the flusher thread
+   */
+  boost::condition_variable mwake;
+  /**
+   * \brief The flusher thread
+   */
+  boost::scoped_ptr<boost::thread> mthread;
+};
+
+#endif // _DBWRITEBEHIND_H_
@@ -9,6 +9,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <vector>
 
+#include "DbProfiler.hpp"
 #include "SystemException.hpp"
 #include "utilVishnu.hpp"
 #include "errmsg.h"
@@ -25,6 +26,63 @@ int dbErrorNo(MYSQL *conn) {
   return mysql_errno(conn);
 }
 
+namespace {
+  /**
+   * \class MYSQLRowResult
+   * \brief The tuple being streamed by forEachRow, read in place
+   */
+  class MYSQLRowResult : public DatabaseResult {
+  public :
+    explicit MYSQLRowResult(MYSQL_RES* res)
+      : DatabaseResult(), mres(res), mrow(NULL), mlengths(NULL),
+        mnbFields(mysql_num_fields(res)) {}
+
+    /**
+     * \brief To read the next tuple
+     * \return false when there is no more tuple
+     */
+    bool
+    next() {
+      mrow = mysql_fetch_row(mres);
+      mlengths = (mrow != NULL) ? mysql_fetch_lengths(mres) : NULL;
+      return (mrow != NULL);
+    }
+
+    virtual size_t
+    getNbTuples() const { return (mrow != NULL) ? 1 : 0; }
+
+    virtual size_t
+    getNbFields() const { return mnbFields; }
+
+  protected :
+    virtual const char*
+    getCell(size_t position, size_t field) const {
+      return (mrow[field] != NULL) ? mrow[field] : "";
+    }
+
+    virtual size_t
+    getCellLength(size_t position, size_t field) const {
+      return mlengths[field];
+    }
+
+    virtual bool
+    isCellNull(size_t position, size_t field) const {
+      return (mrow[field] == NULL);
+    }
+
+    virtual std::string
+    getAttributeName(size_t field) const {
+      return std::string(mysql_fetch_field_direct(mres, field)->name);
+    }
+
+  private :
+    MYSQL_RES* mres;
+    MYSQL_ROW mrow;
+    unsigned long* mlengths;
+    size_t mnbFields;
+  };
+}
+
 int
 MYSQLDatabase::process(string request, int transacId){
   int reqPos;
@@ -35,6 +93,8 @@ MYSQLDatabase::process(string request, int transacId){
     reqPos = -1;
     conn = (&(mpool[transacId].mmysql));
   }
+  // the wait for a connection is in the statistics of the pool
+  DbProfiler::Timer timer(mprofiler, request);
 
   int res;
   if (request.empty()) {
@@ -49,10 +109,19 @@ MYSQLDatabase::process(string request, int transacId){
 
   res=mysql_real_query(conn, request.c_str (), request.length());
   if (res) {
-    if((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR)) {
-      throw SystemException(ERRCODE_DBERR, dbErrorMsg(conn));
+    if (reqPos == -1
+        || ((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR))) {
+      // a lost transaction cannot be replayed on a new connexion
+      std::string errorMsg = dbErrorMsg(conn);
+      releaseConnection(reqPos);
+      throw SystemException(ERRCODE_DBERR, errorMsg);
+    }
+    try {
+      connectPoolIndex(reqPos);  // try to reinitialise the socket
+    } catch (SystemException& e) {
+      releaseConnection(reqPos);
+      throw;
     }
-    connectPoolIndex(reqPos);  // try to reinitialise the socket
     res=mysql_real_query(conn, request.c_str (), request.length());
     if (res) {
       // Could not execute the query
@@ -129,18 +198,22 @@ MYSQLDatabase::connectPoolIndex(const int& poolIdx) {
     throw SystemException(ERRCODE_DBERR, "Cannot connect to the DB" + dbErrorMsg(&(mpool[poolIdx].mmysql)));
   }
   mysql_set_character_set(&(mpool[poolIdx].mmysql), "utf8");
+  mnoBackslashEscapes = ((mpool[poolIdx].mmysql.server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES) != 0);
+  if (mprofiler != NULL) {
+    mprofiler->setBackslashEscapes(!mnoBackslashEscapes);
+  }
 }
 
 /**
  * \brief Constructor, raises an exception on error
  */
 MYSQLDatabase::MYSQLDatabase(DbConfiguration dbConfig)
-  : Database(), mconfig(dbConfig) {
+  : Database(), mconfig(dbConfig),
+    mslots(dbConfig.getDbPoolSize(), dbConfig.getDbPoolTimeout()),
+    mnoBackslashEscapes(false) {
   mysql_library_init(0, NULL, NULL);
   mpool = new pool_t[mconfig.getDbPoolSize()];
   for (unsigned int i=0;i<mconfig.getDbPoolSize();i++) {
-    pthread_mutex_init(&(mpool[i].mmutex), NULL);
-    mpool[i].mused = false;
     mysql_init(&(mpool[i].mmysql));
   }
 }
@@ -182,13 +255,23 @@ MYSQLDatabase::getResult(string request, int transacId) {
     reqPos = -1;
     conn = (&(mpool[transacId].mmysql));
   }
+  DbProfiler::Timer timer(mprofiler, request);
   // Execute the SQL query
   if ((res=mysql_real_query(conn, request.c_str (), request.length())) != 0) {
 
-    if((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR)) {
-      throw SystemException(ERRCODE_DBERR, dbErrorMsg(conn));
+    if (reqPos == -1
+        || ((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR))) {
+      // a lost transaction cannot be replayed on a new connexion
+      std::string errorMsg = dbErrorMsg(conn);
+      releaseConnection(reqPos);
+      throw SystemException(ERRCODE_DBERR, errorMsg);
+    }
+    try {
+      connectPoolIndex(reqPos);  // try to reinitialise the socket
+    } catch (SystemException& e) {
+      releaseConnection(reqPos);
+      throw;
     }
-    connectPoolIndex(reqPos);  // try to reinitialise the socket
     res=mysql_real_query(conn, request.c_str (), request.length());
     if (res) {
       releaseConnection(reqPos);
@@ -229,36 +312,69 @@ MYSQLDatabase::getResult(string request, int transacId) {
   return new DatabaseResult(results, attributesNames);
 }
 
+size_t
+MYSQLDatabase::forEachRow(const std::string& request, const RowHandler& handler,
+                          int transacId) {
+  int reqPos;
+  MYSQL* conn = NULL;
+  if (transacId==-1) {
+    conn = getConnection(reqPos);
+  } else {
+    reqPos = -1;
+    conn = (&(mpool[transacId].mmysql));
+  }
+  // the time to handle the tuples is counted too
+  DbProfiler::Timer timer(mprofiler, request);
+  if (mysql_real_query(conn, request.c_str (), request.length()) != 0) {
+    std::string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "S-Query error" + errorMsg);
+  }
+
+  // the tuples are not fetched from the server before being read
+  MYSQL_RES *result = mysql_use_result(conn);
+  if (!result) {
+    std::string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "Cannot get query results" + errorMsg);
+  }
+  size_t nbTuples = 0;
+  try {
+    MYSQLRowResult row(result);
+    while (row.next()) {
+      handler(row.getRow(0));
+      ++nbTuples;
+    }
+  } catch (...) {
+    // the remaining tuples are discarded with the result
+    mysql_free_result(result);
+    releaseConnection(reqPos);
+    throw;
+  }
+  bool failed = (dbErrorNo(conn) != 0);
+  std::string errorMsg = dbErrorMsg(conn);
+  mysql_free_result(result);
+  releaseConnection(reqPos);
+  if (failed) {
+    throw SystemException(ERRCODE_DBERR, "S-Query error" + errorMsg);
+  }
+  return nbTuples;
+}
 
 MYSQL*
 MYSQLDatabase::getConnection(int& id){
-  int i = 0;
-  int locked;
-  // Looking for an unused connection (will block until a connection is free)
-  while (true) {
-    // If the connection is not used
-    if(!mpool[i].mused) {
-      locked = pthread_mutex_trylock(&(mpool[i].mmutex));
-      // If lock fails-> the mutex was taken before trylock call
-      if (locked) {
-        // Try next connexion
-        sleep(2);
-        continue;
-      }
-      else {
-        mpool[i].mused=true;
-        id = i;
-        return &(mpool[i].mmysql);
-      }
-    }
-    i++;
-    // I do not use modulo '%' because i need to be sure i>0
-    if (i==mconfig.getDbPoolSize()) {
-      i=0;
-      sleep(10);
+  id = mslots.acquire();
+  MYSQL* conn = &(mpool[id].mmysql);
+  // a connection left idle may have been closed by the server (wait_timeout)
+  if (mslots.needsCheck(id) && mysql_ping(conn) != 0) {
+    try {
+      connectPoolIndex(id);
+    } catch (SystemException& e) {
+      mslots.release(id);
+      throw;
     }
   }
-  throw SystemException(ERRCODE_DBCONN, "Cannot get available DB connection");
+  return conn;
 }
 
 void
@@ -266,11 +382,12 @@ MYSQLDatabase::releaseConnection(int pos) {
   if (pos==-1){
     return;
   }
-  int ret = pthread_mutex_unlock(&(mpool[pos].mmutex));
-  if (ret) {
-    throw SystemException(ERRCODE_DBCONN, "Cannot release connection lock");
-  }
-  mpool[pos].mused = false;
+  mslots.release(pos);
+}
+
+DbConnectionPool::stats_t
+MYSQLDatabase::getPoolStats() {
+  return mslots.getStats();
 }
 
 int
@@ -369,13 +486,59 @@ MYSQLDatabase::getRequest(const int key){
 std::string
 MYSQLDatabase::escapeData(const std::string& data)
 {
-  size_t len = data.size();
-  char escapedSql[2*len + 1];
-
-  int connId;
-  MYSQL* conn = getConnection(connId);
-  size_t escapedSqlLen = mysql_real_escape_string(conn, escapedSql, data.c_str(), len);
-  releaseConnection(connId);
+  return escapeString(data, mnoBackslashEscapes);
+}
 
-  return std::string(escapedSql, escapedSqlLen);
+/**
+ * @brief escapeString : transform a sql data to a SQL-escaped string,
+ * without a connexion
+ * @param data: the string to transform
+ * @param noBackslashEscapes: whether the server runs with sql_mode
+ * NO_BACKSLASH_ESCAPES, in which a backslash is an ordinary character
+ * @return a espaced string
+ */
+std::string
+MYSQLDatabase::escapeString(const std::string& data, bool noBackslashEscapes)
+{
+  // same escapes as mysql_real_escape_string, the connexions use utf8 in
+  // which none of these bytes is part of a multibyte character, so no
+  // connexion is needed
+  std::string escaped;
+  escaped.reserve(data.size() + 8);
+  std::string::const_iterator c;
+  if (noBackslashEscapes) {
+    // only the quotes can end a literal, they are doubled
+    for (c = data.begin(); c != data.end(); ++c) {
+      if (*c == '\'') {
+        escaped += *c;
+      }
+      escaped += *c;
+    }
+    return escaped;
+  }
+  for (c = data.begin(); c != data.end(); ++c) {
+    switch (*c) {
+    case '\0':
+      escaped += "\\0";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\r':
+      escaped += "\\r";
+      break;
+    case '\032':
+      escaped += "\\Z";
+      break;
+    case '\\':
+    case '\'':
+    case '"':
+      escaped += '\\';
+      // Intentional fallthrough
+    default:
+      escaped += *c;
+      break;
+    }
+  }
+  return escaped;
 }
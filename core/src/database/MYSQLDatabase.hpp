@@ -9,7 +9,6 @@
 #define _MYSQLDATABASE_H_
 
 #include <string>
-#include <pthread.h>
 
 #include "Database.hpp"
 #include "DatabaseResult.hpp"
@@ -127,6 +126,36 @@ public :
   virtual std::string
   escapeData(const std::string& data);
 
+  /**
+   * @brief escapeString : transform a sql data to a SQL-escaped string for
+   * MySQL, without a connexion
+   * @param data: the string to transform
+   * @param noBackslashEscapes: whether the server runs with sql_mode
+   * NO_BACKSLASH_ESCAPES, in which a backslash is an ordinary character
+   * @return a espaced string
+   */
+  static std::string
+  escapeString(const std::string& data, bool noBackslashEscapes);
+
+  /**
+   * \brief To stream the result of a select request, the tuples are read
+   * from the server as they are consumed (mysql_use_result)
+   * \param request The request to process (a single SELECT)
+   * \param handler The callback called for each tuple
+   * \param transacId the id of the transaction if one is used
+   * \return the number of tuples
+   */
+  virtual size_t
+  forEachRow(const std::string& request, const RowHandler& handler,
+             int transacId = -1);
+
+  /**
+   * \brief To get the usage metrics of the connection pool
+   * \return the metrics
+   */
+  virtual DbConnectionPool::stats_t
+  getPoolStats();
+
 private :
   /**
    * \brief To get a valid connexion
@@ -145,18 +174,10 @@ private :
    * \brief An element of the pool
    */
   typedef struct pool_t{
-    /**
-     * \brief If the connexion is used
-     */
-    bool mused;
     /**
      * \brief The connection mysql structure
      */
     MYSQL mmysql;
-    /**
-     * \brief The associated mutex
-     */
-    pthread_mutex_t mmutex;
   }pool_t;
   /////////////////////////////////
   // Attributes
@@ -169,6 +190,15 @@ private :
    * \brief The pool of connection
    */
   pool_t *mpool;
+  /**
+   * \brief The slots of the pool, to wait for a free connection
+   */
+  DbConnectionPool mslots;
+  /**
+   * \brief Whether the server runs with sql_mode NO_BACKSLASH_ESCAPES, read
+   * when a connection is opened
+   */
+  bool mnoBackslashEscapes;
 
   /////////////////////////////////
   // Functions
@@ -0,0 +1,45 @@
+/**
+ * \file PGSQLDatabaseResult.cpp
+ * \brief This file implements the results of a PostGreSQL request
+ */
+#include "PGSQLDatabaseResult.hpp"
+
+PGSQLDatabaseResult::PGSQLDatabaseResult(PGresult* res)
+  : DatabaseResult(), mres(res),
+    mnbTuples(PQntuples(res)), mnbFields(PQnfields(res)) {
+}
+
+PGSQLDatabaseResult::~PGSQLDatabaseResult() {
+  PQclear(mres);
+}
+
+size_t
+PGSQLDatabaseResult::getNbTuples() const {
+  return mnbTuples;
+}
+
+size_t
+PGSQLDatabaseResult::getNbFields() const {
+  return mnbFields;
+}
+
+const char*
+PGSQLDatabaseResult::getCell(size_t position, size_t field) const {
+  // libpq returns an empty string for NULL
+  return PQgetvalue(mres, static_cast<int>(position), static_cast<int>(field));
+}
+
+size_t
+PGSQLDatabaseResult::getCellLength(size_t position, size_t field) const {
+  return PQgetlength(mres, static_cast<int>(position), static_cast<int>(field));
+}
+
+bool
+PGSQLDatabaseResult::isCellNull(size_t position, size_t field) const {
+  return PQgetisnull(mres, static_cast<int>(position), static_cast<int>(field)) != 0;
+}
+
+std::string
+PGSQLDatabaseResult::getAttributeName(size_t field) const {
+  return std::string(PQfname(mres, static_cast<int>(field)));
+}
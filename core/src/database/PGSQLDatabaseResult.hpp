@@ -0,0 +1,68 @@
+/**
+ * \file PGSQLDatabaseResult.hpp
+ * \brief This file defines the results of a PostGreSQL request
+ */
+
+#ifndef _PGSQLDATABASERESULT_H_
+#define _PGSQLDATABASERESULT_H_
+
+#include <boost/noncopyable.hpp>
+#include "DatabaseResult.hpp"
+
+#include "libpq-fe.h"
+
+/**
+ * \class PGSQLDatabaseResult
+ * \brief Keeps the native result of a select request and gives access to its
+ * cells without copying them
+ */
+class PGSQLDatabaseResult : public DatabaseResult, public boost::noncopyable {
+public :
+  /**
+   * \brief Constructor
+   * \param res the result of a select request, cleared by the destructor
+   */
+  explicit PGSQLDatabaseResult(PGresult* res);
+  /**
+   * \brief Destructor
+   */
+  virtual ~PGSQLDatabaseResult();
+  /**
+   * \brief To get the number of tuples
+   * \return the number of tuples
+   */
+  virtual size_t
+  getNbTuples() const;
+  /**
+   * \brief To get the number of fields
+   * \return the number of fields
+   */
+  virtual size_t
+  getNbFields() const;
+
+protected :
+  virtual const char*
+  getCell(size_t position, size_t field) const;
+  virtual size_t
+  getCellLength(size_t position, size_t field) const;
+  virtual bool
+  isCellNull(size_t position, size_t field) const;
+  virtual std::string
+  getAttributeName(size_t field) const;
+
+private :
+  /**
+   * \brief The native result
+   */
+  PGresult* mres;
+  /**
+   * \brief The number of tuples
+   */
+  size_t mnbTuples;
+  /**
+   * \brief The number of fields
+   */
+  size_t mnbFields;
+};
+
+#endif // _PGSQLDATABASERESULT_H_
@@ -5,17 +5,22 @@
  * \date 31/01/2011
  */
 #include "POSTGREDatabase.hpp"
+#include "PGSQLDatabaseResult.hpp"
 
 #include <sstream>
 #include <vector>
 #include <boost/scoped_ptr.hpp>
 
+#include "DbProfiler.hpp"
 #include "SystemException.hpp"
 #include "utilVishnu.hpp"
 #include <boost/format.hpp>
 
 using namespace std;
 
+const unsigned POSTGREDatabase::maxPreparedStatements = 128;  //%RELAX<MISRA_0_1_3> Used in this file
+const unsigned POSTGREDatabase::fetchSize = 500;  //%RELAX<MISRA_0_1_3> Used in this file
+
 /**
  * \brief Function to process the request in the database
  * \param request The request to process
@@ -24,23 +29,24 @@ using namespace std;
 int
 POSTGREDatabase::process(std::string request, int transacId){
   int reqPos;
-  PGconn* lconn = getConnection(reqPos);
-
-  if (PQstatus(lconn) == CONNECTION_OK) {
-    PGresult* res = PQexec(lconn, request.c_str());
+  PGconn* lconn = getConnection(reqPos, transacId);
+  // the wait for a connection is in the statistics of the pool
+  DbProfiler::Timer timer(mprofiler, request);
 
-    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-      PQclear(res);
-      std::string errorMsg = std::string(PQerrorMessage(lconn));
-      errorMsg.append("- Note: The process function must not be used for select request");
-      releaseConnection(reqPos);
-      throw SystemException(ERRCODE_DBERR, errorMsg);
-    }
+  PGresult* res = PQexec(lconn, request.c_str());
+  if (PQresultStatus(res) != PGRES_COMMAND_OK) {
     PQclear(res);
-  } else {
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    errorMsg.append("- Note: The process function must not be used for select request");
+    // writes are not replayed: the statement may have been applied before
+    // the connexion was lost, the connexion is only reset for the next use
+    if (reqPos != -1) {
+      checkConnection(reqPos, false);
+    }
     releaseConnection(reqPos);
-    throw SystemException(ERRCODE_DBCONN, std::string(PQerrorMessage(lconn)));
+    throw SystemException(ERRCODE_DBERR, errorMsg);
   }
+  PQclear(res);
   releaseConnection(reqPos);
   return SUCCESS;
 }
@@ -66,6 +72,7 @@ POSTGREDatabase::connect() {
                                         "dbname=%3% "
                                         "user=%4% "
                                         "password=%5% "
+                                        "client_encoding=UTF8 "
                                         "%6%"
                                         )
                           %mconfig.getDbHost()
@@ -85,6 +92,11 @@ POSTGREDatabase::connect() {
       if (PQstatus(mpool[i].mconn) != CONNECTION_OK) {
         throw SystemException(ERRCODE_DBCONN, std::string(PQerrorMessage(mpool[i].mconn)));
       }
+      const char* stdStrings = PQparameterStatus(mpool[i].mconn, "standard_conforming_strings");
+      mstdStrings = (stdStrings != NULL && std::string(stdStrings) == "on");
+      if (mprofiler != NULL) {
+        mprofiler->setBackslashEscapes(!mstdStrings);
+      }
       misConnected = true;
     } else {
       throw SystemException(ERRCODE_DBCONN, "The database is already connected");
@@ -97,13 +109,14 @@ POSTGREDatabase::connect() {
  * \brief Constructor
  */
 POSTGREDatabase::POSTGREDatabase(DbConfiguration dbConfig)
-  : Database(), mconfig(dbConfig), misConnected(false) {
+  : Database(), mconfig(dbConfig),
+    mslots(dbConfig.getDbPoolSize(), dbConfig.getDbPoolTimeout()),
+    misConnected(false), mstdStrings(true) {
   int i;
   mpool = new pool_t[mconfig.getDbPoolSize()];
   for (i=0;i<mconfig.getDbPoolSize();i++){
-    pthread_mutex_init(&(mpool[i].mmutex), NULL);
-    mpool[i].mused = false;
     mpool[i].mconn = NULL;
+    mpool[i].mnextStatement = 0;
   }
 }
 
@@ -126,8 +139,8 @@ POSTGREDatabase::disconnect(){
   for (i = 0; i < mconfig.getDbPoolSize(); i++){
     if (mpool[i].mconn != NULL) {
       PQfinish(mpool[i].mconn);
+      mpool[i].mconn = NULL;
     }
-    pthread_mutex_destroy(&(mpool[i].mmutex));
   }
   return SUCCESS;
 }
@@ -140,106 +153,298 @@ POSTGREDatabase::disconnect(){
  */
 DatabaseResult*
 POSTGREDatabase::getResult(std::string request, int transacId) {
-  std::vector<std::vector<std::string> > results;
-  std::vector<std::string> attributesNames;
-  std::vector<std::string> tmp;
   int reqPos;
-  PGconn* lconn = getConnection(reqPos);
+  PGconn* lconn = getConnection(reqPos, transacId);
+  DbProfiler::Timer timer(mprofiler, request);
+
+  PGresult* res = PQexec(lconn, request.c_str());
+  if (PQresultStatus(res) != PGRES_TUPLES_OK
+      && reqPos != -1
+      && PQstatus(lconn) == CONNECTION_BAD
+      && checkConnection(reqPos, false)) {
+    // the server closed the connexion, a read can be replayed on the new one
+    PQclear(res);
+    res = PQexec(lconn, request.c_str());
+  }
 
-  if (PQstatus(lconn) == CONNECTION_OK) {
-    PGresult* res = PQexec(lconn, request.c_str());
-    int i;
-    int j;
+  if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  releaseConnection(reqPos);
+  // the result is read in place, it is cleared with the DatabaseResult
+  return new PGSQLDatabaseResult(res);
+}
 
-    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-      PQclear(res);
-      releaseConnection(reqPos);
-      throw SystemException(ERRCODE_DBERR, std::string(PQerrorMessage(lconn)));
-    }
-    int nFields = PQnfields(res);
-    for (i = 0; i < nFields; i++) {
-      attributesNames.push_back(std::string(PQfname(res, i)));
-    }
+int
+POSTGREDatabase::processPrepared(const std::string& request,
+                                 const std::vector<std::string>& params,
+                                 int transacId) {
+  int reqPos;
+  PGconn* lconn = getConnection(reqPos, transacId);
+  DbProfiler::Timer timer(mprofiler, request);
 
-    for (i = 0; i < PQntuples(res); i++) {
-      tmp.clear();
-      for (j = 0; j < nFields; j++) {
-        tmp.push_back(std::string(PQgetvalue(res, i, j)));
-      }
-      results.push_back(tmp);
+  PGresult* res = execPrepared((transacId == -1) ? reqPos : transacId, request, params);
+  if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    if (reqPos != -1) {
+      checkConnection(reqPos, false);
     }
     releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  PQclear(res);
+  releaseConnection(reqPos);
+  return SUCCESS;
+}
+
+DatabaseResult*
+POSTGREDatabase::getPreparedResult(const std::string& request,
+                                   const std::vector<std::string>& params,
+                                   int transacId) {
+  int reqPos;
+  PGconn* lconn = getConnection(reqPos, transacId);
+  DbProfiler::Timer timer(mprofiler, request);
+
+  PGresult* res = execPrepared((transacId == -1) ? reqPos : transacId, request, params);
+  if (PQresultStatus(res) != PGRES_TUPLES_OK
+      && reqPos != -1
+      && PQstatus(lconn) == CONNECTION_BAD
+      && checkConnection(reqPos, false)) {
+    // the statements are prepared again on the new connexion
+    PQclear(res);
+    res = execPrepared(reqPos, request, params);
+  }
+
+  if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  releaseConnection(reqPos);
+  // the result is read in place, it is cleared with the DatabaseResult
+  return new PGSQLDatabaseResult(res);
+}
+
+int
+POSTGREDatabase::processBatch(const std::vector<std::string>& requests, int transacId) {
+  if (requests.empty()) {
+    return SUCCESS;
+  }
+  int reqPos;
+  PGconn* lconn = getConnection(reqPos, transacId);
+  std::string batch = joinRequests(requests);
+  DbProfiler::Timer timer(mprofiler, batch);
+
+  std::string errorMsg;
+  if (!PQsendQuery(lconn, batch.c_str())) {
+    errorMsg = std::string(PQerrorMessage(lconn));
+  }
+  // one result per statement, all of them must be read before the
+  // connexion is used again
+  PGresult* res;
+  while ((res = PQgetResult(lconn)) != NULL) {
+    ExecStatusType status = PQresultStatus(res);
+    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK && errorMsg.empty()) {
+      errorMsg = std::string(PQresultErrorMessage(res));
+    }
     PQclear(res);
-  } else {
+  }
+  if (!errorMsg.empty()) {
+    if (reqPos != -1) {
+      checkConnection(reqPos, false);
+    }
     releaseConnection(reqPos);
-    throw SystemException(ERRCODE_DBCONN, "The database is not connected");
+    throw SystemException(ERRCODE_DBERR, errorMsg);
   }
-  return new DatabaseResult(results, attributesNames);
+  releaseConnection(reqPos);
+  return SUCCESS;
 }
 
-PGconn* POSTGREDatabase::getConnection(int& id){
-  int i = 0;
-  int locked;
-  // Looking for an unused connection
-  while (true) {
-    // If the connection is not used
-    if(!mpool[i].mused) {
-      locked = pthread_mutex_trylock(&(mpool[i].mmutex));
-      // If lock fails-> the mutex was taken before trylock call
-      if (locked) {
-        // Try next connexion
-        sleep(2);
-        continue;
+size_t
+POSTGREDatabase::forEachRow(const std::string& request, const RowHandler& handler,
+                            int transacId) {
+  // a cursor only lives in a transaction, a read-only one is opened if needed
+  int tid = (transacId == -1) ? startTransaction() : transacId;
+  std::string fetch = (boost::format("FETCH %1% FROM vishnu_cursor;") % fetchSize).str();
+  size_t nbTuples = 0;
+  try {
+    std::string select = request;
+    select.erase(select.find_last_not_of("; \t\n") + 1);
+    process("DECLARE vishnu_cursor NO SCROLL CURSOR FOR " + select + ";", tid);
+    size_t fetched;
+    do {
+      boost::scoped_ptr<DatabaseResult> chunk(getResult(fetch, tid));
+      fetched = chunk->getNbTuples();
+      for (size_t i = 0; i < fetched; ++i) {
+        handler(chunk->getRow(i));
       }
-      else {
-        mpool[i].mused=true;
-        id = i;
-        return mpool[i].mconn;
+      nbTuples += fetched;
+    } while (fetched == fetchSize);
+    process("CLOSE vishnu_cursor;", tid);
+  } catch (...) {
+    if (transacId == -1) {
+      try {
+        cancelTransaction(tid);
+      } catch (...) {
+        // keep the original error
       }
     }
-    i++;
-    // I do not use modulo '%' because i need to be sure i>0
-    if (i==mconfig.getDbPoolSize()) {
-      i=0;
-      sleep(10);
+    throw;
+  }
+  if (transacId == -1) {
+    endTransaction(tid);
+  }
+  return nbTuples;
+}
+
+PGresult*
+POSTGREDatabase::execPrepared(int pos, const std::string& request,
+                              const std::vector<std::string>& params) {
+  PGconn* lconn = mpool[pos].mconn;
+  std::map<std::string, std::string>& statements = mpool[pos].mstatements;
+
+  std::map<std::string, std::string>::iterator it = statements.find(request);
+  if (it == statements.end()) {
+    if (statements.size() >= maxPreparedStatements) {
+      // the names are never reused, a failure only leaves unused statements
+      PQclear(PQexec(lconn, "DEALLOCATE ALL;"));
+      statements.clear();
+    }
+    std::string name = "vr" + vishnu::convertToString(mpool[pos].mnextStatement++);
+    PGresult* res = PQprepare(lconn, name.c_str(), request.c_str(),
+                              static_cast<int>(params.size()), NULL);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+      return res;
     }
+    PQclear(res);
+    it = statements.insert(std::make_pair(request, name)).first;
+  }
+
+  std::vector<const char*> values;
+  std::vector<std::string>::const_iterator param;
+  for (param = params.begin(); param != params.end(); ++param) {
+    values.push_back(param->c_str());
+  }
+  return PQexecPrepared(lconn, it->second.c_str(), static_cast<int>(values.size()),
+                        values.empty() ? NULL : &values[0], NULL, NULL, 0);
+}
+
+PGconn* POSTGREDatabase::getConnection(int& id, int transacId){
+  if (transacId != -1) {
+    // the connexion is pinned to the transaction until it ends
+    id = -1;
+    return mpool[transacId].mconn;
+  }
+  id = mslots.acquire();
+  if (!checkConnection(id, mslots.needsCheck(id))) {
+    std::string errorMsg = "The database is not connected";
+    if (mpool[id].mconn != NULL) {
+      errorMsg = std::string(PQerrorMessage(mpool[id].mconn));
+    }
+    mslots.release(id);
+    throw SystemException(ERRCODE_DBCONN, errorMsg);
+  }
+  return mpool[id].mconn;
+}
+
+bool
+POSTGREDatabase::checkConnection(int pos, bool probe) {
+  PGconn* conn = mpool[pos].mconn;
+  if (conn == NULL) {
+    return false;
+  }
+  if (probe && PQstatus(conn) == CONNECTION_OK) {
+    // an empty query is the cheapest round trip, it marks a dead
+    // connexion as bad
+    PQclear(PQexec(conn, ""));
+  }
+  if (PQstatus(conn) != CONNECTION_OK) {
+    // the statements prepared on the connexion are lost with it
+    mpool[pos].mstatements.clear();
+    PQreset(conn);
   }
-  throw SystemException(ERRCODE_DBCONN, "Unknown error, cannot get connexion on database");
+  return (PQstatus(conn) == CONNECTION_OK);
 }
 
 void POSTGREDatabase::releaseConnection(int pos){
-  int ret;
-  ret = pthread_mutex_unlock(&(mpool[pos].mmutex));
-  if (ret) {
-    throw SystemException(ERRCODE_DBCONN, "Fail to release a mutex");
+  if (pos == -1) {
+    return;
   }
-  mpool[pos].mused = false;
+  mslots.release(pos);
+}
+
+DbConnectionPool::stats_t
+POSTGREDatabase::getPoolStats() {
+  return mslots.getStats();
 }
 
 int
 POSTGREDatabase::startTransaction(){
   int reqPos;
-  getConnection(reqPos);
-  process("BEGIN;", reqPos);
+  PGconn* lconn = getConnection(reqPos);
+  PGresult* res = PQexec(lconn, "BEGIN;");
+  if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBCONN, "Failed to start transaction: " + errorMsg);
+  }
+  PQclear(res);
+  // DO NOT RELEASE THE CONNECTION, KEEPING TRANSACTION
   return reqPos;
 }
 
 void
 POSTGREDatabase::endTransaction(int transactionID) {
-  process("COMMIT;", transactionID);
+  try {
+    commitTransaction(transactionID);
+  } catch (SystemException& e) {
+    releaseConnection(transactionID);
+    throw;
+  }
   releaseConnection(transactionID);
 }
 
 void
 POSTGREDatabase::cancelTransaction(int transactionID) {
-  process("ROLLBACK;", transactionID);
+  PGresult* res = PQexec(mpool[transactionID].mconn, "ROLLBACK;");
+  bool ok = (PQresultStatus(res) == PGRES_COMMAND_OK);
+  PQclear(res);
   releaseConnection(transactionID);
+  if (!ok) {
+    throw SystemException(ERRCODE_DBCONN, "Failed to cancel the transaction");
+  }
 }
 
 void
 POSTGREDatabase::flush(int transactionID){
-  process("COMMIT;", transactionID);
-  releaseConnection(transactionID);
+  // commit what has been done so far and go on with a new transaction
+  // on the same connexion
+  commitTransaction(transactionID);
+  process("BEGIN;", transactionID);
+}
+
+void
+POSTGREDatabase::commitTransaction(int transactionID) {
+  PGconn* lconn = mpool[transactionID].mconn;
+  PGresult* res = PQexec(lconn, "COMMIT;");
+  // COMMIT succeeds with a ROLLBACK status when a request of the
+  // transaction failed
+  bool committed = (PQresultStatus(res) == PGRES_COMMAND_OK
+                    && std::string(PQcmdStatus(res)) == "COMMIT");
+  std::string errorMsg = std::string(PQerrorMessage(lconn));
+  PQclear(res);
+  if (!committed) {
+    if (errorMsg.empty()) {
+      errorMsg = "The transaction was aborted and has been rolled back";
+    }
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
 }
 
 int
@@ -276,13 +481,16 @@ POSTGREDatabase::getRequest(const int key){
 std::string
 POSTGREDatabase::escapeData(const std::string& data)
 {
-  size_t len = data.size();
-  char escapedSql[2*len + 1];
-
-  int connId;
-  PGconn* conn = getConnection(connId);
-  size_t escapedSqlLen = PQescapeStringConn(conn, escapedSql, data.c_str(), len, NULL);
-  releaseConnection(connId);
-
-  return std::string(escapedSql, escapedSqlLen);
+  // the connexions use UTF8, in which quotes and backslashes are never part
+  // of a multibyte character, so no connexion is needed to escape
+  std::string escaped;
+  escaped.reserve(data.size() + 8);
+  std::string::const_iterator c;
+  for (c = data.begin(); c != data.end() && *c != '\0'; ++c) {
+    if (*c == '\'' || (*c == '\\' && !mstdStrings)) {
+      escaped += *c;
+    }
+    escaped += *c;
+  }
+  return escaped;
 }
@@ -8,8 +8,9 @@
 #ifndef _POSTGREDATABASE_H_
 #define _POSTGREDATABASE_H_
 
+#include <map>
 #include <string>
-#include <pthread.h>
+#include <vector>
 
 #include "Database.hpp"
 #include "DatabaseResult.hpp"
@@ -59,6 +60,51 @@ public :
    */
   DatabaseResult*
   getResult(std::string request, int transacId = -1);
+  /**
+   * \brief Function to process a parameterized request, prepared once per
+   * connexion
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters, bound as text
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& request,
+                  const std::vector<std::string>& params,
+                  int transacId = -1);
+  /**
+   * \brief To get the result of a parameterized select request, prepared
+   * once per connexion
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters, bound as text
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& request,
+                    const std::vector<std::string>& params,
+                    int transacId = -1);
+  /**
+   * \brief Function to process several requests in a single round trip,
+   * as one multi-statement query which PostgreSQL runs in an implicit
+   * transaction when none is used
+   * \param requests The requests to process, a single SQL statement each
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processBatch(const std::vector<std::string>& requests, int transacId = -1);
+  /**
+   * \brief To stream the result of a select request through a server side
+   * cursor, fetchSize tuples at a time
+   * \param request The request to process (a single SELECT)
+   * \param handler The callback called for each tuple
+   * \param transacId the id of the transaction if one is used
+   * \return the number of tuples
+   */
+  virtual size_t
+  forEachRow(const std::string& request, const RowHandler& handler,
+             int transacId = -1);
 
   /**
    * \brief To get the type of database
@@ -110,39 +156,67 @@ public :
   getRequest(const int key);
 
   /**
-   * @brief escapeData : transform a sql data to a SQL-escaped string for MySQL
+   * @brief escapeData : transform a sql data to a SQL-escaped string for
+   * PostgreSQL, without using a connexion
    * @param data: the string to transform
    * @return a espaced string
    */
   virtual std::string
   escapeData(const std::string& data);
 
+  /**
+   * \brief To get the usage metrics of the connection pool
+   * \return the metrics
+   */
+  virtual DbConnectionPool::stats_t
+  getPoolStats();
+
+  /**
+   * \brief Maximum number of statements kept prepared on a connexion
+   */
+  static const unsigned maxPreparedStatements;
+
+  /**
+   * \brief Number of tuples fetched at once by forEachRow
+   */
+  static const unsigned fetchSize;
+
 private :
 
   /**
    * \brief An element of the pool
    */
   typedef struct pool_t{
-    /**
-     * \brief If the connexion is used
-     */
-    bool mused;
     /**
      * \brief The connexion
      */
     PGconn* mconn;
     /**
-     * \brief The associated mutex
+     * \brief The statements prepared on the connexion, by request
      */
-    pthread_mutex_t mmutex;
+    std::map<std::string, std::string> mstatements;
+    /**
+     * \brief Suffix of the name of the next prepared statement
+     */
+    unsigned mnextStatement;
   }pool_t;
 
   /**
-   * \brief To get a valid connexion
-   * \param pos The position of the connexion gotten in the pool
+   * \brief To get a valid connexion, waits until one is free
+   * \param pos The position of the connexion gotten in the pool, -1 when
+   * the connexion of a transaction is returned
+   * \param transacId the id of the transaction if one is used
    * \return A valid and free connexion
    */
-  PGconn* getConnection(int& pos);
+  PGconn* getConnection(int& pos, int transacId = -1);
+
+  /**
+   * \brief To check that a connexion is usable and reset it otherwise
+   * \param pos The position of the connexion in the pool
+   * \param probe Whether to make a round trip to the server
+   * \return true if the connexion is usable
+   */
+  bool checkConnection(int pos, bool probe);
 
   /**
    * \brief To release a connexion
@@ -150,6 +224,23 @@ private :
    */
   void releaseConnection(int pos);
 
+  /**
+   * \brief To commit a transaction, keeping its connexion
+   * \param transactionID The ID of the transaction
+   */
+  void commitTransaction(int transactionID);
+
+  /**
+   * \brief To execute a parameterized request, preparing it on the
+   * connexion the first time
+   * \param pos The position of the connexion in the pool
+   * \param request The request
+   * \param params The values of the parameters
+   * \return the result, to clear by the caller
+   */
+  PGresult* execPrepared(int pos, const std::string& request,
+                         const std::vector<std::string>& params);
+
   /////////////////////////////////
   // Attributes
   /////////////////////////////////
@@ -164,10 +255,19 @@ private :
    */
   pool_t *mpool;
 
+  /**
+   * \brief The free positions of the pool
+   */
+  DbConnectionPool mslots;
+
   /**
    * \brief If the connection is right
    */
   bool misConnected;
+  /**
+   * \brief Whether backslashes are ordinary characters in string literals
+   */
+  bool mstdStrings;
   /**
    * \brief Request factory
    */
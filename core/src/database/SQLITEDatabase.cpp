@@ -0,0 +1,414 @@
+/**
+ * \file SQLITEDatabase.cpp
+ * \brief This file implements the embedded SQLite database.
+ */
+#include "SQLITEDatabase.hpp"
+
+#include <climits>
+#include <vector>
+
+#include "DbProfiler.hpp"
+#include "SystemException.hpp"
+
+using namespace std;
+
+namespace {
+  /**
+   * \brief To get the last error of a connection
+   * \param conn the connection
+   * \return the message, between braces
+   */
+  string
+  dbErrorMsg(sqlite3* conn) {
+    return " {" + string(sqlite3_errmsg(conn)) + "}";
+  }
+
+  /**
+   * \brief To execute statements which do not return tuples
+   * \param conn the connection
+   * \param request the statements
+   * \param errorMsg set to the message, between braces, on error
+   * \return the SQLite error code
+   */
+  int
+  execute(sqlite3* conn, const string& request, string& errorMsg) {
+    char* msg = NULL;
+    int res = sqlite3_exec(conn, request.c_str(), NULL, NULL, &msg);
+    if (res != SQLITE_OK) {
+      errorMsg = " {" + string((msg != NULL) ? msg : sqlite3_errstr(res)) + "}";
+    }
+    sqlite3_free(msg);
+    return res;
+  }
+
+  /**
+   * \class SQLITERowResult
+   * \brief The tuple being streamed by forEachRow, read in place
+   */
+  class SQLITERowResult : public DatabaseResult {
+  public :
+    explicit SQLITERowResult(sqlite3_stmt* stmt)
+      : DatabaseResult(), mstmt(stmt), mhasRow(false),
+        mnbFields(sqlite3_column_count(stmt)) {}
+
+    /**
+     * \brief To read the next tuple
+     * \return false when there is no more tuple
+     */
+    bool
+    next() {
+      int res = sqlite3_step(mstmt);
+      mhasRow = (res == SQLITE_ROW);
+      if (!mhasRow && res != SQLITE_DONE) {
+        throw SystemException(ERRCODE_DBERR, "S-Query error" + dbErrorMsg(sqlite3_db_handle(mstmt)));
+      }
+      return mhasRow;
+    }
+
+    virtual size_t
+    getNbTuples() const { return mhasRow ? 1 : 0; }
+
+    virtual size_t
+    getNbFields() const { return mnbFields; }
+
+  protected :
+    virtual const char*
+    getCell(size_t position, size_t field) const {
+      const unsigned char* text = sqlite3_column_text(mstmt, field);
+      return (text != NULL) ? reinterpret_cast<const char*>(text) : "";
+    }
+
+    virtual size_t
+    getCellLength(size_t position, size_t field) const {
+      return sqlite3_column_bytes(mstmt, field);
+    }
+
+    virtual bool
+    isCellNull(size_t position, size_t field) const {
+      return (sqlite3_column_type(mstmt, field) == SQLITE_NULL);
+    }
+
+    virtual std::string
+    getAttributeName(size_t field) const {
+      return std::string(sqlite3_column_name(mstmt, field));
+    }
+
+  private :
+    sqlite3_stmt* mstmt;
+    bool mhasRow;
+    size_t mnbFields;
+  };
+}
+
+int
+SQLITEDatabase::process(string request, int transacId){
+  int reqPos;
+  sqlite3* conn = NULL;
+  if (transacId==-1) {
+    conn = getConnection(reqPos);
+  } else {
+    reqPos = -1;
+    conn = mpool[transacId].mdb;
+  }
+  // the wait for a connection is in the statistics of the pool
+  DbProfiler::Timer timer(mprofiler, request);
+
+  if (request.empty()) {
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "Empty SQL query");
+  }
+  string errorMsg;
+  if (execute(conn, request, errorMsg) != SQLITE_OK) {
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "P-Query error" + errorMsg);
+  }
+  releaseConnection(reqPos);
+  return SUCCESS;
+}
+
+/**
+ * \brief To make a connection to the database
+ * \return raises an exception on error
+ */
+int
+SQLITEDatabase::connect(){
+  for (unsigned int i=0; i<mconfig.getDbPoolSize();i++) {
+    connectPoolIndex(i);
+  }
+  return SUCCESS;
+}
+
+void
+SQLITEDatabase::connectPoolIndex(const int& poolIdx) {
+  if (mpool[poolIdx].mdb != NULL) {
+    sqlite3_close(mpool[poolIdx].mdb);
+    mpool[poolIdx].mdb = NULL;
+  }
+  // the pool gives a connection to a single thread at a time
+  sqlite3* conn = NULL;
+  int res = sqlite3_open_v2(mconfig.getDbName().c_str(), &conn,
+                            SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE|SQLITE_OPEN_NOMUTEX,
+                            NULL);
+  if (res != SQLITE_OK) {
+    string errorMsg = (conn != NULL) ? dbErrorMsg(conn) : "";
+    sqlite3_close(conn);
+    throw SystemException(ERRCODE_DBERR, "Cannot connect to the DB" + errorMsg);
+  }
+  // a writer waits for the others as long as for a free connection
+  unsigned timeout = mconfig.getDbPoolTimeout();
+  sqlite3_busy_timeout(conn, (timeout == 0 || timeout > INT_MAX / 1000) ? INT_MAX : timeout * 1000);
+  string errorMsg;
+  if (execute(conn, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL; PRAGMA foreign_keys=ON;",
+              errorMsg) != SQLITE_OK) {
+    sqlite3_close(conn);
+    throw SystemException(ERRCODE_DBERR, "Cannot connect to the DB" + errorMsg);
+  }
+  mpool[poolIdx].mdb = conn;
+}
+
+/**
+ * \brief Constructor, raises an exception on error
+ */
+SQLITEDatabase::SQLITEDatabase(DbConfiguration dbConfig)
+  : Database(), mconfig(dbConfig),
+    mslots(dbConfig.getDbPoolSize(), dbConfig.getDbPoolTimeout()) {
+  mpool = new pool_t[mconfig.getDbPoolSize()];
+  for (unsigned int i=0;i<mconfig.getDbPoolSize();i++) {
+    mpool[i].mdb = NULL;
+  }
+}
+
+/**
+ * \brief Destructor, raises an exception on error
+ */
+SQLITEDatabase::~SQLITEDatabase(){
+  disconnect();
+  delete [] mpool;
+}
+
+/**
+ * \brief To disconnect from the database
+ * \return 0 on success, an error code otherwise
+ */
+int
+SQLITEDatabase::disconnect(){
+  for (unsigned int i = 0 ; i < mconfig.getDbPoolSize() ; i++) {
+    // the last connection closed checkpoints the WAL into the database file
+    sqlite3_close(mpool[i].mdb);
+    mpool[i].mdb = NULL;
+  }
+  return SUCCESS;
+}
+
+/**
+ * \brief To get the result of the latest request (if any result)
+ * \param transacId the id of the transaction if one is used
+ * \return The result of the latest request
+ */
+DatabaseResult*
+SQLITEDatabase::getResult(string request, int transacId) {
+  int reqPos;
+  sqlite3* conn = NULL;
+  if (transacId==-1) {
+    conn = getConnection(reqPos);
+  } else {
+    reqPos = -1;
+    conn = mpool[transacId].mdb;
+  }
+  DbProfiler::Timer timer(mprofiler, request);
+  sqlite3_stmt* stmt = NULL;
+  if (sqlite3_prepare_v2(conn, request.c_str(), request.length(), &stmt, NULL) != SQLITE_OK) {
+    string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "S-Query error" + errorMsg);
+  }
+  vector<string> attributesNames;
+  int size = sqlite3_column_count(stmt);
+  for (int i = 0; i < size; i++) {
+    attributesNames.push_back(string(sqlite3_column_name(stmt, i)));
+  }
+  // Fetch data rows
+  vector<string> rowStr;
+  vector<vector<string> > results;
+  int res;
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    rowStr.clear();
+    for (int i = 0; i < size; i++) {
+      const unsigned char* text = sqlite3_column_text(stmt, i);
+      rowStr.push_back((text != NULL)
+                       ? string(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, i))
+                       : string());
+    }
+    results.push_back(rowStr);
+  }
+  string errorMsg = dbErrorMsg(conn);
+  sqlite3_finalize(stmt);
+  releaseConnection(reqPos);
+  if (res != SQLITE_DONE) {
+    throw SystemException(ERRCODE_DBERR, "S-Query error" + errorMsg);
+  }
+  return new DatabaseResult(results, attributesNames);
+}
+
+size_t
+SQLITEDatabase::forEachRow(const std::string& request, const RowHandler& handler,
+                           int transacId) {
+  int reqPos;
+  sqlite3* conn = NULL;
+  if (transacId==-1) {
+    conn = getConnection(reqPos);
+  } else {
+    reqPos = -1;
+    conn = mpool[transacId].mdb;
+  }
+  // the time to handle the tuples is counted too
+  DbProfiler::Timer timer(mprofiler, request);
+  sqlite3_stmt* stmt = NULL;
+  if (sqlite3_prepare_v2(conn, request.c_str(), request.length(), &stmt, NULL) != SQLITE_OK) {
+    string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "S-Query error" + errorMsg);
+  }
+  size_t nbTuples = 0;
+  try {
+    // the tuples are stepped through, not copied
+    SQLITERowResult row(stmt);
+    while (row.next()) {
+      handler(row.getRow(0));
+      ++nbTuples;
+    }
+  } catch (...) {
+    sqlite3_finalize(stmt);
+    releaseConnection(reqPos);
+    throw;
+  }
+  sqlite3_finalize(stmt);
+  releaseConnection(reqPos);
+  return nbTuples;
+}
+
+sqlite3*
+SQLITEDatabase::getConnection(int& id){
+  id = mslots.acquire();
+  if (mpool[id].mdb == NULL) {
+    try {
+      connectPoolIndex(id);
+    } catch (SystemException& e) {
+      mslots.release(id);
+      throw;
+    }
+  }
+  return mpool[id].mdb;
+}
+
+void
+SQLITEDatabase::releaseConnection(int pos) {
+  if (pos==-1){
+    return;
+  }
+  mslots.release(pos);
+}
+
+DbConnectionPool::stats_t
+SQLITEDatabase::getPoolStats() {
+  return mslots.getStats();
+}
+
+int
+SQLITEDatabase::startTransaction() {
+  int reqPos;
+  sqlite3* conn = getConnection(reqPos);
+  // the write lock is taken now, a deferred transaction could not take it
+  // later without failing when another one has written meanwhile
+  string errorMsg;
+  if (execute(conn, "BEGIN IMMEDIATE;", errorMsg) != SQLITE_OK) {
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBCONN, "Failed to start transaction" + errorMsg);
+  }
+  // DO NOT RELEASE THE CONNECTION, KEEPING TRANSACTION
+  return reqPos;
+}
+
+void
+SQLITEDatabase::endTransaction(int transactionID) {
+  sqlite3* conn = mpool[transactionID].mdb;
+  string errorMsg;
+  if (execute(conn, "COMMIT;", errorMsg) != SQLITE_OK) {
+    string ignored;
+    execute(conn, "ROLLBACK;", ignored);
+    releaseConnection(transactionID);
+    throw SystemException(ERRCODE_DBCONN, "Failed to commit the transaction" + errorMsg);
+  }
+  releaseConnection(transactionID);
+}
+
+void
+SQLITEDatabase::cancelTransaction(int transactionID) {
+  sqlite3* conn = mpool[transactionID].mdb;
+  string errorMsg;
+  int res = execute(conn, "ROLLBACK;", errorMsg);
+  releaseConnection(transactionID);
+  if (res != SQLITE_OK) {
+    throw SystemException(ERRCODE_DBCONN, "Failed to cancel the transaction" + errorMsg);
+  }
+}
+
+void
+SQLITEDatabase::flush(int transactionID){
+  // commit what has been done so far and go on with a new transaction
+  // on the same connexion
+  string errorMsg;
+  if (execute(mpool[transactionID].mdb, "COMMIT; BEGIN IMMEDIATE;", errorMsg) != SQLITE_OK) {
+    throw SystemException(ERRCODE_DBERR, "Failed to commit the transaction" + errorMsg);
+  }
+}
+
+int
+SQLITEDatabase::generateId(string table, string fields, string val, int tid, std::string primary) {
+  // the rowid must be read on the connection which inserted
+  int reqPos;
+  sqlite3* conn = NULL;
+  if (tid==-1) {
+    conn = getConnection(reqPos);
+  } else {
+    reqPos = -1;
+    conn = mpool[tid].mdb;
+  }
+  string errorMsg;
+  if (execute(conn, "INSERT INTO "+table+ fields + " values " +val, errorMsg) != SQLITE_OK) {
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "P-Query error" + errorMsg);
+  }
+  sqlite3_int64 id = sqlite3_last_insert_rowid(conn);
+  releaseConnection(reqPos);
+  return static_cast<int>(id);
+}
+
+string
+SQLITEDatabase::getRequest(const int key){
+  return msqlitefact.get(key);
+}
+
+/**
+ * @brief escapeData : transform a sql data to a SQL-escaped string
+ * @param data: the string to transform
+ * @return a espaced string
+ */
+std::string
+SQLITEDatabase::escapeData(const std::string& data)
+{
+  // only the quote is special in a SQLite string literal, a NUL byte
+  // would end the request
+  std::string escaped;
+  escaped.reserve(data.size() + 8);
+  std::string::const_iterator c;
+  for (c = data.begin(); c != data.end(); ++c) {
+    if (*c == '\'') {
+      escaped += '\'';
+    } else if (*c == '\0') {
+      continue;
+    }
+    escaped += *c;
+  }
+  return escaped;
+}
@@ -0,0 +1,205 @@
+/**
+ * \file SQLITEDatabase.hpp
+ * \brief This file presents an embedded SQLite database.
+ */
+
+#ifndef _SQLITEDATABASE_H_
+#define _SQLITEDATABASE_H_
+
+#include <string>
+
+#include "Database.hpp"
+#include "DatabaseResult.hpp"
+#include "DbConfiguration.hpp"
+#include "SQLITERequestFactory.hpp"
+
+#include "sqlite3.h"
+
+/**
+ * \class SQLITEDatabase
+ * \brief SQLite implementation of the Database, for the single-node
+ * deployments. The database name is the path of the database file, which
+ * is opened in WAL mode: the readers do not block the writer, the writers
+ * wait for each other up to the pool timeout.
+ */
+class SQLITEDatabase : public Database{
+public :
+  /**
+   * \brief Function to process the request in the database
+   * \param request The request to process (may contain several statements)
+   * \param transacId the id of the transaction if one is used
+   * \return 0 on success, an error code otherwise
+   */
+  int
+  process(std::string request, int transacId = -1);
+  /**
+  * \brief To open the pool of connections to the database file
+  * \return raises an exception on error
+  */
+  int
+  connect();
+
+  /**
+   * \brief Constructor, raises an exception on error
+   * \param dbConfig  the configuration of the database client
+   */
+  SQLITEDatabase(DbConfiguration dbConfig);
+
+  /**
+   * \brief Destructor, raises an exception on error
+   */
+  ~SQLITEDatabase();
+
+  /**
+  * \brief To get the result of a select request
+  * \param request The request to process
+  * \param transacId the id of the transaction if one is used
+  * \return An object which encapsulates the database results
+  */
+  DatabaseResult*
+  getResult(std::string request, int transacId = -1);
+
+  /**
+   * \brief To get the type of database
+   * \return An enum identifying the type of database
+   */
+  DbConfiguration::db_type_t
+  getDbType() { return DbConfiguration::SQLITE; }
+
+  /**
+ * \brief Start a transaction, it takes the write lock of the database
+ * \return The transaction ID
+ */
+  virtual int
+  startTransaction();
+
+  /**
+ * \brief End a transaction
+ * \param transactionID: The ID of the transaction
+ */
+  virtual void
+  endTransaction(int transactionID);
+
+  /**
+ * \brief Cancel a transaction
+ * \param transactionID: The ID of the transaction
+ */
+  virtual void
+  cancelTransaction(int transactionID);
+
+  /**
+ * \brief To commit a transaction
+ * \param transactionID: The ID of the transaction
+ */
+  virtual void
+  flush(int transactionID);
+  /**
+ * \brief To get a unique id
+ * \param table: The table to use to generate the id
+ * \param fields: The fields of the table
+ * \param val: The values of the fields to insert
+ * \param tid: The transaction id
+ * \param primary the primary key on the table
+ * \return A new integer never returned by this function
+ */
+  virtual int
+  generateId(std::string table, std::string fields, std::string val, int tid, std::string primary);
+/**
+ * \brief To get a request from a request file based on a key
+ * \param key the key indicating the request to get
+ * \return the corresponding sql request
+ */
+  virtual std::string
+  getRequest(const int key);
+
+  /**
+   * @brief escapeData : transform a sql data to a SQL-escaped string for SQLite
+   * @param data: the string to transform
+   * @return a espaced string
+   */
+  virtual std::string
+  escapeData(const std::string& data);
+
+  /**
+   * \brief To stream the result of a select request, the tuples are read
+   * from the database file as they are consumed
+   * \param request The request to process (a single SELECT)
+   * \param handler The callback called for each tuple
+   * \param transacId the id of the transaction if one is used
+   * \return the number of tuples
+   */
+  virtual size_t
+  forEachRow(const std::string& request, const RowHandler& handler,
+             int transacId = -1);
+
+  /**
+   * \brief To get the usage metrics of the connection pool
+   * \return the metrics
+   */
+  virtual DbConnectionPool::stats_t
+  getPoolStats();
+
+private :
+  /**
+  * \brief To open the database file and store the handler to a given pool's index
+  * \param poolIdx the index in connexion pool
+  * \return raises an exception on error
+  */
+  void connectPoolIndex(const int& poolIdx);
+
+  /**
+   * \brief To get a valid connexion
+   * \param pos The position of the connection gotten in the pool
+   * \return A valid and free connection
+   */
+  sqlite3* getConnection(int& pos);
+
+  /**
+   * \brief To release a connexion
+   * \param pos The position of the connection to release
+   */
+  void releaseConnection(int pos);
+
+  /**
+   * \brief An element of the pool
+   */
+  typedef struct pool_t{
+    /**
+     * \brief The connection to the database file, NULL if not opened
+     */
+    sqlite3* mdb;
+  }pool_t;
+  /////////////////////////////////
+  // Attributes
+  /////////////////////////////////
+  /**
+   * \brief The configuration of the database client
+   */
+  DbConfiguration mconfig;
+  /**
+   * \brief The pool of connection
+   */
+  pool_t *mpool;
+  /**
+   * \brief The slots of the pool, to wait for a free connection
+   */
+  DbConnectionPool mslots;
+
+  /////////////////////////////////
+  // Functions
+  /////////////////////////////////
+  /**
+   * \brief To disconnect from the database
+   * \return 0 on success, an error code otherwise
+   */
+  int
+  disconnect();
+
+  /**
+   * \brief Request factory
+   */
+  SQLITERequestFactory msqlitefact;
+};
+
+
+#endif // SQLITEDATABASE
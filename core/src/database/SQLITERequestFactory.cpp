@@ -0,0 +1,19 @@
+
+#include "SQLITERequestFactory.hpp"
+#include "RequestFactory.hpp"
+#include <map>
+
+// SQLite has no joined UPDATE, the rows are selected by a subquery
+SQLITERequestFactory::SQLITERequestFactory():RequestFactory(){
+  mrequest.insert (std::pair<int, std::string>(VR_UPDATE_ACCOUNT_WITH_USERS, "update account set status=%1% where users_numuserid in (select numuserid from users where userid='%2%');"));
+  mrequest.insert (std::pair<int, std::string>(VR_UPDATE_ACCOUNT_WITH_MACHINE, "update account set status=%1% where machine_nummachineid in (select nummachineid from machine where machineid='%2%');"));
+  mrequest.insert (std::pair<int, std::string>(VR_UPDATE_AUTHACCOUNT_WITH_AUTHSYSTEM, "update authaccount set status=%1% where authsystem_authsystemid in (select numauthsystemid from authsystem where authsystemid='%2%');"));
+}
+
+SQLITERequestFactory::~SQLITERequestFactory(){
+}
+
+std::string
+SQLITERequestFactory::get(const int key){
+  return mrequest[key];
+}
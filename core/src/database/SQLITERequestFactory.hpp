@@ -0,0 +1,23 @@
+/**
+ * \file SQLITERequestFactory.hpp
+ * \brief This file implements the request factory for sqlite
+ */
+
+#ifndef _SQLITEREQUESTFACTORY_H_
+#define _SQLITEREQUESTFACTORY_H_
+
+#include "RequestFactory.hpp"
+#include <string>
+
+class SQLITERequestFactory : RequestFactory {
+public:
+  SQLITERequestFactory();
+
+  ~SQLITERequestFactory();
+
+  virtual std::string
+  get(const int key);
+
+};
+
+#endif // SQLITEREQUESTFACTORY
@@ -0,0 +1,128 @@
+/**
+ * \file HashingPool.cpp
+ * \brief This file implements the pool of threads hashing the passwords
+ */
+#include "HashingPool.hpp"
+
+#ifndef BSD_LIKE_SYSTEM
+#include <crypt.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/once.hpp>
+
+#include "SystemException.hpp"
+
+HashingPool* HashingPool::minstance = NULL;  //%RELAX<MISRA_0_1_3> Used in this file
+
+namespace {
+  /**
+   * \brief Guards the creation of the pool of the process
+   */
+  boost::once_flag instanceFlag = BOOST_ONCE_INIT;
+
+#ifdef BSD_LIKE_SYSTEM
+  /**
+   * \brief Serializes crypt, which has no reentrant version here
+   */
+  boost::mutex cryptMutex;
+#endif
+}
+
+HashingPool::HashingPool(unsigned nbThreads)
+  : mstopping(false) {
+  for (unsigned i = 0; i < std::max(nbThreads, 1U); ++i) {
+    mthreads.create_thread(boost::bind(&HashingPool::run, this));
+  }
+}
+
+HashingPool::~HashingPool() {
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mstopping = true;
+  }
+  mpending.notify_all();
+  mthreads.join_all();
+}
+
+std::string
+HashingPool::hash(const std::string& key, const std::string& salt) {
+  task_t task;
+  task.key = &key;
+  task.salt = &salt;
+  task.done = false;
+  task.failed = false;
+  {
+    boost::unique_lock<boost::mutex> lock(mmutex);
+    mtasks.push_back(&task);
+    mpending.notify_one();
+    while (!task.done) {
+      mdone.wait(lock);
+    }
+  }
+  if (task.failed) {
+    throw SystemException(ERRCODE_SYSTEM, "Cannot hash the password");
+  }
+  return task.result;
+}
+
+HashingPool&
+HashingPool::getInstance() {
+  boost::call_once(&HashingPool::createInstance, instanceFlag);
+  return *minstance;
+}
+
+void
+HashingPool::createInstance() {
+  // never destroyed, the threads may hash until the exit
+  minstance = new HashingPool(boost::thread::hardware_concurrency());
+}
+
+void
+HashingPool::run() {
+#ifndef BSD_LIKE_SYSTEM
+  // the state of crypt_r is large, allocated once per thread
+  boost::scoped_ptr<struct crypt_data> data(new struct crypt_data);
+  memset(data.get(), 0, sizeof(struct crypt_data));
+#endif
+  boost::unique_lock<boost::mutex> lock(mmutex);
+  while (true) {
+    while (mtasks.empty() && !mstopping) {
+      mpending.wait(lock);
+    }
+    if (mtasks.empty()) {
+      return;
+    }
+    task_t* task = mtasks.front();
+    mtasks.pop_front();
+    lock.unlock();
+
+    std::string result;
+    bool failed = false;
+    {
+#ifndef BSD_LIKE_SYSTEM
+      const char* encrypted = crypt_r(task->key->c_str(), task->salt->c_str(), data.get());
+#else
+      boost::lock_guard<boost::mutex> cryptLock(cryptMutex);
+      const char* encrypted = crypt(task->key->c_str(), task->salt->c_str());
+#endif
+      // a failure is NULL or a string starting with '*'
+      if (encrypted == NULL || encrypted[0] == '*') {
+        failed = true;
+      } else {
+        result = encrypted;
+      }
+    }
+
+    lock.lock();
+    task->result = result;
+    task->failed = failed;
+    task->done = true;
+    mdone.notify_all();
+  }
+}
@@ -0,0 +1,123 @@
+/**
+ * \file HashingPool.hpp
+ * \brief This file defines the pool of threads hashing the passwords
+ */
+
+#ifndef _HASHINGPOOL_H_
+#define _HASHINGPOOL_H_
+
+#include <deque>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/**
+ * \class HashingPool
+ * \brief A bounded number of threads hashing the passwords with crypt_r,
+ * each with its own state. A hash takes milliseconds of CPU: the callers
+ * wait for a thread of the pool, so that at most that many hashes run at
+ * once while the other requests are served.
+ */
+class HashingPool : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor, starts the threads
+   * \param nbThreads the number of threads, at least one
+   */
+  explicit HashingPool(unsigned nbThreads);
+
+  /**
+   * \brief Destructor, hashes the pending keys and stops the threads
+   */
+  ~HashingPool();
+
+  /**
+   * \brief Hash a key, waits until a thread of the pool has done it
+   * \param key the key
+   * \param salt the salt, with the prefix of the method, e.g. $6$salt$
+   * \return the hash, prefixed by the salt
+   */
+  std::string
+  hash(const std::string& key, const std::string& salt);
+
+  /**
+   * \brief Get the pool of the process, with a thread per core, created
+   * at the first call
+   * \return the pool
+   */
+  static HashingPool&
+  getInstance();
+
+private:
+  /**
+   * \brief A key to hash
+   */
+  typedef struct task_t {
+    /**
+     * \brief The key
+     */
+    const std::string* key;
+    /**
+     * \brief The salt
+     */
+    const std::string* salt;
+    /**
+     * \brief The hash
+     */
+    std::string result;
+    /**
+     * \brief Whether the hash is done
+     */
+    bool done;
+    /**
+     * \brief Whether the hash failed, e.g. an unknown method
+     */
+    bool failed;
+  } task_t;
+
+  /**
+   * \brief The body of the threads
+   */
+  void
+  run();
+
+  /**
+   * \brief Create the pool of the process
+   */
+  static void
+  createInstance();
+
+  /**
+   * \brief The pool of the process
+   */
+  static HashingPool* minstance;
+
+  /**
+   * \brief Protects the tasks
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief Signaled when a task is added or the pool stops
+   */
+  boost::condition_variable mpending;
+  /**
+   * \brief Signaled when a task is done
+   */
+  boost::condition_variable mdone;
+  /**
+   * \brief The tasks waiting for a thread
+   */
+  std::deque<task_t*> mtasks;
+  /**
+   * \brief Whether the threads must stop
+   */
+  bool mstopping;
+  /**
+   * \brief The threads
+   */
+  boost::thread_group mthreads;
+};
+
+#endif // _HASHINGPOOL_H_
@@ -0,0 +1,159 @@
+/**
+ * \file QueryPage.cpp
+ * \brief This file implements the page requested from a list service
+ */
+
+#include "QueryPage.hpp"
+
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <ecorecpp.hpp>
+
+#include "UserException.hpp"
+
+namespace {
+  /**
+   * \brief The digits of the tokens
+   */
+  const char hexDigits[] = "0123456789abcdef";
+
+  /**
+   * \brief Whether a name of field is valid
+   * \param field the name
+   * \return true if it only has letters, digits and underscores
+   */
+  bool
+  isValidField(const std::string& field) {
+    if (field.empty()) {
+      return false;
+    }
+    for (size_t i = 0; i < field.size(); ++i) {
+      char c = field[i];
+      if (!isalnum(static_cast<unsigned char>(c)) && c != '_') {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+QueryPage::QueryPage()
+  : msize(0) {
+}
+
+QueryPage::QueryPage(size_t size, const std::string& token)
+  : msize(size), mtoken(token) {
+}
+
+void
+QueryPage::setFields(const std::vector<std::string>& fields) {
+  for (size_t i = 0; i < fields.size(); ++i) {
+    if (!isValidField(fields[i])) {
+      throw UserException(ERRCODE_INVALID_PARAM, "Invalid field: " + fields[i]);
+    }
+  }
+  mfields = fields;
+}
+
+bool
+QueryPage::isDefault() const {
+  return msize == 0 && mtoken.empty() && mfields.empty();
+}
+
+std::string
+QueryPage::serialize() const {
+  return boost::lexical_cast<std::string>(msize) + ";" + mtoken + ";" + boost::join(mfields, ",");
+}
+
+QueryPage
+QueryPage::deserialize(const std::string& value) {
+  QueryPage page;
+  if (value.empty()) {
+    return page;
+  }
+
+  std::vector<std::string> parts;
+  boost::split(parts, value, boost::is_any_of(";"));
+  if (parts.size() != 3) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid page: " + value);
+  }
+  try {
+    page.msize = boost::lexical_cast<size_t>(parts[0]);
+  } catch (boost::bad_lexical_cast&) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid page size: " + parts[0]);
+  }
+  decodeToken(parts[1]);
+  page.mtoken = parts[1];
+  if (!parts[2].empty()) {
+    std::vector<std::string> fields;
+    boost::split(fields, parts[2], boost::is_any_of(","));
+    page.setFields(fields);
+  }
+  return page;
+}
+
+std::string
+QueryPage::encodeToken(const std::string& key) {
+  std::string token;
+  token.reserve(2 * key.size());
+  for (size_t i = 0; i < key.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(key[i]);
+    token += hexDigits[c >> 4];
+    token += hexDigits[c & 0x0f];
+  }
+  return token;
+}
+
+std::string
+QueryPage::decodeToken(const std::string& token) {
+  if (token.size() % 2 != 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid continuation token");
+  }
+  std::string key;
+  key.reserve(token.size() / 2);
+  for (size_t i = 0; i < token.size(); i += 2) {
+    const char* high = std::find(hexDigits, hexDigits + 16, token[i]);
+    const char* low = std::find(hexDigits, hexDigits + 16, token[i + 1]);
+    if (high == hexDigits + 16 || low == hexDigits + 16) {
+      throw UserException(ERRCODE_INVALID_PARAM, "Invalid continuation token");
+    }
+    key += static_cast<char>(((high - hexDigits) << 4) | (low - hexDigits));
+  }
+  return key;
+}
+
+void
+QueryPage::project(::ecore::EObject_ptr list) const {
+  if (mfields.empty() || list == NULL) {
+    return;
+  }
+  // the listed objects are the contents of the list object
+  const ::ecorecpp::mapping::EList< ::ecore::EReference >& references = list->eClass()->getEAllReferences();
+  for (size_t i = 0; i < references.size(); ++i) {
+    ::ecore::EReference_ptr reference = references[i];
+    if (!reference->isContainment() || reference->getUpperBound() == 1) {
+      continue;
+    }
+    ::ecorecpp::mapping::EList_ptr children =
+      ::ecorecpp::mapping::any::any_cast< ::ecorecpp::mapping::EList_ptr >(list->eGet(reference));
+    for (size_t j = 0; j < children->size(); ++j) {
+      projectObject((*children)[j]);
+    }
+  }
+}
+
+void
+QueryPage::projectObject(::ecore::EObject_ptr object) const {
+  ::ecore::EClass_ptr eclass = object->eClass();
+  // a new object holds the default values, which are not serialized
+  boost::scoped_ptr< ::ecore::EObject> blank(eclass->getEPackage()->getEFactoryInstance()->create(eclass));
+  const ::ecorecpp::mapping::EList< ::ecore::EAttribute >& attributes = eclass->getEAllAttributes();
+  for (size_t i = 0; i < attributes.size(); ++i) {
+    ::ecore::EAttribute_ptr attribute = attributes[i];
+    if (std::find(mfields.begin(), mfields.end(), attribute->getName()) == mfields.end()) {
+      object->eSet(attribute, blank->eGet(attribute));
+    }
+  }
+}
@@ -0,0 +1,134 @@
+/**
+ * \file QueryPage.hpp
+ * \brief This file defines the page requested from a list service
+ */
+
+#ifndef _QUERYPAGE_H_
+#define _QUERYPAGE_H_
+
+#include <string>
+#include <vector>
+#include <ecore.hpp>
+
+/**
+ * \class QueryPage
+ * \brief The page of a list service requested by a client: at most a number
+ * of rows following those of the previous page, and optionally only some
+ * fields of the listed objects. The pages are listed by a unique key of the
+ * rows: the continuation token is the opaque key of the last row of the
+ * previous page, so that a page costs the same whatever its position.
+ */
+class QueryPage {
+public:
+  /**
+   * \brief Constructor, every row with every field
+   */
+  QueryPage();
+
+  /**
+   * \brief Constructor
+   * \param size the maximum number of rows, 0 for every row
+   * \param token the continuation token returned with the previous page,
+   * empty for the first page
+   */
+  explicit QueryPage(size_t size, const std::string& token = "");
+
+  /**
+   * \brief Get the maximum number of rows
+   * \return the number of rows, 0 for every row
+   */
+  size_t
+  getSize() const { return msize; }
+
+  /**
+   * \brief Get the continuation token
+   * \return the token, empty for the first page
+   */
+  const std::string&
+  getToken() const { return mtoken; }
+
+  /**
+   * \brief Get the fields kept on the listed objects
+   * \return the names of the fields, empty for every field
+   */
+  const std::vector<std::string>&
+  getFields() const { return mfields; }
+
+  /**
+   * \brief Set the fields kept on the listed objects
+   * \param fields the names of the attributes of the objects, as in the
+   * model, e.g. userId
+   */
+  void
+  setFields(const std::vector<std::string>& fields);
+
+  /**
+   * \brief Whether every row and every field are requested
+   * \return true if nothing is restricted
+   */
+  bool
+  isDefault() const;
+
+  /**
+   * \brief Serialize the page, to send it along with the options
+   * \return the serialized page
+   */
+  std::string
+  serialize() const;
+
+  /**
+   * \brief Read a serialized page, raises an exception if it is invalid
+   * \param value the serialized page, empty for the default page
+   * \return the page
+   */
+  static QueryPage
+  deserialize(const std::string& value);
+
+  /**
+   * \brief Build the continuation token following a row
+   * \param key the value of the key of the row
+   * \return the token
+   */
+  static std::string
+  encodeToken(const std::string& key);
+
+  /**
+   * \brief Read the key of a continuation token, raises an exception if it
+   * is invalid
+   * \param token the token
+   * \return the value of the key
+   */
+  static std::string
+  decodeToken(const std::string& token);
+
+  /**
+   * \brief Reset the fields which are not requested on the objects
+   * contained in a list object, they are then not serialized
+   * \param list the list object
+   */
+  void
+  project(::ecore::EObject_ptr list) const;
+
+private:
+  /**
+   * \brief Reset the fields which are not requested on an object
+   * \param object the object
+   */
+  void
+  projectObject(::ecore::EObject_ptr object) const;
+
+  /**
+   * \brief The maximum number of rows, 0 for every row
+   */
+  size_t msize;
+  /**
+   * \brief The continuation token
+   */
+  std::string mtoken;
+  /**
+   * \brief The fields kept, empty for every field
+   */
+  std::vector<std::string> mfields;
+};
+
+#endif // _QUERYPAGE_H_
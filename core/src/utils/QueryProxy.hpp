@@ -17,6 +17,7 @@
 #include "DIET_client.h"
 #include "utilsClient.hpp"
 #include "SessionProxy.hpp"
+#include "QueryPage.hpp"
 
 /**
  * \brief SerializeAdaptor class implementation
@@ -98,6 +99,20 @@ public:
   std::string
   getMachineId() const;
 
+  /**
+   * \brief Function to restrict the listing to a page, every row by default
+   * \param page The page, with the continuation token of the previous one
+   */
+  void
+  setPage(const QueryPage& page);
+
+  /**
+   * \brief Function to get the continuation token returned with the listing
+   * \return the token to request the next page, empty if there is none
+   */
+  std::string
+  getNextToken() const;
+
   /**
    * \brief Function to list QueryProxy information
    * \return The pointer to the ListOject containing list information
@@ -146,6 +161,14 @@ private:
    * \brief The id of the machine used by the query
    */
   std::string mmachineId;
+  /**
+   * \brief The page requested
+   */
+  QueryPage mpage;
+  /**
+   * \brief The continuation token returned with the listing
+   */
+  std::string mnextToken;
 };
 
 /**
@@ -204,6 +227,26 @@ QueryProxy<QueryParameters, ListObject>::getMachineId() const {
   return mmachineId;
 }
 
+/**
+ * \brief Function to restrict the listing to a page
+ * \param page The page, with the continuation token of the previous one
+ */
+template <class QueryParameters, class ListObject>
+void
+QueryProxy<QueryParameters, ListObject>::setPage(const QueryPage& page) {
+  mpage = page;
+}
+
+/**
+ * \brief Function to get the continuation token returned with the listing
+ * \return the token to request the next page, empty if there is none
+ */
+template <class QueryParameters, class ListObject>
+std::string
+QueryProxy<QueryParameters, ListObject>::getNextToken() const {
+  return mnextToken;
+}
+
 /**
  * \brief Function to list QueryProxy information
  * \return The pointer to the ListOject containing list information
@@ -213,12 +256,13 @@ template <class QueryParameters, class ListObject>
 ListObject* QueryProxy<QueryParameters, ListObject>::list() {
 
   //If the query uses the machineId (machineId not null)
-  diet_profile_t* profile =NULL;
-  if (! mmachineId.empty()) {
-    profile = diet_profile_alloc(mserviceName, 3);
-  } else {
-    profile = diet_profile_alloc(mserviceName, 2);
+  int nbParams = (! mmachineId.empty()) ? 3 : 2;
+  //The page is sent after the other parameters, only when requested
+  int pagePos = nbParams;
+  if (! mpage.isDefault()) {
+    ++nbParams;
   }
+  diet_profile_t* profile = diet_profile_alloc(mserviceName, nbParams);
 
   std::string queryParmetersToString =  SerializeAdaptor<QueryParameters>::serialize(mparameters);
 
@@ -231,6 +275,9 @@ ListObject* QueryProxy<QueryParameters, ListObject>::list() {
   } else {
     diet_string_set(profile, 1, queryParmetersToString);
   }
+  if (! mpage.isDefault()) {
+    diet_string_set(profile, pagePos, mpage.serialize());
+  }
 
   if (diet_call(profile)) {
     raiseCommunicationMsgException("RPC call failed");
@@ -242,6 +289,11 @@ ListObject* QueryProxy<QueryParameters, ListObject>::list() {
   diet_string_get(profile,1, listObjectInString);
   parseEmfObject(listObjectInString, mlistObject, "Error by receiving List object serialized");
 
+  mnextToken.clear();
+  if (profile->param_count > 2) {
+    diet_string_get(profile, 2, mnextToken);
+  }
+
   return mlistObject;
 }
 
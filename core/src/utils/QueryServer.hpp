@@ -19,6 +19,9 @@
 #include "UMSVishnuException.hpp"
 #include "TMSVishnuException.hpp"
 #include "constants.hpp"
+#include "utilServer.hpp"
+#include "utilVishnu.hpp"
+#include "QueryPage.hpp"
 
 /**
  * \class QueryServer
@@ -36,10 +39,25 @@ public:
   QueryServer(void)
   {
     mlistObject = NULL;
+    mlisted = 0;
     DbFactory factory;
     mdatabaseInstance = factory.getDatabaseInstance();
   }
 
+  /**
+    * \brief Constructor of a query that may read from a replica of the
+    * database, raises an exception on error
+    * \param sessionKey The key of the session, whose own changes must be read
+    */
+  explicit
+  QueryServer(const std::string& sessionKey)
+  {
+    mlistObject = NULL;
+    mlisted = 0;
+    DbFactory factory;
+    mdatabaseInstance = factory.getReadDatabaseInstance(sessionKey);
+  }
+
   /**
    * \brief Function to list query information
    * \return The pointer to the ListOject containing list information
@@ -53,6 +71,22 @@ public:
    */
   virtual std::string getCommandName() = 0;
 
+  /**
+   * \brief Function to set the page to list, every row by default
+   * \param page The page requested by the client
+   */
+  void setPage(const QueryPage& page) {
+    mpage = page;
+  }
+
+  /**
+   * \brief Function to get the continuation token of the next page
+   * \return The token, empty if the listed page is the last one
+   */
+  const std::string& getNextToken() const {
+    return mnextToken;
+  }
+
   /**
    * \brief Destructor, raises an exception on error
    */
@@ -61,6 +95,49 @@ public:
   }
 
 protected:
+  /**
+   * \brief Function to add the keyset condition, the order and the limit of
+   * the requested page to a given request. One more row than the page is
+   * read, to know whether a next page exists.
+   * \param key The unique column the rows are listed by, selected by the
+   * request and given to addToPage for each row
+   * \param request The request
+   * \return false if every row is requested, the request must then be
+   * ordered as usual
+   */
+  bool addPageRequest(const std::string& key, std::string& request) {
+    mlisted = 0;
+    mnextToken.clear();
+    if (mpage.getSize() == 0) {
+      return false;
+    }
+    if (! mpage.getToken().empty()) {
+      request.append(" and "+key+" > ");
+      request.append("'"+mdatabaseInstance->escapeData(QueryPage::decodeToken(mpage.getToken()))+"'");
+    }
+    request.append(" order by "+key+" limit "+vishnu::convertToString(mpage.getSize() + 1));
+    return true;
+  }
+
+  /**
+   * \brief Function to count a row read by a request of addPageRequest
+   * \param key The value of the key of the row
+   * \return false if the page is full: the row is the first of the next
+   * page and must not be listed
+   */
+  bool addToPage(const std::string& key) {
+    if (mpage.getSize() == 0) {
+      return true;
+    }
+    if (mlisted == mpage.getSize()) {
+      mnextToken = QueryPage::encodeToken(mlastKey);
+      return false;
+    }
+    ++mlisted;
+    mlastKey = key;
+    return true;
+  }
+
   /**
    * \brief Function to add sql resquest "and condition" to a given request
    * \param name The column name of the data base table
@@ -212,9 +289,11 @@ protected:
    */
   void checkSessionId(std::string sessionId) {
     std::string sqlSessionRequest = (boost::format("SELECT vsessionid"
-                                                   " FROM vsession"
-                                                   " WHERE vsessionid='%1%'"
-                                                   " AND state<>%2%")%mdatabaseInstance->escapeData(sessionId) %vishnu::STATUS_DELETED).str();
+                                                   " FROM %1%"
+                                                   " WHERE vsessionid='%2%'"
+                                                   " AND state<>%3%")
+                                     %vishnu::getHistoryTable("vsession")
+                                     %mdatabaseInstance->escapeData(sessionId) %vishnu::STATUS_DELETED).str();
     boost::scoped_ptr<DatabaseResult> session(mdatabaseInstance->getResult(sqlSessionRequest.c_str()));
     if(session->getNbTuples()==0) {
       throw UMSVishnuException(ERRCODE_UNKNOWN_SESSION_ID);
@@ -249,8 +328,9 @@ protected:
   void
   checkJobId(std::string jobId) {
     std::string sqlJobRequest = (boost::format("SELECT numjobid"
-                                               " FROM job"
-                                               " WHERE jobId='%1%'")%mdatabaseInstance->escapeData(jobId)).str();
+                                               " FROM %1%"
+                                               " WHERE jobId='%2%'")
+                                 %vishnu::getHistoryTable("job") %mdatabaseInstance->escapeData(jobId)).str();
     boost::scoped_ptr<DatabaseResult> result (mdatabaseInstance->getResult(sqlJobRequest.c_str()));
     if(result->getNbTuples() == 0) {
       throw TMSVishnuException(ERRCODE_UNKNOWN_JOBID);
@@ -288,6 +368,24 @@ protected:
   */
   Database *mdatabaseInstance;
 
+private:
+  /**
+  * \brief The page to list
+  */
+  QueryPage mpage;
+  /**
+  * \brief The number of rows listed in the page
+  */
+  size_t mlisted;
+  /**
+  * \brief The key of the last row listed in the page
+  */
+  std::string mlastKey;
+  /**
+  * \brief The continuation token of the next page, empty if none
+  */
+  std::string mnextToken;
+
 };
 
 #endif
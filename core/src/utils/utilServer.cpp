@@ -16,6 +16,11 @@
 #include "DatabaseResult.hpp"
 #include "utilVishnu.hpp"
 #include "DbFactory.hpp"
+#include "DbArchiver.hpp"
+#include "DbIdAllocator.hpp"
+#include "DbReferenceCache.hpp"
+#include "DbSessionCache.hpp"
+#include "DbTransaction.hpp"
 #include "SystemException.hpp"
 #include "DbFactory.hpp"
 #include "Server.hpp"
@@ -246,92 +251,123 @@ vishnu::getGeneratedName(const char* format,
 }
 
 /**
- * \brief Function to get a specific vishnu counter
- * \param type : the type of id generated
- * \return The int counter value
+ * \brief The row reserved in the database for a new object, the invalid
+ * values are updated by the caller
  */
-int
-vishnu::getVishnuCounter(IdType type) {
-  DbFactory factory;
-  Database *databaseVishnu;
-  int ret;
+typedef struct placeholder_t {
+  std::string table; /*!< the table of the object */
+  std::string fields; /*!< the fields set in the row */
+  std::string values; /*!< the values of the fields */
+  std::string primary; /*!< the counter of the row */
+  std::string idname; /*!< the field of the generated id */
+  std::string noid; /*!< the value of the id until it is generated, if required */
+  bool reference; /*!< whether the table is kept by the reference cache */
+} placeholder_t;
 
-  std::string table;
-  std::string fields;
-  std::string val;
-  std::string primary;
-
-
-  bool insert=true;
+/**
+ * \brief Get the row reserved for a new object
+ * \param type : the type of the object
+ * \param row : the row to fill
+ * \return false if the type is not the type of an object
+ */
+static bool
+getPlaceholder(vishnu::IdType type, placeholder_t& row) {
+  row.reference = false;
   switch(type) {
-    case MACHINE:
-      table="machine";
-      fields=" (status) ";
-      val = " (0) ";
-      primary="nummachineid";
+    case vishnu::MACHINE:
+      row.table="machine";
+      row.fields="status";
+      row.values="0";
+      row.primary="nummachineid";
+      row.idname="machineid";
+      row.reference = true;
       break;
-    case USER:
-      table="users";
-      fields=" (pwd,userid) ";
-      val = " ('','') ";
-      primary="numuserid";
+    case vishnu::USER:
+      row.table="users";
+      row.fields="pwd";
+      row.values="''";
+      row.primary="numuserid";
+      row.idname="userid";
+      row.noid="''";
+      row.reference = true;
       break;
-    case JOB:
-      table="job";
-      fields=" (job_owner_id, machine_id, workId, vsession_numsessionid) ";
-      val= " ((select max(numuserid) from users), (select max(nummachineid) from machine),"
-           "NULL, (select max(numsessionid) from vsession)) "; //FIXME insert invalid value then update it
-      primary="numjobid";
+    case vishnu::JOB:
+      row.table="job";
+      row.fields="job_owner_id, machine_id, workId, vsession_numsessionid";
+      row.values="(select max(numuserid) from users), (select max(nummachineid) from machine),"
+                 "NULL, (select max(numsessionid) from vsession)"; //FIXME insert invalid value then update it
+      row.primary="numjobid";
+      row.idname="jobid";
       break;
-    case FILETRANSFERT:
-      table="filetransfer";
-      fields=" (vsession_numsessionid) ";
-      val= " ((select max(numsessionid) from vsession)) "; //FIXME insert invalid value then update it
-      primary="numfiletransferid";
+    case vishnu::FILETRANSFERT:
+      row.table="filetransfer";
+      row.fields="vsession_numsessionid";
+      row.values="(select max(numsessionid) from vsession)"; //FIXME insert invalid value then update it
+      row.primary="numfiletransferid";
+      row.idname="transferid";
       break;
-    case AUTH:
-      table="authsystem";
-      fields=" (status) ";
-      val = boost::str(boost::format(" (%1%) ") % vishnu::STATUS_UNDEFINED);
-      primary="numauthsystemid";
+    case vishnu::AUTH:
+      row.table="authsystem";
+      row.fields="status";
+      row.values=boost::str(boost::format("%1%") % vishnu::STATUS_UNDEFINED);
+      row.primary="numauthsystemid";
+      row.idname="authsystemid";
+      row.reference = true;
       break;
-    case WORK:
+    case vishnu::WORK:
       //FIXME : no auto-increment field in work
-      fields = " (application_id"
-               ",date_created,done_ratio, identifier,"
-               "nbcpus, owner_id, "
-               "project_id, "
-               "status, subject, consolidated) ";
-      val = " ((select min(id) from application_version),"
-            " CURRENT_TIMESTAMP, 1, 't',"
-            " 1, (select min(numuserid) from users), "
-            "(select min(id) from project), "
-            "1,'toto', false) ";
-      table = "work";
-      primary="id";
+      row.table="work";
+      row.fields="application_id"
+                 ",date_created,done_ratio,"
+                 "nbcpus, owner_id, "
+                 "project_id, "
+                 "status, subject, consolidated";
+      row.values="(select min(id) from application_version),"
+                 " CURRENT_TIMESTAMP, 1,"
+                 " 1, (select min(numuserid) from users), "
+                 "(select min(id) from project), "
+                 "1,'toto', false";
+      row.primary="id";
+      row.idname="identifier";
+      row.noid="'t'";
       break;
     default:
-      fields = " (updatefreq, formatiduser, formatidjob, formatidfiletransfer, formatidmachine, formatidauth) ";
-      val = " (1, 't', 't', 't', 't', 't') ";
-      table = "vishnu";
-      insert=false;
-      primary="vishnu_vishnuid";
-      break;
+      return false;
   }
+  return true;
+}
 
-  databaseVishnu = factory.getDatabaseInstance();
-  int tid = databaseVishnu->startTransaction();
-  try {
-    ret = databaseVishnu->generateId(table, fields, val, tid, primary);
-  } catch (const std::exception& e) {
-    databaseVishnu->cancelTransaction(tid);
-    throw;
+/**
+ * \brief Function to get a specific vishnu counter
+ * \param type : the type of id generated
+ * \return The int counter value
+ */
+int
+vishnu::getVishnuCounter(IdType type) {
+  DbFactory factory;
+  Database *databaseVishnu;
+  int ret;
+
+  placeholder_t row;
+  bool insert = getPlaceholder(type, row);
+  if (!insert) {
+    row.fields = "updatefreq, formatiduser, formatidjob, formatidfiletransfer, formatidmachine, formatidauth";
+    row.values = "1, 't', 't', 't', 't', 't'";
+    row.table = "vishnu";
+    row.primary = "vishnu_vishnuid";
+  } else if (!row.noid.empty()) {
+    row.fields += ", " + row.idname;
+    row.values += ", " + row.noid;
   }
 
+  databaseVishnu = factory.getDatabaseInstance();
+  DbTransaction transaction(databaseVishnu);
+  ret = databaseVishnu->generateId(row.table, " (" + row.fields + ") ", " (" + row.values + ") ",
+                                   transaction.getId(), row.primary);
+
+  // otherwise the reservation is rolled back when leaving the scope
   if (insert) {
-    databaseVishnu->endTransaction(tid);
-  } else {
-    databaseVishnu->cancelTransaction(tid);
+    transaction.commit();
   }
   return ret;
 }
@@ -344,57 +380,23 @@ vishnu::getVishnuCounter(IdType type) {
  */
 void
 vishnu::reserveObjectId(int key, std::string &objectId, IdType type) {
-  std::string table;
-  std::string keyname;
-  std::string idname;
+  placeholder_t row;
   bool uniq = false;
 
-  switch(type) {
-    case MACHINE:
-      table="machine";
-      keyname="nummachineid";
-      idname="machineid";
-      break;
-    case USER:
-      table="users";
-      keyname="numuserid";
-      idname="userid";
-      break;
-    case JOB:
-      table="job";
-      keyname="numjobid";
-      idname="jobid";
-      break;
-    case FILETRANSFERT:
-      table="filetransfer";
-      keyname="numfiletransferid";
-      idname="transferid";
-      break;
-    case AUTH:
-      table="authsystem";
-      keyname="numauthsystemid";
-      idname="authsystemid";
-      break;
-    case WORK:
-      table="work";
-      keyname="id";
-      idname="identifier";
-      break;
-    default:
-      throw SystemException(ERRCODE_SYSTEM,"Cannot reserve Object id, type in unrecognized");
-      break;
+  if (!getPlaceholder(type, row)) {
+    throw SystemException(ERRCODE_SYSTEM,"Cannot reserve Object id, type in unrecognized");
   }
   while (!uniq){
-    uniq = checkObjectId(table, idname, objectId);
+    uniq = checkObjectId(row.table, row.idname, objectId);
     if (!uniq) {
       objectId += convertToString(key);
     }
   }
 
   DbFactory factory;
-  std::string sqlReserve="UPDATE "+table+" ";
-  sqlReserve+="set "+idname+"='"+factory.getDatabaseInstance()->escapeData(objectId)+"' ";
-  sqlReserve+="where "+keyname+"="+convertToString(key)+";";
+  std::string sqlReserve="UPDATE "+row.table+" ";
+  sqlReserve+="set "+row.idname+"='"+factory.getDatabaseInstance()->escapeData(objectId)+"' ";
+  sqlReserve+="where "+row.primary+"="+convertToString(key)+";";
 
   try {
     factory.getDatabaseInstance()->process(sqlReserve);
@@ -402,7 +404,36 @@ vishnu::reserveObjectId(int key, std::string &objectId, IdType type) {
     throw SystemException(ERRCODE_SYSTEM,
                           boost::str(boost::format("Cannot reserve Object id: ")% e.what()));
   }
+  if (row.reference) {
+    invalidateReferenceCache(row.table);
+  }
+}
+
+/**
+ * \brief To insert the row of a new object with its objectId
+ * \param objectId : the objectId, unique
+ * \param type : the type of the object
+ */
+void
+vishnu::insertObjectId(const std::string& objectId, IdType type) {
+  placeholder_t row;
+  if (!getPlaceholder(type, row)) {
+    throw SystemException(ERRCODE_SYSTEM,"Cannot reserve Object id, type in unrecognized");
+  }
 
+  DbFactory factory;
+  Database* database = factory.getDatabaseInstance();
+  std::string sqlInsert = "INSERT INTO " + row.table + " (" + row.fields + ", " + row.idname + ")";
+  sqlInsert += " VALUES (" + row.values + ", '" + database->escapeData(objectId) + "')";
+  try {
+    database->process(sqlInsert);
+  } catch (std::exception const & e) {
+    throw SystemException(ERRCODE_SYSTEM,
+                          boost::str(boost::format("Cannot reserve Object id: %1%")% e.what()));
+  }
+  if (row.reference) {
+    invalidateReferenceCache(row.table);
+  }
 }
 
 bool
@@ -454,15 +485,27 @@ vishnu::incrementCpt(const std::string& cptName, int cpt, int transacId) {
 std::string
 vishnu::getObjectId(IdType type, std::string stringforgeneration) {
 
+  std::string format = getIdFormatTemplate(type);
+  DbFactory factory;
+  DbIdAllocator* allocator = factory.getIdAllocatorInstance();
+  int counter;
+
+  // a reserved counter is unique, so is the id, the row is created with it
+  if (allocator != NULL
+      && format.find("$CPT") != std::string::npos
+      && allocator->next(type, counter)) {
+    std::string idGenerated = getGeneratedName(format.c_str(), counter, type, stringforgeneration);
+    if (idGenerated.empty()) {
+      throw SystemException(ERRCODE_SYSTEM,
+                            boost::str(boost::format("Failed to generate ID for object type %1%") % type));
+    }
+    insertObjectId(idGenerated, type);
+    return idGenerated;
+  }
 
   std::string errorString = "";
 
-  pthread_mutex_t mutex;
-  pthread_mutex_init(&(mutex), NULL);
-  pthread_mutex_lock(&(mutex));
-
-  int counter = getVishnuCounter(type);
-  std::string format = getIdFormatTemplate(type);
+  counter = getVishnuCounter(type);
   std::string idGenerated = getGeneratedName(format.c_str(), counter, type, stringforgeneration);
 
   if (! idGenerated.empty()) {
@@ -470,7 +513,6 @@ vishnu::getObjectId(IdType type, std::string stringforgeneration) {
     errorString = boost::str(boost::format("Failed to generate ID for object type %1%") % type);
   }
   reserveObjectId(counter,idGenerated,type); // set the idGenerated in the related row
-  pthread_mutex_unlock(&(mutex));
 
   if (! errorString.empty()) {
     throw SystemException(ERRCODE_SYSTEM, errorString);
@@ -495,27 +537,37 @@ vishnu::validateAuthKey(const std::string& authKey,
                                         "  users.numuserid, users.userid, users.privilege, "
                                         "  account.aclogin, account.home"
                                         " FROM vsession, users, account, machine"
-                                        " WHERE vsession.sessionkey='%1%'"
-                                        "  AND vsession.state=%2%"
+                                        " WHERE vsession.sessionkey=$1"
+                                        "  AND vsession.state=%1%"
                                         "  AND users.numuserid=vsession.users_numuserid"
                                         "  AND users.numuserid=account.users_numuserid"
-                                        "  AND account.status=%3%"
+                                        "  AND account.status=%2%"
                                         "  AND account.machine_nummachineid=machine.nummachineid"
-                                        "  AND machine.machineid='%4%';"
+                                        "  AND machine.machineid=$2;"
                                         )
-                          % database->escapeData(authKey)
                           % vishnu::SESSION_ACTIVE
                           % vishnu::STATUS_ACTIVE
-                          % database->escapeData(machineId)
                           ).str();
-
-  boost::scoped_ptr<DatabaseResult> sqlResult(database->getResult(sqlQuery));
-  if (sqlResult->getNbTuples() < 1) {
-    throw TMSVishnuException(ERRCODE_PERMISSION_DENIED,
-                             "Can't get user information from the session token provided");
+  DbFactory factory;
+  DbSessionCache* cache = factory.getSessionCacheInstance();
+  std::string key = authKey + "\n" + machineId;
+  unsigned long generation = 0;
+  std::vector<std::string> rowResult;
+  if (cache == NULL || !cache->get(key, rowResult, generation)) {
+    std::vector<std::string> params;
+    params.push_back(authKey);
+    params.push_back(machineId);
+
+    boost::scoped_ptr<DatabaseResult> sqlResult(database->getPreparedResult(sqlQuery, params));
+    if (sqlResult->getNbTuples() < 1) {
+      throw TMSVishnuException(ERRCODE_PERMISSION_DENIED,
+                               "Can't get user information from the session token provided");
+    }
+    rowResult = sqlResult->get(0);
+    if (cache != NULL) {
+      cache->put(key, rowResult, generation);
+    }
   }
-
-  std::vector<std::string> rowResult = sqlResult->get(0);
   std::vector<std::string>::iterator rowResultIter = rowResult.begin();
 
   info.num_session = vishnu::convertToInt(*rowResultIter++);
@@ -544,25 +596,33 @@ vishnu::validateAuthKey(const std::string& authKey,
                                         "  users.numuserid, users.userid, users.privilege, "
                                         "  account.aclogin, account.home"
                                         " FROM vsession, users, account, machine"
-                                        " WHERE vsession.sessionkey='%1%'"
-                                        "  AND vsession.state=%2%"
+                                        " WHERE vsession.sessionkey=$1"
+                                        "  AND vsession.state=%1%"
                                         "  AND users.numuserid=vsession.users_numuserid"
                                         "  AND users.numuserid=account.users_numuserid"
-                                        "  AND account.status=%3%"
+                                        "  AND account.status=%2%"
                                         )
-                          % database->escapeData(authKey)
                           % vishnu::SESSION_ACTIVE
                           % vishnu::STATUS_ACTIVE
                           ).str();
-  boost::scoped_ptr<DatabaseResult> sqlResult(database->getResult(sqlQuery));
-  if (sqlResult->getNbTuples() < 1) {
-    throw TMSVishnuException(ERRCODE_INVALID_PARAM,
-                             "Can't get user local account. Check that:\n"
-                             "  * your session is still active\n"
-                             "  * you have a local account on this server");
+  DbFactory factory;
+  DbSessionCache* cache = factory.getSessionCacheInstance();
+  unsigned long generation = 0;
+  std::vector<std::string> rowResult;
+  if (cache == NULL || !cache->get(authKey, rowResult, generation)) {
+    std::vector<std::string> params(1, authKey);
+    boost::scoped_ptr<DatabaseResult> sqlResult(database->getPreparedResult(sqlQuery, params));
+    if (sqlResult->getNbTuples() < 1) {
+      throw TMSVishnuException(ERRCODE_INVALID_PARAM,
+                               "Can't get user local account. Check that:\n"
+                               "  * your session is still active\n"
+                               "  * you have a local account on this server");
+    }
+    rowResult = sqlResult->get(0);
+    if (cache != NULL) {
+      cache->put(authKey, rowResult, generation);
+    }
   }
-
-  std::vector<std::string> rowResult = sqlResult->get(0);
   std::vector<std::string>::iterator rowResultIter = rowResult.begin();
 
   info.num_session = vishnu::convertToInt(*rowResultIter++);
@@ -574,6 +634,98 @@ vishnu::validateAuthKey(const std::string& authKey,
 }
 
 
+/**
+ * @brief Discard the validated sessions kept by the servers
+ */
+void
+vishnu::invalidateSessionCache()
+{
+  DbFactory factory;
+  DbSessionCache* cache = factory.getSessionCacheInstance();
+  if (cache != NULL) {
+    cache->invalidate();
+  }
+}
+
+
+/**
+ * @brief Get the first element of the result of a request on a reference table
+ * @param table The table read by the request
+ * @param request The request
+ * @param database The database
+ * @return The first element or an empty string if there is no result
+ */
+std::string
+vishnu::getReferenceValue(const std::string& table,
+                          const std::string& request,
+                          Database* database)
+{
+  DbFactory factory;
+  DbReferenceCache* cache = factory.getReferenceCacheInstance();
+  if (cache == NULL) {
+    boost::scoped_ptr<DatabaseResult> result(database->getResult(request));
+    return result->getFirstElement();
+  }
+  return cache->getFirstElement(table, request);
+}
+
+
+/**
+ * @brief Get the first tuple of the result of a request on a reference table
+ * @param table The table read by the request
+ * @param request The request
+ * @param database The database, read if the values are not kept
+ * @return The first tuple or an empty tuple if there is no result
+ */
+std::vector<std::string>
+vishnu::getReferenceRow(const std::string& table,
+                        const std::string& request,
+                        Database* database)
+{
+  DbFactory factory;
+  DbReferenceCache* cache = factory.getReferenceCacheInstance();
+  if (cache == NULL) {
+    boost::scoped_ptr<DatabaseResult> result(database->getResult(request));
+    return (result->getNbTuples() == 0) ? std::vector<std::string>() : result->get(0);
+  }
+  return cache->getFirstRow(table, request);
+}
+
+
+/**
+ * @brief Discard the values of a reference table kept by the servers
+ * @param table The table which has changed
+ */
+void
+vishnu::invalidateReferenceCache(const std::string& table)
+{
+  DbFactory factory;
+  DbReferenceCache* cache = factory.getReferenceCacheInstance();
+  if (cache != NULL) {
+    cache->invalidate(table);
+  }
+}
+
+
+/**
+ * @brief Get the table to read in a listing of a history table
+ * @param table The history table
+ * @param terminal Whether the listing may return rows in a terminal state
+ * @param from The lower bound of the dates of the listing, 0 or less if none
+ * @return The table, or its history view named as the table
+ */
+std::string
+vishnu::getHistoryTable(const std::string& table, bool terminal, time_t from)
+{
+  DbFactory factory;
+  DbArchiver* archiver = factory.getArchiverInstance();
+  if (archiver == NULL || !terminal || !archiver->mayBeArchived(from)) {
+    return table;
+  }
+  return table + "_history " + table;
+}
+
+
 /**
  * @brief Get the template to build object identifier
  * @param objectType The object type
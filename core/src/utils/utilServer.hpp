@@ -273,6 +273,14 @@ namespace vishnu {
   void
   reserveObjectId(int key, std::string& objectId, IdType type);
 
+  /**
+   * \brief To insert the row of a new object with its objectId
+   * \param objectId : the objectId, unique
+   * \param type : the type of the object
+   */
+  void
+  insertObjectId(const std::string& objectId, IdType type);
+
   /**
   * \brief Function to get an Id generated by VISHNU
   * \param type the type of the Id generated
@@ -386,6 +394,60 @@ namespace vishnu {
                   Database* databasePtr,
                   UserSessionInfo& info);
 
+  /**
+   * @brief Discard the validated sessions kept by the servers, to call once
+   * a session, a user, a machine or a local account has changed
+   */
+  void
+  invalidateSessionCache();
+
+  /**
+   * @brief Get the first element of the result of a request on a reference
+   * table (users, machine, account or authsystem), kept in memory by the
+   * servers until the table changes
+   * @param table The table read by the request
+   * @param request The request
+   * @param database The database, read if the values are not kept
+   * @return The first element or an empty string if there is no result
+   */
+  std::string
+  getReferenceValue(const std::string& table,
+                    const std::string& request,
+                    Database* database);
+
+  /**
+   * @brief Get the first tuple of the result of a request on a reference
+   * table, kept in memory by the servers until the table changes
+   * @param table The table read by the request
+   * @param request The request
+   * @param database The database, read if the values are not kept
+   * @return The first tuple or an empty tuple if there is no result
+   */
+  std::vector<std::string>
+  getReferenceRow(const std::string& table,
+                  const std::string& request,
+                  Database* database);
+
+  /**
+   * @brief Discard the values of a reference table kept by the servers, to
+   * call once the table has changed
+   * @param table The table which has changed
+   */
+  void
+  invalidateReferenceCache(const std::string& table);
+
+  /**
+   * @brief Get the table to read in a listing of a history table (job,
+   * command, filetransfer or vsession), with its archived rows if the
+   * listing may return some
+   * @param table The history table
+   * @param terminal Whether the listing may return rows in a terminal state
+   * @param from The lower bound of the dates of the listing, 0 or less if none
+   * @return The table, or its history view named as the table
+   */
+  std::string
+  getHistoryTable(const std::string& table, bool terminal = true, time_t from = 0);
+
   /**
    * @brief Get the template to build object identifier
    * @param objectType The object type
@@ -7,6 +7,7 @@
  */
 
 #include "utilVishnu.hpp"
+#include "HashingPool.hpp"
 #include "UserException.hpp"
 #include "SystemException.hpp"
 #include "FMSVishnuException.hpp"
@@ -20,10 +21,6 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/random/detail/seed.hpp>
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_int.hpp>
-#include <boost/random/variate_generator.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/local_time/local_time.hpp>
@@ -31,6 +28,7 @@
 #include <boost/algorithm/string/find.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
+#include <boost/cstdint.hpp>
 #include <exception>
 #include <sstream>
 #include <ctime>
@@ -50,6 +48,9 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <net/if.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 
 #include <errno.h>
 
@@ -59,6 +60,50 @@ namespace bs=boost::system;
 using namespace boost::posix_time;
 using namespace boost::gregorian;
 
+namespace {
+  /**
+   * \brief Fill a buffer with bytes of the random generator of the kernel
+   * \param buffer the buffer
+   * \param size the size of the buffer
+   */
+  void
+  fillRandom(unsigned char* buffer, size_t size) {
+    size_t filled = 0;
+#ifdef SYS_getrandom
+    while (filled < size) {
+      long count = syscall(SYS_getrandom, buffer + filled, size - filled, 0);
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // an older kernel, read the device instead
+        break;
+      }
+      filled += static_cast<size_t>(count);
+    }
+#endif
+    if (filled == size) {
+      return;
+    }
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0) {
+      throw SystemException(ERRCODE_SYSTEM, "Cannot open /dev/urandom");
+    }
+    while (filled < size) {
+      ssize_t count = read(fd, buffer + filled, size - filled);
+      if (count <= 0) {
+        if (count < 0 && errno == EINTR) {
+          continue;
+        }
+        close(fd);
+        throw SystemException(ERRCODE_SYSTEM, "Cannot read /dev/urandom");
+      }
+      filled += static_cast<size_t>(count);
+    }
+    close(fd);
+  }
+}
+
 /**
  * \brief Function to convert a string to int
  * \param  val a value to convert to int
@@ -104,7 +149,8 @@ vishnu::cryptPassword(const std::string& salt, const std::string& password, bool
     return password;
   } else {
     std::string saltTmp = "$6$" + salt + "$";
-    std::string encryptedPassword = crypt(password.c_str(), saltTmp.c_str());
+    // crypt is not reentrant, the pool hashes with crypt_r
+    std::string encryptedPassword = HashingPool::getInstance().hash(password, saltTmp);
     return encryptedPassword.substr(saltTmp.size());
   }
 }
@@ -115,11 +161,32 @@ vishnu::cryptPassword(const std::string& salt, const std::string& password, bool
  */
 int
 vishnu::generateNumbers() {
-  boost::mt19937 gen;
-  gen.seed(static_cast<boost::uint32_t>(std::time(0)));
-  boost::uniform_int<> dist(1, 100000);
-  boost::variate_generator<boost::mt19937&, boost::uniform_int<> > die(gen, dist);
-  return die();
+  boost::uint32_t value;
+  fillRandom(reinterpret_cast<unsigned char*>(&value), sizeof(value));
+  return static_cast<int>(value % 100000) + 1;
+}
+
+/**
+ * \brief Function to get a random string, from the random generator of
+ * the kernel
+ * \param length the number of characters
+ * \return the string, of characters of [./0-9A-Za-z]
+ */
+std::string
+vishnu::generateToken(size_t length) {
+  static const char alphabet[] = "./0123456789"
+                                 "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                 "abcdefghijklmnopqrstuvwxyz";
+  std::vector<unsigned char> bytes(length);
+  if (length > 0) {
+    fillRandom(&bytes[0], length);
+  }
+  std::string token(length, ' ');
+  for (size_t i = 0; i < length; ++i) {
+    // 64 characters, 6 bits of each byte
+    token[i] = alphabet[bytes[i] & 63];
+  }
+  return token;
 }
 
 /**
@@ -91,6 +91,15 @@ namespace vishnu {
   int
   generateNumbers();
 
+  /**
+ * \brief Function to get a random string, from the random generator of
+ * the kernel
+ * \param length the number of characters
+ * \return the string, of characters of [./0-9A-Za-z]
+ */
+  std::string
+  generateToken(size_t length);
+
   /**
  * \brief To retrieve the password
  * \param prompt: The message inviting the user to enter his/her password
@@ -1,7 +1,99 @@
 #include "Database.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <boost/scoped_ptr.hpp>
 
 Database:: Database(){};
 
 Database::~Database(){};
 
+int
+Database::processPrepared(const std::string& request,
+                          const std::vector<std::string>& params,
+                          int transacId) {
+  return process(bindParams(request, params), transacId);
+}
 
+DatabaseResult*
+Database::getPreparedResult(const std::string& request,
+                            const std::vector<std::string>& params,
+                            int transacId) {
+  return getResult(bindParams(request, params), transacId);
+}
+
+size_t
+Database::forEachRow(const std::string& request, const RowHandler& handler,
+                     int transacId) {
+  boost::scoped_ptr<DatabaseResult> result(getResult(request, transacId));
+  for (size_t i = 0; i < result->getNbTuples(); ++i) {
+    handler(result->getRow(i));
+  }
+  return result->getNbTuples();
+}
+
+int
+Database::processBatch(const std::vector<std::string>& requests, int transacId) {
+  std::vector<std::string>::const_iterator it;
+  for (it = requests.begin(); it != requests.end(); ++it) {
+    process(*it, transacId);
+  }
+  return 0;
+}
+
+int
+Database::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                     const std::vector<std::vector<std::string> >& rows, int transacId) {
+  return insertRows(table, columns, rows, std::vector<std::vector<bool> >(), transacId);
+}
+
+int
+Database::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                     const std::vector<std::vector<std::string> >& rows,
+                     const std::vector<std::vector<bool> >& nulls, int transacId) {
+  std::string head = "INSERT INTO " + table + " (";
+  for (size_t i = 0; i < columns.size(); ++i) {
+    head += (i == 0 ? "" : ", ") + columns[i];
+  }
+  for (size_t row = 0; row < rows.size(); ++row) {
+    std::string request = head + ") VALUES (";
+    for (size_t i = 0; i < rows[row].size(); ++i) {
+      request += (i == 0) ? "" : ", ";
+      if (!nulls.empty() && nulls[row][i]) {
+        request += "NULL";
+      } else {
+        request += "'" + escapeData(rows[row][i]) + "'";
+      }
+    }
+    process(request + ")", transacId);
+  }
+  return 0;
+}
+
+std::string
+Database::addParam(std::vector<std::string>& params, const std::string& value) {
+  params.push_back(value);
+  std::ostringstream ref;
+  ref << "$" << params.size();
+  return ref.str();
+}
+
+std::string
+Database::bindParams(const std::string& request, const std::vector<std::string>& params) {
+  std::string bound;
+  std::string::size_type pos = 0;
+  while (pos < request.size()) {
+    std::string::size_type end = pos + 1;
+    while (end < request.size() && isdigit(static_cast<unsigned char>(request[end]))) {
+      ++end;
+    }
+    if (request[pos] != '$' || end == pos + 1) {
+      bound += request[pos++];
+      continue;
+    }
+    size_t index = strtoul(request.substr(pos + 1, end - pos - 1).c_str(), NULL, 10);
+    bound += "'" + escapeData(index > 0 && index <= params.size() ? params[index - 1] : "") + "'";
+    pos = end;
+  }
+  return bound;
+}
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <vector>
+#include <boost/function.hpp>
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
 
@@ -20,6 +21,11 @@ static const int SUCCESS =  0;
  */
 class Database{
 public :
+  /**
+   * \brief Callback receiving the tuples of a streamed request
+   */
+  typedef boost::function<void (const DatabaseResult::Row&)> RowHandler;
+
   /**
    * \brief Function to process the request in the database
    * \param request The request to process (must contain a SINGLE SQL statement without a semicolumn)
@@ -43,6 +49,71 @@ public :
   */
   virtual DatabaseResult*
   getResult(std::string request, int transacId = -1) = 0;
+  /**
+   * \brief Function to process a parameterized request
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& request,
+                  const std::vector<std::string>& params,
+                  int transacId = -1);
+  /**
+   * \brief To get the result of a parameterized select request
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& request,
+                    const std::vector<std::string>& params,
+                    int transacId = -1);
+  /**
+   * \brief To stream the result of a select request
+   * \fn size_t forEachRow(const std::string& request, const RowHandler& handler, int transacId = -1)
+   * \param request The request to process
+   * \param handler The callback called for each tuple
+   * \param transacId the id of the transaction if one is used
+   * \return the number of tuples
+   */
+  virtual size_t
+  forEachRow(const std::string& request, const RowHandler& handler,
+             int transacId = -1);
+  /**
+   * \brief Process a list of independent statements
+   * \param requests the statements
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processBatch(const std::vector<std::string>& requests, int transacId = -1);
+  /**
+   * \brief Insert several rows in a table
+   * \param table the table
+   * \param columns the columns given for each row
+   * \param rows the values of the columns of each row
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  int
+  insertRows(const std::string& table, const std::vector<std::string>& columns,
+             const std::vector<std::vector<std::string> >& rows, int transacId = -1);
+  /**
+   * \brief Insert several rows in a table, some values being NULL
+   * \param table the table
+   * \param columns the columns given for each row
+   * \param rows the values of the columns of each row
+   * \param nulls whether each value of each row is NULL, empty if none is
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  insertRows(const std::string& table, const std::vector<std::string>& columns,
+             const std::vector<std::vector<std::string> >& rows,
+             const std::vector<std::vector<bool> >& nulls, int transacId = -1);
   /**
    * \brief To get the type of database
    * \return An enum identifying the type of database
@@ -97,6 +168,14 @@ virtual ~Database();
    */
   virtual std::string escapeData(const std::string& data) = 0;
 
+  /**
+   * \brief To append a value to the parameters of a request
+   * \param params The parameters of the request
+   * \param value The value to add
+   * \return the reference to the parameter to put in the request ($1, $2...)
+   */
+  static std::string
+  addParam(std::vector<std::string>& params, const std::string& value);
 
 protected :
   /**
@@ -105,6 +184,15 @@ protected :
    */
   Database();
 
+  /**
+   * \brief To replace the parameters of a request by escaped literals
+   * \param request The request, the parameters are referenced as $1, $2...
+   * \param params The values of the parameters
+   * \return the request to process
+   */
+  std::string
+  bindParams(const std::string& request, const std::vector<std::string>& params);
+
 private :
   /**
    * \brief To disconnect from the database
@@ -4,9 +4,11 @@
  * \author Eugène PAMBA CAPO-CHICHI (eugene.capochichi@sysfera.com)
  * \date 31/01/2011
  */
+#include <cstdlib>
 #include <sstream>
 #include <iostream>
 #include "DatabaseResult.hpp"
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 /**
 * \fn DatabaseResult()
@@ -133,3 +135,61 @@ DatabaseResult::getFirstElement() const {
     return "";
   }
 }
+
+DatabaseResult::Row
+DatabaseResult::getRow(size_t position) const {
+  return Row(*this, position);
+}
+
+const char*
+DatabaseResult::Row::getValue(size_t field) const {
+  return mresult.results[mposition][field].c_str();
+}
+
+size_t
+DatabaseResult::Row::getLength(size_t field) const {
+  return mresult.results[mposition][field].size();
+}
+
+bool
+DatabaseResult::Row::isNull(size_t field) const {
+  return false;
+}
+
+std::string
+DatabaseResult::Row::getString(size_t field) const {
+  return mresult.results[mposition][field];
+}
+
+int
+DatabaseResult::Row::getInt(size_t field) const {
+  return static_cast<int>(getLong(field));
+}
+
+long long
+DatabaseResult::Row::getLong(size_t field) const {
+  char* end = NULL;
+  long long value = strtoll(getValue(field), &end, 10);
+  return (end == getValue(field) || *end != '\0') ? -1 : value;
+}
+
+double
+DatabaseResult::Row::getDouble(size_t field) const {
+  return atof(getValue(field));
+}
+
+bool
+DatabaseResult::Row::getBool(size_t field) const {
+  std::string value = getString(field);
+  return (value == "t" || value == "true" || value == "y" || value == "1");
+}
+
+time_t
+DatabaseResult::Row::getTimestamp(size_t field) const {
+  boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  try {
+    return (boost::posix_time::time_from_string(getString(field)) - epoch).total_seconds();
+  } catch (...) {
+    return 0;
+  }
+}
@@ -8,6 +8,7 @@
 #ifndef _DATABASERESULT_H_
 #define _DATABASERESULT_H_
 
+#include <ctime>
 #include <string>
 #include <vector>
 
@@ -17,6 +18,36 @@
  */
 class DatabaseResult{
 public :
+  /**
+   * \class Row
+   * \brief A view on a tuple of a result, valid while the result lives
+   */
+  class Row {
+  public :
+    Row(const DatabaseResult& result, size_t position)
+      : mresult(result), mposition(position) {}
+    const char* getValue(size_t field) const;
+    size_t getLength(size_t field) const;
+    bool isNull(size_t field) const;
+    std::string getString(size_t field) const;
+    int getInt(size_t field) const;
+    long long getLong(size_t field) const;
+    double getDouble(size_t field) const;
+    bool getBool(size_t field) const;
+    time_t getTimestamp(size_t field) const;
+  private :
+    const DatabaseResult& mresult;
+    size_t mposition;
+  };
+
+  /**
+   * \brief To get a view on a tuple
+   * \fn Row getRow(size_t position) const
+   * \param position The position of the tuple
+   * \return the view on the tuple
+   */
+  Row
+  getRow(size_t position) const;
   /**
    * \brief Function to print the database results
    * \fn    print()
@@ -92,6 +92,12 @@ public:
    */
   unsigned getDbPoolSize() { return mdbPoolSize; }
 
+  /**
+   * \brief Whether the schema must be upgraded at startup
+   * \return false, the mock has no schema
+   */
+  bool getDbSchemaUpgrade() const { return false; }
+
 protected:
 
   /////////////////////////////////
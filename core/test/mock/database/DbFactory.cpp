@@ -29,3 +29,46 @@ Database* DbFactory::getDatabaseInstance()
   return mdb;
 }
 
+DbWriteBehind* DbFactory::getWriteBehindInstance()
+{
+  return NULL;
+}
+
+void DbFactory::closeWriteBehindInstance()
+{
+}
+
+DbIdAllocator* DbFactory::getIdAllocatorInstance()
+{
+  return NULL;
+}
+
+Database* DbFactory::getReadDatabaseInstance(const std::string& sessionKey)
+{
+  return mdb;
+}
+
+DbReplicaRouter* DbFactory::getReplicaRouterInstance()
+{
+  return NULL;
+}
+
+DbSessionCache* DbFactory::getSessionCacheInstance()
+{
+  return NULL;
+}
+
+DbReferenceCache* DbFactory::getReferenceCacheInstance()
+{
+  return NULL;
+}
+
+DbArchiver* DbFactory::getArchiverInstance()
+{
+  return NULL;
+}
+
+DbProfiler* DbFactory::getProfilerInstance()
+{
+  return NULL;
+}
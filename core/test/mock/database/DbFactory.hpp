@@ -11,6 +11,15 @@
 #include "Database.hpp"
 #include "DbConfiguration.hpp"
 
+// the mock never creates them, it only returns nil pointers
+class DbArchiver;
+class DbIdAllocator;
+class DbProfiler;
+class DbReferenceCache;
+class DbReplicaRouter;
+class DbSessionCache;
+class DbWriteBehind;
+
 
 /**
  * \class DbFactory
@@ -44,6 +53,72 @@ public :
   Database*
   getDatabaseInstance();
 
+  /**
+   * \brief Get the queue of the deferred writes, writes are never deferred
+   * \return a nil pointer
+   */
+  DbWriteBehind*
+  getWriteBehindInstance();
+
+  /**
+   * \brief Destroy the queue of the deferred writes, nothing to do
+   */
+  void
+  closeWriteBehindInstance();
+
+  /**
+   * \brief Get the allocator of the object counters, counters are never
+   * reserved in advance
+   * \return a nil pointer
+   */
+  DbIdAllocator*
+  getIdAllocatorInstance();
+
+  /**
+   * \brief Get the database to run a read-only request on, there is no replica
+   * \param sessionKey the key of the session reading
+   * \return the single instance of the database
+   */
+  Database*
+  getReadDatabaseInstance(const std::string& sessionKey);
+
+  /**
+   * \brief Get the router of the reads to the replicas, there is no replica
+   * \return a nil pointer
+   */
+  DbReplicaRouter*
+  getReplicaRouterInstance();
+
+  /**
+   * \brief Get the cache of the validated sessions, the sessions are always
+   * validated by the database
+   * \return a nil pointer
+   */
+  DbSessionCache*
+  getSessionCacheInstance();
+
+  /**
+   * \brief Get the cache of the reference tables, the values are always
+   * read in the database
+   * \return a nil pointer
+   */
+  DbReferenceCache*
+  getReferenceCacheInstance();
+
+  /**
+   * \brief Get the archiver of the history tables, the rows are never archived
+   * \return a nil pointer
+   */
+  DbArchiver*
+  getArchiverInstance();
+
+  /**
+   * \brief Get the statistics of the requests, the requests are not timed
+   * \return a nil pointer
+   */
+  DbProfiler*
+  getProfilerInstance();
+
 private :
   /**
    * \brief The unique instance of the database
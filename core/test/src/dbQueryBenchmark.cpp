@@ -0,0 +1,278 @@
+/**
+ * \file dbQueryBenchmark.cpp
+ * \brief Times the hot queries of the servers against a synthetic history.
+ * The history is loaded in the database of the given configuration file,
+ * tagged with the pid of the benchmark, and deleted at the end. The random
+ * generator is seeded with a constant so that two runs (e.g. before and
+ * after a schema migration) load the same history and issue the same
+ * queries. Use a scratch copy of the database, the load is not negligible.
+ */
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "DbConfiguration.hpp"
+#include "DbFactory.hpp"
+#include "DbMigrator.hpp"
+#include "ExecConfiguration.hpp"
+#include "VishnuException.hpp"
+
+namespace {
+
+  typedef boost::variate_generator<boost::mt19937&, boost::uniform_int<> > dice_t;
+
+  /**
+   * \brief A timed query, %1% to %4% are drawn for each execution
+   */
+  typedef struct query_t {
+    const char* name;
+    const char* sql;
+  } query_t;
+
+  // %1%: a session key, %2%: a submit machine, %3%: a job id, %4%: a transfer id
+  const query_t queries[] = {
+    {"session check",
+     "SELECT state, status, passwordstate FROM users, vsession"
+     " WHERE users.numuserid = vsession.users_numuserid"
+     " AND vsession.sessionkey='%1%' AND vsession.state<>4"},
+    {"session lookup",
+     "SELECT numsessionid FROM vsession WHERE sessionkey='%1%'"},
+    {"monitor jobs",
+     "SELECT jobId, batchJobId, vmIp, vmId, owner FROM job, vsession"
+     " WHERE vsession.numsessionid=job.vsession_numsessionid"
+     " AND submitMachineId='%2%' AND batchType=0 AND status >= 0 AND status < 5"},
+    {"job update",
+     "UPDATE job SET status=status WHERE jobId='%3%'"},
+    {"session jobs",
+     "SELECT jobId FROM job, vsession"
+     " WHERE vsession.numsessionid=job.vsession_numsessionid AND vsession.sessionkey='%1%'"},
+    {"command history",
+     "SELECT ctype, description, starttime, endtime FROM command, vsession"
+     " WHERE vsession.numsessionid=command.vsession_numsessionid AND vsession.sessionkey='%1%'"},
+    {"pending transfers",
+     "SELECT transferId FROM filetransfer, vsession"
+     " WHERE vsession.numsessionid=filetransfer.vsession_numsessionid AND filetransfer.status=0"},
+    {"transfer lookup",
+     "SELECT errormsg FROM filetransfer WHERE transferId='%4%'"},
+    {NULL, NULL}
+  };
+
+  const int nbMachines = 4;
+
+  std::string
+  sessionKey(const std::string& tag, int session) {
+    return boost::str(boost::format("%1%_session%2%") % tag % session);
+  }
+
+  std::string
+  machineId(const std::string& tag, int machine) {
+    return boost::str(boost::format("%1%_machine%2%") % tag % machine);
+  }
+
+  /**
+   * \brief Flush the rows of a multi-row insert once it is large enough
+   */
+  void
+  appendRow(Database* db, const std::string& insert, std::vector<std::string>& rows,
+            const std::string& row, bool force = false) {
+    if (!row.empty()) {
+      rows.push_back(row);
+    }
+    if (rows.empty() || (!force && rows.size() < 500)) {
+      return;
+    }
+    std::string request = insert;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      request += (i == 0 ? "" : ", ") + rows[i];
+    }
+    db->process(request);
+    rows.clear();
+  }
+
+  void
+  load(Database* db, const std::string& tag, int nbSessions, int nbJobs, dice_t& dice) {
+    db->process(boost::str(boost::format(
+        "INSERT INTO users (userid, pwd, privilege, passwordstate, status, vishnu_vishnuid)"
+        " SELECT '%1%', 'none', 0, 1, 1, MIN(vishnuid) FROM vishnu") % tag));
+    db->process(boost::str(boost::format("INSERT INTO clmachine (name) VALUES ('%1%')") % tag));
+
+    std::vector<std::string> rows;
+    const std::string sessions =
+      "INSERT INTO vsession (vsessionid, sessionkey, state, closepolicy, timeout,"
+      " creation, lastconnect, users_numuserid, clmachine_numclmachineid) VALUES ";
+    for (int s = 0; s < nbSessions; ++s) {
+      appendRow(db, sessions, rows, boost::str(boost::format(
+          "('%1%_S%2%', '%3%', %4%, 1, 3600, CURRENT_TIMESTAMP, CURRENT_TIMESTAMP,"
+          " (SELECT numuserid FROM users WHERE userid='%1%'),"
+          " (SELECT MAX(numclmachineid) FROM clmachine WHERE name='%1%'))")
+          % tag % s % sessionKey(tag, s) % (dice() % 2 == 0 ? 1 : 0)));
+    }
+    appendRow(db, sessions, rows, "", true);
+
+    // the session ids, to avoid a lookup per history row
+    std::vector<std::string> ids;
+    boost::scoped_ptr<DatabaseResult> result(db->getResult(boost::str(boost::format(
+        "SELECT numsessionid FROM vsession, users"
+        " WHERE users.numuserid=vsession.users_numuserid AND users.userid='%1%'"
+        " ORDER BY numsessionid") % tag)));
+    for (size_t i = 0; i < result->getNbTuples(); ++i) {
+      ids.push_back(result->getRow(i).getString(0));
+    }
+
+    const std::string jobs =
+      "INSERT INTO job (jobId, jobName, owner, status, batchType, submitMachineId,"
+      " submitDate, vsession_numsessionid) VALUES ";
+    const std::string commands =
+      "INSERT INTO command (ctype, description, starttime, endtime, status,"
+      " vishnuobjectid, vsession_numsessionid) VALUES ";
+    const std::string transfers =
+      "INSERT INTO filetransfer (transferId, status, userId, sourceFilePath,"
+      " destinationFilePath, startTime, vsession_numsessionid) VALUES ";
+    std::vector<std::string> jobRows;
+    std::vector<std::string> commandRows;
+    std::vector<std::string> transferRows;
+    int job = 0;
+    for (size_t s = 0; s < ids.size(); ++s) {
+      for (int j = 0; j < nbJobs; ++j, ++job) {
+        std::string machine = machineId(tag, dice() % nbMachines);
+        appendRow(db, jobs, jobRows, boost::str(boost::format(
+            "('%1%_job%2%', 'bench', '%1%', %3%, 0, '%4%', CURRENT_TIMESTAMP, %5%)")
+            % tag % job % (dice() % 7) % machine % ids[s]));
+        appendRow(db, commands, commandRows, boost::str(boost::format(
+            "(2, 'vishnu_submit_job bench', CURRENT_TIMESTAMP, CURRENT_TIMESTAMP, 1, '%1%_job%2%', %3%)")
+            % tag % job % ids[s]));
+        // one transfer every four jobs of a session
+        if (j % 4 == 0) {
+          appendRow(db, transfers, transferRows, boost::str(boost::format(
+              "('%1%_transfer%2%', %3%, '%1%', '/tmp/in', '/tmp/out', CURRENT_TIMESTAMP, %4%)")
+              % tag % job % (dice() % 5) % ids[s]));
+        }
+      }
+    }
+    appendRow(db, jobs, jobRows, "", true);
+    appendRow(db, commands, commandRows, "", true);
+    appendRow(db, transfers, transferRows, "", true);
+  }
+
+  void
+  clean(Database* db, const std::string& tag) {
+    // jobs, commands and transfers are deleted in cascade
+    db->process(boost::str(boost::format(
+        "DELETE FROM vsession WHERE users_numuserid IN"
+        " (SELECT numuserid FROM users WHERE userid='%1%')") % tag));
+    db->process(boost::str(boost::format("DELETE FROM clmachine WHERE name='%1%'") % tag));
+    db->process(boost::str(boost::format("DELETE FROM users WHERE userid='%1%'") % tag));
+  }
+
+  void
+  run(Database* db, const std::string& tag, int nbSessions, int nbJobs,
+      int iterations, dice_t& dice) {
+    using boost::posix_time::microsec_clock;
+    using boost::posix_time::ptime;
+
+    std::cout << boost::format("%|-20| %|10| %|10| %|10| %|10|\n")
+      % "query" % "avg (us)" % "p50 (us)" % "p95 (us)" % "max (us)";
+    for (const query_t* query = queries; query->name != NULL; ++query) {
+      std::vector<long> times;
+      for (int i = 0; i < iterations; ++i) {
+        int job = dice() % (nbSessions * nbJobs);
+        int transfer = job - (job % nbJobs) % 4;
+        boost::format sql(query->sql);
+        // each query uses a subset of the parameters
+        sql.exceptions(boost::io::all_error_bits ^ boost::io::too_many_args_bit);
+        sql % sessionKey(tag, dice() % nbSessions)
+            % machineId(tag, dice() % nbMachines)
+            % boost::str(boost::format("%1%_job%2%") % tag % job)
+            % boost::str(boost::format("%1%_transfer%2%") % tag % transfer);
+        ptime start = microsec_clock::universal_time();
+        if (std::string(query->sql).compare(0, 6, "UPDATE") == 0) {
+          db->process(sql.str());
+        } else {
+          boost::scoped_ptr<DatabaseResult> result(db->getResult(sql.str()));
+        }
+        times.push_back((microsec_clock::universal_time() - start).total_microseconds());
+      }
+      std::sort(times.begin(), times.end());
+      long total = 0;
+      for (size_t i = 0; i < times.size(); ++i) {
+        total += times[i];
+      }
+      std::cout << boost::format("%|-20| %|10| %|10| %|10| %|10|\n")
+        % query->name
+        % (total / static_cast<long>(times.size()))
+        % times[times.size() / 2]
+        % times[(times.size() * 95) / 100]
+        % times.back();
+    }
+  }
+}
+
+int
+main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << boost::format("Usage: %1% vishnu_config.cfg [sessions=1000] [jobsPerSession=20]"
+                               " [iterations=200]\n") % argv[0];
+    return 1;
+  }
+  int nbSessions = (argc > 2) ? boost::lexical_cast<int>(argv[2]) : 1000;
+  int nbJobs = (argc > 3) ? boost::lexical_cast<int>(argv[3]) : 20;
+  int iterations = (argc > 4) ? boost::lexical_cast<int>(argv[4]) : 200;
+  if (nbSessions <= 0 || nbJobs <= 0 || iterations <= 0) {
+    std::cerr << "[ERROR] sessions, jobsPerSession and iterations must be positive\n";
+    return 1;
+  }
+
+  std::string tag = boost::str(boost::format("bench%1%") % getpid());
+  boost::mt19937 generator(42);
+  boost::uniform_int<> range(0, 1 << 30);
+  dice_t dice(generator, range);
+
+  Database* db = NULL;
+  try {
+    ExecConfiguration config;
+    config.initFromFile(argv[1]);
+    DbConfiguration dbConfig(config);
+    dbConfig.check();
+    dbConfig.setDbPoolSize(1);
+    DbFactory factory;
+    db = factory.createDatabaseInstance(dbConfig);
+    db->connect();
+
+    int version = 0;
+    try {
+      DbMigrator migrator(db);
+      version = migrator.getVersion();
+    } catch (VishnuException& e) {
+      // no server started on this database yet
+    }
+    std::cout << boost::format("Schema version %1% (latest %2%), %3% sessions, %4% jobs, %5% iterations\n")
+      % version % DbMigrator::getLatestVersion()
+      % nbSessions % (nbSessions * nbJobs) % iterations;
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    load(db, tag, nbSessions, nbJobs, dice);
+    std::cout << boost::format("History loaded in %1% ms\n")
+      % (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds();
+
+    try {
+      run(db, tag, nbSessions, nbJobs, iterations, dice);
+    } catch (VishnuException& e) {
+      clean(db, tag);
+      throw;
+    }
+    clean(db, tag);
+  } catch (VishnuException& e) {
+    std::cerr << "[ERROR] " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
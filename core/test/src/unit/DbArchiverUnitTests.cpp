@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <map>
+#include <boost/lexical_cast.hpp>
+#include "DbArchiver.hpp"
+#include "StubDatabase.hpp"
+
+/**
+ * \brief Database holding a number of rows to archive in each table,
+ * numbered from 1
+ */
+class HistoryDatabase : public StubDatabase {
+public:
+  std::map<std::string, int> mpending;
+  std::map<std::string, int> mmoved;
+
+protected:
+  DatabaseResult*
+  answer(const std::string& request) {
+    // SELECT <primary> FROM <table> WHERE ... LIMIT <n> FOR UPDATE
+    size_t start = request.find(" FROM ") + 6;
+    std::string table = request.substr(start, request.find(' ', start) - start);
+    size_t limit = request.find(" LIMIT ") + 7;
+    int size = boost::lexical_cast<int>(request.substr(limit, request.find(' ', limit) - limit));
+    std::vector<std::vector<std::string> > rows;
+    for (int i = 0; i < std::min(size, mpending[table]); ++i) {
+      rows.push_back(std::vector<std::string>(1, boost::lexical_cast<std::string>(++mmoved[table])));
+    }
+    return new DatabaseResult(rows, std::vector<std::string>(1, "id"));
+  }
+
+  void
+  apply(const std::string& request) {
+    if (request.compare(0, 12, "DELETE FROM ") == 0) {
+      std::string table = request.substr(12, request.find(' ', 12) - 12);
+      mpending[table] -= std::count(request.begin(), request.end(), ',') + 1;
+    }
+  }
+};
+
+BOOST_AUTO_TEST_SUITE( DbArchiver_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_batches_n )
+{
+  HistoryDatabase db;
+  db.mpending["job"] = 3;
+  db.mpending["vsession"] = 1;
+  DbArchiver archiver(&db, 30, 2);
+
+  BOOST_REQUIRE_EQUAL(archiver.archive(), 3);
+  BOOST_REQUIRE_EQUAL(db.getReads().size(), 4u);
+  BOOST_REQUIRE(db.getReads().at(0).find(" FOR UPDATE") != std::string::npos);
+  BOOST_REQUIRE_EQUAL(db.getStatements().at(0), "INSERT INTO job_archive SELECT * FROM job WHERE numjobid IN (1, 2)");
+  BOOST_REQUIRE_EQUAL(db.getStatements().at(1), "DELETE FROM job WHERE numjobid IN (1, 2)");
+
+  // a full batch, the next one at once
+  BOOST_REQUIRE_EQUAL(archiver.archive(), 1);
+  BOOST_REQUIRE_EQUAL(db.mpending["job"], 0);
+  // nothing left, the next pass later
+  BOOST_REQUIRE_EQUAL(archiver.archive(), 0);
+  BOOST_REQUIRE_EQUAL(db.getReads().size(), 8u);
+  BOOST_MESSAGE("Test batches OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_unavailable_n )
+{
+  HistoryDatabase db;
+  db.setFailure("", "relation job_archive does not exist");
+  DbArchiver archiver(&db, 30, 2);
+  BOOST_REQUIRE_EQUAL(archiver.archive(), 0);
+  BOOST_REQUIRE(db.getStatements().empty());
+  BOOST_MESSAGE("Test unavailable OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_may_be_archived_n )
+{
+  HistoryDatabase db;
+  DbArchiver archiver(&db, 30, 2);
+  BOOST_REQUIRE(archiver.mayBeArchived(0));
+  BOOST_REQUIRE(archiver.mayBeArchived(-1));
+  BOOST_REQUIRE(archiver.mayBeArchived(time(NULL) - 31 * 24 * 3600));
+  BOOST_REQUIRE(!archiver.mayBeArchived(time(NULL) - 29 * 24 * 3600));
+  BOOST_MESSAGE("Test may be archived OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include "DbConnectionPool.hpp"
+#include "SystemException.hpp"
+
+BOOST_AUTO_TEST_SUITE( DbConnectionPool_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_acquire_release_n )
+{
+  DbConnectionPool pool(2, 1);
+
+  int first = pool.acquire();
+  int second = pool.acquire();
+  BOOST_REQUIRE(first != second);
+  BOOST_REQUIRE_EQUAL(pool.getStats().inUse, 2u);
+
+  pool.release(first);
+  BOOST_REQUIRE_EQUAL(pool.acquire(), first);
+  pool.release(first);
+  pool.release(second);
+
+  DbConnectionPool::stats_t stats = pool.getStats();
+  BOOST_REQUIRE_EQUAL(stats.inUse, 0u);
+  BOOST_REQUIRE_EQUAL(stats.peakInUse, 2u);
+  BOOST_REQUIRE_EQUAL(stats.acquisitions, 3u);
+  BOOST_REQUIRE_EQUAL(stats.waits, 0u);
+  BOOST_REQUIRE(!pool.needsCheck(first));
+  BOOST_MESSAGE("Test acquire and release OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_timeout_b )
+{
+  DbConnectionPool pool(1, 1);
+
+  int pos = pool.acquire();
+  BOOST_REQUIRE_THROW(pool.acquire(), SystemException);
+  BOOST_REQUIRE_EQUAL(pool.getStats().timeouts, 1u);
+  pool.release(pos);
+  BOOST_MESSAGE("Test acquire timeout OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_wakeup_n )
+{
+  DbConnectionPool pool(1, 0);
+
+  int pos = pool.acquire();
+  boost::thread releaser(boost::bind(&DbConnectionPool::release, &pool, pos));
+  BOOST_REQUIRE_EQUAL(pool.acquire(), pos);
+  releaser.join();
+  pool.release(pos);
+  BOOST_REQUIRE_EQUAL(pool.getStats().inUse, 0u);
+  BOOST_MESSAGE("Test acquire wake up OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include "DbIdAllocator.hpp"
+#include "StubDatabase.hpp"
+
+/**
+ * \brief Database storing the next counter of the object type 2 only
+ */
+class CounterDatabase : public StubDatabase {
+public:
+  CounterDatabase() : mnext(100) {}
+
+  int mnext;
+
+protected:
+  DatabaseResult*
+  answer(const std::string& request) {
+    std::vector<std::vector<std::string> > rows;
+    if (request.find("idtype=2 ") != std::string::npos) {
+      rows.push_back(std::vector<std::string>(1, boost::lexical_cast<std::string>(mnext)));
+    }
+    return new DatabaseResult(rows, std::vector<std::string>(1, "nextid"));
+  }
+
+  void
+  apply(const std::string& request) {
+    // UPDATE vishnu_idblock SET nextid=<n> WHERE idtype=2
+    size_t pos = request.find("nextid=") + 7;
+    mnext = boost::lexical_cast<int>(request.substr(pos, request.find(' ', pos) - pos));
+  }
+};
+
+BOOST_AUTO_TEST_SUITE( DbIdAllocator_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_blocks_n )
+{
+  CounterDatabase db;
+  DbIdAllocator allocator(&db, 3);
+  int counter = 0;
+  for (int expected = 100; expected < 107; ++expected) {
+    BOOST_REQUIRE(allocator.next(2, counter));
+    BOOST_REQUIRE_EQUAL(counter, expected);
+  }
+  // 100-102, 103-105, 106-108
+  BOOST_REQUIRE_EQUAL(db.getStatements().size(), 3u);
+  BOOST_REQUIRE_EQUAL(db.mnext, 109);
+
+  // another process reserved the next block meanwhile
+  db.mnext = 200;
+  BOOST_REQUIRE(allocator.next(2, counter));
+  BOOST_REQUIRE_EQUAL(counter, 107);
+  BOOST_REQUIRE(allocator.next(2, counter));
+  BOOST_REQUIRE(allocator.next(2, counter));
+  BOOST_REQUIRE_EQUAL(counter, 200);
+  BOOST_MESSAGE("Test blocks OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_unavailable_n )
+{
+  CounterDatabase db;
+  DbIdAllocator allocator(&db, 3);
+  int counter = 0;
+  // no counter stored for this type, it is not asked for again
+  BOOST_REQUIRE(!allocator.next(3, counter));
+  size_t reads = db.getReads().size();
+  BOOST_REQUIRE(!allocator.next(3, counter));
+  BOOST_REQUIRE_EQUAL(db.getReads().size(), reads);
+
+  // a transient error, asked again at the next call
+  db.setFailure("", "deadlock detected");
+  BOOST_REQUIRE(!allocator.next(2, counter));
+  db.clearFailure();
+  BOOST_REQUIRE(allocator.next(2, counter));
+  BOOST_REQUIRE_EQUAL(counter, 100);
+
+  // no table, the type is not asked for again
+  DbIdAllocator other(&db, 3);
+  db.setFailure("", "relation \"vishnu_idblock\" does not exist");
+  BOOST_REQUIRE(!other.next(2, counter));
+  db.clearFailure();
+  BOOST_REQUIRE(!other.next(2, counter));
+  BOOST_REQUIRE_EQUAL(db.getStatements().size(), 1u);
+  BOOST_MESSAGE("Test unavailable OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
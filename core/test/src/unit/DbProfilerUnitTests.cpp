@@ -0,0 +1,108 @@
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "DbProfiler.hpp"
+
+BOOST_AUTO_TEST_SUITE( DbProfiler_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_template_n )
+{
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate("SELECT numuserid FROM users WHERE userid='it''s' AND status=1;"),
+                      "SELECT numuserid FROM users WHERE userid=? AND status=?");
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate(" DELETE FROM job\n  WHERE numjobid IN (1, 22, 333) "),
+                      "DELETE FROM job WHERE numjobid IN (?)");
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate("SELECT v2 FROM t1 WHERE a=$1 AND b=-2.5"),
+                      "SELECT v2 FROM t1 WHERE a=? AND b=-?");
+  // the VR_* requests share the statistics of their instances
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate("update account set status=%1% from users where users.userid='%2%';"),
+                      DbProfiler::getTemplate("update account set status=0 from users where users.userid='root';"));
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate(std::string(5000, 'x')).size(), DbProfiler::maxTemplateLength);
+  BOOST_MESSAGE("Test template OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_template_backslash_n )
+{
+  // a backslash is an ordinary character, e.g. PostgreSQL by default
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate("UPDATE job SET outputDir='C:\\dir\\' WHERE numjobid=1"),
+                      "UPDATE job SET outputDir=? WHERE numjobid=?");
+  // it escapes the next character, e.g. MySQL
+  BOOST_REQUIRE_EQUAL(DbProfiler::getTemplate("UPDATE job SET jobName='it\\'s' WHERE numjobid=1", true),
+                      "UPDATE job SET jobName=? WHERE numjobid=?");
+
+  DbProfiler profiler(0);
+  profiler.setBackslashEscapes(true);
+  profiler.record("SELECT * FROM job WHERE jobName='a\\'b'", 100, false);
+  BOOST_REQUIRE_EQUAL(profiler.getStats().at(0).request, "SELECT * FROM job WHERE jobName=?");
+  BOOST_MESSAGE("Test template with backslashes OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_stats_n )
+{
+  DbProfiler profiler(0);
+  profiler.record("SELECT * FROM job WHERE numjobid=1", 100, false);
+  profiler.record("SELECT * FROM job WHERE numjobid=2", 300, true);
+  profiler.record("SELECT * FROM users", 1000, false);
+
+  std::vector<DbProfiler::stats_t> stats = profiler.getStats();
+  BOOST_REQUIRE_EQUAL(stats.size(), 2);
+  BOOST_REQUIRE_EQUAL(stats.at(0).request, "SELECT * FROM users");
+  BOOST_REQUIRE_EQUAL(stats.at(1).request, "SELECT * FROM job WHERE numjobid=?");
+  BOOST_REQUIRE_EQUAL(stats.at(1).count, 2);
+  BOOST_REQUIRE_EQUAL(stats.at(1).errors, 1);
+  BOOST_REQUIRE_EQUAL(stats.at(1).totalUs, 400);
+  BOOST_REQUIRE_EQUAL(stats.at(1).maxUs, 300);
+  BOOST_MESSAGE("Test stats OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_bounded_n )
+{
+  DbProfiler profiler(0);
+  for (size_t i = 0; i <= DbProfiler::maxTemplates; ++i) {
+    profiler.record("SELECT * FROM t" + boost::lexical_cast<std::string>(i), 1, false);
+  }
+  std::vector<DbProfiler::stats_t> stats = profiler.getStats();
+  BOOST_REQUIRE_EQUAL(stats.size(), DbProfiler::maxTemplates + 1);
+  profiler.record("SELECT * FROM other", 1, false);
+  BOOST_REQUIRE_EQUAL(profiler.getStats().size(), DbProfiler::maxTemplates + 1);
+  BOOST_MESSAGE("Test bounded OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_n )
+{
+  DbProfiler profiler(0);
+  std::string request = "SELECT 1";
+  {
+    DbProfiler::Timer timer(&profiler, request);
+  }
+  try {
+    DbProfiler::Timer timer(&profiler, request);
+    throw std::runtime_error("lost connection");
+  } catch (std::runtime_error&) {
+  }
+  {
+    // not timed
+    DbProfiler::Timer timer(NULL, request);
+  }
+  std::vector<DbProfiler::stats_t> stats = profiler.getStats();
+  BOOST_REQUIRE_EQUAL(stats.size(), 1);
+  BOOST_REQUIRE_EQUAL(stats.at(0).count, 2);
+  BOOST_REQUIRE_EQUAL(stats.at(0).errors, 1);
+  BOOST_MESSAGE("Test timer OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_context_n )
+{
+  BOOST_REQUIRE(DbProfiler::getContext().empty());
+  {
+    DbProfiler::Context outer("sessionConnect");
+    {
+      DbProfiler::Context inner("userCreate");
+      BOOST_REQUIRE_EQUAL(DbProfiler::getContext(), "userCreate");
+    }
+    BOOST_REQUIRE_EQUAL(DbProfiler::getContext(), "sessionConnect");
+  }
+  BOOST_REQUIRE(DbProfiler::getContext().empty());
+  BOOST_MESSAGE("Test context OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
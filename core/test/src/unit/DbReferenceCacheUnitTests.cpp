@@ -0,0 +1,125 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include "DbReferenceCache.hpp"
+#include "StubDatabase.hpp"
+
+/**
+ * \brief Database storing the count of changes of each table
+ */
+class ReferenceDatabase : public StubDatabase {
+public:
+  ReferenceDatabase() : mreads(0) {
+    mversions["machine"] = 0;
+    mversions["users"] = 0;
+  }
+
+  std::map<std::string, long long> mversions;
+  int mreads;
+
+protected:
+  DatabaseResult*
+  answer(const std::string& request) {
+    if (request.find("vishnu_refversion") == std::string::npos) {
+      ++mreads;
+      return StubDatabase::answer(request);
+    }
+    std::vector<std::vector<std::string> > rows;
+    std::map<std::string, long long>::const_iterator it;
+    for (it = mversions.begin(); it != mversions.end(); ++it) {
+      std::vector<std::string> row;
+      row.push_back(it->first);
+      row.push_back(boost::lexical_cast<std::string>(it->second));
+      rows.push_back(row);
+    }
+    return new DatabaseResult(rows, std::vector<std::string>(2, "version"));
+  }
+
+  void
+  apply(const std::string& request) {
+    // UPDATE vishnu_refversion SET version=version+1 WHERE tablename='<table>'
+    std::string::size_type start = request.find('\'') + 1;
+    ++mversions[request.substr(start, request.rfind('\'') - start)];
+  }
+};
+
+BOOST_AUTO_TEST_SUITE( DbReferenceCache_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_read_through_n )
+{
+  ReferenceDatabase db;
+  db.setValue("SELECT nummachineid FROM machine WHERE machineid='m1'", "1");
+  DbReferenceCache cache(&db, 60, 2);
+  BOOST_REQUIRE_EQUAL(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'"), "1");
+  BOOST_REQUIRE_EQUAL(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'"), "1");
+  BOOST_REQUIRE_EQUAL(db.mreads, 1);
+
+  // no result is kept too
+  BOOST_REQUIRE(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m2'").empty());
+  BOOST_REQUIRE(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m2'").empty());
+  BOOST_REQUIRE_EQUAL(db.mreads, 2);
+
+  // the oldest is discarded when full
+  cache.getFirstElement("users", "SELECT numuserid FROM users WHERE userid='u1'");
+  cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'");
+  BOOST_REQUIRE_EQUAL(db.mreads, 4);
+  BOOST_MESSAGE("Test read through OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_first_row_n )
+{
+  ReferenceDatabase db;
+  std::string request = "SELECT nummachineid, name, status FROM machine WHERE machineid='m1'";
+  std::vector<std::string> row;
+  row.push_back("1");
+  row.push_back("cluster");
+  row.push_back("1");
+  db.setResult(request, std::vector<std::vector<std::string> >(1, row));
+  DbReferenceCache cache(&db, 60, 10);
+  BOOST_REQUIRE_EQUAL(cache.getFirstRow("machine", request).size(), 3);
+  BOOST_REQUIRE_EQUAL(cache.getFirstRow("machine", request).at(1), "cluster");
+  BOOST_REQUIRE_EQUAL(cache.getFirstElement("machine", request), "1");
+  BOOST_REQUIRE_EQUAL(db.mreads, 1);
+
+  BOOST_REQUIRE(cache.getFirstRow("machine", "SELECT nummachineid, name, status FROM machine WHERE machineid='m2'").empty());
+  BOOST_MESSAGE("Test first row OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_invalidate_n )
+{
+  ReferenceDatabase db;
+  db.setValue("SELECT nummachineid FROM machine WHERE machineid='m1'", "1");
+  db.setValue("SELECT numuserid FROM users WHERE userid='u1'", "1");
+  DbReferenceCache cache(&db, 60, 10);
+  cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'");
+  cache.getFirstElement("users", "SELECT numuserid FROM users WHERE userid='u1'");
+
+  db.setResult("SELECT nummachineid FROM machine WHERE machineid='m1'", std::vector<std::vector<std::string> >());
+  cache.invalidate("machine");
+  BOOST_REQUIRE_EQUAL(db.mversions["machine"], 1);
+  BOOST_REQUIRE(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'").empty());
+  // the other tables are kept
+  cache.getFirstElement("users", "SELECT numuserid FROM users WHERE userid='u1'");
+  BOOST_REQUIRE_EQUAL(db.mreads, 3);
+  BOOST_MESSAGE("Test invalidate OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_unavailable_n )
+{
+  ReferenceDatabase db;
+  db.setFailure("vishnu_refversion", "relation vishnu_refversion does not exist");
+  db.setValue("SELECT nummachineid FROM machine WHERE machineid='m1'", "1");
+  DbReferenceCache cache(&db, 60, 10);
+  BOOST_REQUIRE_EQUAL(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'"), "1");
+  BOOST_REQUIRE_EQUAL(cache.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'"), "1");
+  BOOST_REQUIRE_EQUAL(db.mreads, 2);
+
+  // disabled
+  DbReferenceCache none(&db, 0, 10);
+  db.clearFailure();
+  none.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'");
+  none.getFirstElement("machine", "SELECT nummachineid FROM machine WHERE machineid='m1'");
+  BOOST_REQUIRE_EQUAL(db.mreads, 4);
+  BOOST_MESSAGE("Test unavailable OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
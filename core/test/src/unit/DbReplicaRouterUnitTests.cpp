@@ -0,0 +1,69 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include "DbReplicaRouter.hpp"
+#include "StubDatabase.hpp"
+
+/**
+ * \brief Standby reporting a configurable replication lag
+ */
+class StandbyDatabase : public StubDatabase {
+public:
+  StandbyDatabase() : mlag(0) {}
+
+  int mlag;
+
+protected:
+  DatabaseResult*
+  answer(const std::string& request) {
+    std::vector<std::vector<std::string> > rows;
+    rows.push_back(std::vector<std::string>(1, boost::lexical_cast<std::string>(mlag)));
+    return new DatabaseResult(rows, std::vector<std::string>(1, "lag"));
+  }
+};
+
+BOOST_AUTO_TEST_SUITE( DbReplicaRouter_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_round_robin_and_own_writes_n )
+{
+  StandbyDatabase primary;
+  StandbyDatabase* first = new StandbyDatabase();
+  StandbyDatabase* second = new StandbyDatabase();
+  std::vector<Database*> replicas;
+  replicas.push_back(first);
+  replicas.push_back(second);
+  DbReplicaRouter router(&primary, replicas, 5);
+
+  BOOST_REQUIRE(router.getDatabase("key1") == first);
+  BOOST_REQUIRE(router.getDatabase("key1") == second);
+  BOOST_REQUIRE(router.getDatabase("key1") == first);
+  // the lag is measured once per interval
+  BOOST_REQUIRE_EQUAL(first->getReads().size(), 1u);
+
+  router.noteWrite("key1");
+  BOOST_REQUIRE(router.getDatabase("key1") == &primary);
+  BOOST_REQUIRE(router.getDatabase("key2") != &primary);
+  BOOST_MESSAGE("Test round robin and own writes OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_stale_replica_n )
+{
+  StandbyDatabase primary;
+  StandbyDatabase* late = new StandbyDatabase();
+  StandbyDatabase* down = new StandbyDatabase();
+  late->mlag = 60;
+  down->setFailure("", "could not connect to server");
+  std::vector<Database*> replicas;
+  replicas.push_back(late);
+  replicas.push_back(down);
+  DbReplicaRouter router(&primary, replicas, 5);
+
+  BOOST_REQUIRE(router.getDatabase("") == &primary);
+  BOOST_REQUIRE(router.getDatabase("") == &primary);
+  // both are marked unusable until their next measure
+  BOOST_REQUIRE(router.getDatabase("") == &primary);
+  BOOST_REQUIRE_EQUAL(late->getReads().size(), 1u);
+  BOOST_REQUIRE_EQUAL(down->getReads().size(), 1u);
+  BOOST_MESSAGE("Test stale replica OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include "DbSessionCache.hpp"
+#include "StubDatabase.hpp"
+
+/**
+ * \brief Database storing the count of changes of the sessions
+ */
+class VersionDatabase : public StubDatabase {
+public:
+  VersionDatabase() : mversion(0) {}
+
+  long long mversion;
+
+protected:
+  DatabaseResult*
+  answer(const std::string& request) {
+    std::vector<std::vector<std::string> > rows;
+    rows.push_back(std::vector<std::string>(1, boost::lexical_cast<std::string>(mversion)));
+    return new DatabaseResult(rows, std::vector<std::string>(1, "version"));
+  }
+
+  void
+  apply(const std::string& request) {
+    // UPDATE vishnu_authversion SET version=version+1
+    ++mversion;
+  }
+};
+
+BOOST_AUTO_TEST_SUITE( DbSessionCache_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_get_put_n )
+{
+  VersionDatabase db;
+  DbSessionCache cache(&db, 30, 2);
+  std::vector<std::string> row;
+  unsigned long generation;
+  BOOST_REQUIRE(!cache.get("key1", row, generation));
+  cache.put("key1", std::vector<std::string>(1, "user1"), generation);
+  BOOST_REQUIRE(cache.get("key1", row, generation));
+  BOOST_REQUIRE_EQUAL(row.at(0), "user1");
+  // the count is read once per interval
+  BOOST_REQUIRE_EQUAL(db.getReads().size(), 1u);
+
+  // the oldest is discarded when full
+  cache.put("key2", std::vector<std::string>(1, "user2"), generation);
+  cache.put("key3", std::vector<std::string>(1, "user3"), generation);
+  BOOST_REQUIRE(!cache.get("key1", row, generation));
+  BOOST_REQUIRE(cache.get("key2", row, generation));
+  BOOST_REQUIRE(cache.get("key3", row, generation));
+  BOOST_MESSAGE("Test get put OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_invalidate_n )
+{
+  VersionDatabase db;
+  DbSessionCache cache(&db, 30, 10);
+  std::vector<std::string> row;
+  unsigned long generation;
+  cache.get("key1", row, generation);
+  cache.put("key1", std::vector<std::string>(1, "user1"), generation);
+
+  unsigned long before;
+  cache.get("key2", row, before);
+  cache.invalidate();
+  BOOST_REQUIRE_EQUAL(db.mversion, 1);
+  BOOST_REQUIRE(!cache.get("key1", row, generation));
+  // read before the change
+  cache.put("key2", std::vector<std::string>(1, "user2"), before);
+  BOOST_REQUIRE(!cache.get("key2", row, generation));
+  BOOST_MESSAGE("Test invalidate OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_unavailable_n )
+{
+  VersionDatabase db;
+  db.setFailure("", "relation vishnu_authversion does not exist");
+  DbSessionCache cache(&db, 30, 10);
+  std::vector<std::string> row;
+  unsigned long generation;
+  BOOST_REQUIRE(!cache.get("key1", row, generation));
+  cache.put("key1", std::vector<std::string>(1, "user1"), generation);
+  BOOST_REQUIRE(!cache.get("key1", row, generation));
+
+  // disabled
+  DbSessionCache none(&db, 0, 10);
+  BOOST_REQUIRE(!none.get("key1", row, generation));
+  BOOST_MESSAGE("Test unavailable OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,64 @@
+#include <boost/test/unit_test.hpp>
+#include "DbWriteBehind.hpp"
+#include "StubDatabase.hpp"
+
+BOOST_AUTO_TEST_SUITE( DbWriteBehind_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_coalesce_n )
+{
+  StubDatabase db;
+  // long interval: only explicit flushes are expected
+  DbWriteBehind queue(&db, 3600000, 100);
+
+  queue.enqueue("INSERT INTO t (a) VALUES %1%", "(1)");
+  queue.enqueue("INSERT INTO t (a) VALUES %1%", "(1)");
+  queue.enqueue("UPDATE t SET b=1 WHERE a IN (%1%)", "'k'", true);
+  queue.enqueue("UPDATE t SET b=1 WHERE a IN (%1%)", "'k'", true);
+  queue.enqueue("UPDATE t SET b=1 WHERE a IN (%1%)", "'l'", true);
+  BOOST_REQUIRE_EQUAL(queue.getPending(), 4u);
+  BOOST_REQUIRE(db.getStatements().empty());
+
+  queue.flush();
+  BOOST_REQUIRE_EQUAL(queue.getPending(), 0u);
+  BOOST_REQUIRE_EQUAL(db.getBatches(), 1);
+  std::vector<std::string> statements = db.getStatements();
+  BOOST_REQUIRE_EQUAL(statements.size(), 2u);
+  BOOST_REQUIRE_EQUAL(statements[0], "INSERT INTO t (a) VALUES (1), (1)");
+  BOOST_REQUIRE_EQUAL(statements[1], "UPDATE t SET b=1 WHERE a IN ('k', 'l')");
+
+  // nothing pending, nothing sent
+  queue.flush();
+  BOOST_REQUIRE_EQUAL(db.getBatches(), 1);
+  BOOST_MESSAGE("Test coalesce OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_capacity_and_shutdown_n )
+{
+  StubDatabase db;
+  {
+    DbWriteBehind queue(&db, 3600000, 2);
+    queue.enqueue("INSERT INTO t (a) VALUES %1%", "(1)");
+    queue.enqueue("INSERT INTO t (a) VALUES %1%", "(2)");
+    // the queue was full, the producer flushed it
+    BOOST_REQUIRE_EQUAL(db.getBatches(), 1);
+    queue.enqueue("INSERT INTO t (a) VALUES %1%", "(3)");
+  }
+  // the destructor flushed the remaining write
+  BOOST_REQUIRE_EQUAL(db.getBatches(), 2);
+  BOOST_REQUIRE_EQUAL(db.getStatements().back(), "INSERT INTO t (a) VALUES (3)");
+  BOOST_MESSAGE("Test capacity and shutdown OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_background_flush_n )
+{
+  StubDatabase db;
+  DbWriteBehind queue(&db, 10, 100);
+  queue.enqueue("INSERT INTO t (a) VALUES %1%", "(1)");
+  for (int i = 0; i < 100 && db.getBatches() == 0; ++i) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+  BOOST_REQUIRE_EQUAL(db.getBatches(), 1);
+  BOOST_MESSAGE("Test background flush OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
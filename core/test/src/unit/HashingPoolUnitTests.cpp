@@ -0,0 +1,57 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include "HashingPool.hpp"
+#include "SystemException.hpp"
+
+/**
+ * \brief Hash a key a number of times and check the result
+ * \param pool the pool
+ * \param failures incremented for each wrong result
+ */
+static void
+hashMany(HashingPool* pool, int* failures) {
+  for (int i = 0; i < 20; ++i) {
+    if (pool->hash("vishnu_user", "$6$root$").substr(8)
+        != "8vU7h/n6KOW8reLF1Lt2/5gzjZ.HvGK3A9doVMbmPtaYKkkCoWrMKiPa7s.fEigSTS5gQmX5F8BlW2XotCeHa0") {
+      ++*failures;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( HashingPool_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_hash_n )
+{
+  HashingPool pool(2);
+  std::string md5 = pool.hash("vishnu", "$1$salt$");
+  BOOST_REQUIRE_EQUAL(md5.substr(0, 8), "$1$salt$");
+  BOOST_REQUIRE_EQUAL(pool.hash("vishnu", "$1$salt$"), md5);
+  BOOST_REQUIRE(pool.hash("vishnu", "$6$salt$") != md5);
+  BOOST_MESSAGE("Test hash OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_n )
+{
+  // more callers than threads, each gets its own result
+  HashingPool pool(2);
+  int failures[4] = {0, 0, 0, 0};
+  boost::thread_group callers;
+  for (int i = 0; i < 4; ++i) {
+    callers.create_thread(boost::bind(&hashMany, &pool, &failures[i]));
+  }
+  callers.join_all();
+  for (int i = 0; i < 4; ++i) {
+    BOOST_REQUIRE_EQUAL(failures[i], 0);
+  }
+  BOOST_MESSAGE("Test concurrent OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_bad_salt_b )
+{
+  HashingPool pool(1);
+  BOOST_REQUIRE_THROW(pool.hash("vishnu", "$9$"), SystemException);
+  BOOST_MESSAGE("Test bad salt OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
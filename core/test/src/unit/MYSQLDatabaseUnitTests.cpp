@@ -0,0 +1,25 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include "MYSQLDatabase.hpp"
+
+BOOST_AUTO_TEST_SUITE( MYSQLDatabase_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_escape_backslash_n )
+{
+  // the default sql_mode, a backslash escapes the next character
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("o'brien", false), "o\\'brien");
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("x\\' OR 1=1 --", false), "x\\\\\\' OR 1=1 --");
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("a\nb\"c", false), "a\\nb\\\"c");
+  BOOST_MESSAGE("Test escape with backslashes OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_escape_no_backslash_n )
+{
+  // NO_BACKSLASH_ESCAPES, the quotes are doubled and the backslashes kept
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("o'brien", true), "o''brien");
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("x\\' OR 1=1 --", true), "x\\'' OR 1=1 --");
+  BOOST_REQUIRE_EQUAL(MYSQLDatabase::escapeString("C:\\dir\\", true), "C:\\dir\\");
+  BOOST_MESSAGE("Test escape without backslashes OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <ecorecpp.hpp>
+#include "QueryPage.hpp"
+#include "UserException.hpp"
+#include "UMS_Data.hpp"
+
+BOOST_AUTO_TEST_SUITE( QueryPage_unit_tests )
+
+BOOST_AUTO_TEST_CASE( test_token_n )
+{
+  std::string key = "it's 42\n";
+  std::string token = QueryPage::encodeToken(key);
+  BOOST_REQUIRE_EQUAL(token.find_first_not_of("0123456789abcdef"), std::string::npos);
+  BOOST_REQUIRE_EQUAL(QueryPage::decodeToken(token), key);
+  BOOST_REQUIRE_EQUAL(QueryPage::decodeToken(""), "");
+  BOOST_MESSAGE("Test token OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_token_b )
+{
+  BOOST_CHECK_THROW(QueryPage::decodeToken("abc"), UserException);
+  BOOST_CHECK_THROW(QueryPage::decodeToken("zz"), UserException);
+  BOOST_MESSAGE("Test bad token OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_serialize_n )
+{
+  BOOST_REQUIRE(QueryPage::deserialize("").isDefault());
+
+  QueryPage page(50, QueryPage::encodeToken("12"));
+  std::vector<std::string> fields;
+  fields.push_back("userId");
+  fields.push_back("status");
+  page.setFields(fields);
+  BOOST_REQUIRE(!page.isDefault());
+
+  QueryPage read = QueryPage::deserialize(page.serialize());
+  BOOST_REQUIRE_EQUAL(read.getSize(), 50);
+  BOOST_REQUIRE_EQUAL(QueryPage::decodeToken(read.getToken()), "12");
+  BOOST_REQUIRE(read.getFields() == fields);
+  BOOST_MESSAGE("Test serialize OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_serialize_b )
+{
+  BOOST_CHECK_THROW(QueryPage::deserialize("10"), UserException);
+  BOOST_CHECK_THROW(QueryPage::deserialize("ten;;"), UserException);
+  BOOST_CHECK_THROW(QueryPage::deserialize("10;;userid='x'"), UserException);
+  BOOST_MESSAGE("Test bad serialize OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_project_n )
+{
+  UMS_Data::UMS_DataFactory_ptr factory = UMS_Data::UMS_DataFactory::_instance();
+  UMS_Data::ListUsers_ptr list = factory->createListUsers();
+  UMS_Data::User_ptr user = factory->createUser();
+  user->setUserId("user_1");
+  user->setEmail("user_1@vishnu");
+  user->setPrivilege(1);
+  list->getUsers().push_back(user);
+
+  QueryPage page;
+  std::vector<std::string> fields;
+  fields.push_back("userId");
+  page.setFields(fields);
+  page.project(list);
+
+  BOOST_REQUIRE_EQUAL(user->getUserId(), "user_1");
+  BOOST_REQUIRE_EQUAL(user->getEmail(), "");
+  boost::scoped_ptr<UMS_Data::User> blank(factory->createUser());
+  BOOST_REQUIRE_EQUAL(user->getPrivilege(), blank->getPrivilege());
+  delete list;
+  BOOST_MESSAGE("Test project OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
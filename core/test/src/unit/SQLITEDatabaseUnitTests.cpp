@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <fstream>
+#include "SQLITEDatabase.hpp"
+#include "DbTransaction.hpp"
+#include "ExecConfiguration.hpp"
+#include "SystemException.hpp"
+
+namespace {
+  /**
+   * \brief A database file removed at the end of the test
+   */
+  struct SQLITEFixture {
+    SQLITEFixture()
+      : mpath(boost::filesystem::unique_path(boost::filesystem::temp_directory_path().string()
+                                             + "/vishnu-sqlite%%%%%%%")) {
+      std::string configPath = mpath.string() + ".cfg";
+      std::ofstream config(configPath.c_str());
+      config << "databaseType=sqlite\n"
+             << "databaseName=" << mpath.string() << "\n"
+             << "databaseConnectionsNb=2\n";
+      config.close();
+      ExecConfiguration execConfig;
+      execConfig.initFromFile(configPath);
+      boost::filesystem::remove(configPath);
+      DbConfiguration dbConfig(execConfig);
+      dbConfig.check();
+      mdb.reset(new SQLITEDatabase(dbConfig));
+      mdb->connect();
+    }
+
+    ~SQLITEFixture() {
+      mdb.reset();
+      boost::filesystem::remove(mpath);
+      boost::filesystem::remove(mpath.string() + "-wal");
+      boost::filesystem::remove(mpath.string() + "-shm");
+    }
+
+    boost::filesystem::path mpath;
+    boost::scoped_ptr<SQLITEDatabase> mdb;
+  };
+
+  void
+  collect(std::vector<std::string>* names, const DatabaseResult::Row& row) {
+    names->push_back(row.isNull(1) ? "null" : row.getString(1));
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( SQLITEDatabase_unit_tests, SQLITEFixture )
+
+BOOST_AUTO_TEST_CASE( test_requests_n )
+{
+  BOOST_REQUIRE(mdb->getDbType() == DbConfiguration::SQLITE);
+  mdb->process("CREATE TABLE users (numuserid INTEGER PRIMARY KEY AUTOINCREMENT,"
+               " userid VARCHAR(255), status INTEGER);"
+               "CREATE TABLE account (numaccountid INTEGER PRIMARY KEY AUTOINCREMENT,"
+               " users_numuserid BIGINT, status INTEGER)");
+  BOOST_REQUIRE_EQUAL(mdb->generateId("users", "(userid, status)", "('root', 1)", -1, "numuserid"), 1);
+  BOOST_REQUIRE_EQUAL(mdb->generateId("users", "(userid, status)",
+                                      "('" + mdb->escapeData("o'brien") + "', NULL)", -1, "numuserid"), 2);
+  mdb->process("INSERT INTO account (users_numuserid, status) VALUES (2, 1)");
+
+  boost::scoped_ptr<DatabaseResult> result(mdb->getResult("SELECT numuserid, userid FROM users"
+                                                          " ORDER BY numuserid"));
+  BOOST_REQUIRE_EQUAL(result->getNbTuples(), 2);
+  BOOST_REQUIRE_EQUAL(result->getNbFields(), 2);
+  BOOST_REQUIRE_EQUAL(result->get(1).at(1), "o'brien");
+
+  std::vector<std::string> statuses;
+  BOOST_REQUIRE_EQUAL(mdb->forEachRow("SELECT userid, status FROM users ORDER BY numuserid",
+                                      boost::bind(collect, &statuses, _1)), 2);
+  BOOST_REQUIRE_EQUAL(statuses.at(0), "1");
+  BOOST_REQUIRE_EQUAL(statuses.at(1), "null");
+
+  // the dialect of the joined updates
+  mdb->process((boost::format(mdb->getRequest(VR_UPDATE_ACCOUNT_WITH_USERS)) % 0 % "o''brien").str());
+  result.reset(mdb->getResult("SELECT status FROM account"));
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), "0");
+
+  BOOST_REQUIRE_THROW(mdb->getResult("SELECT missing FROM users"), SystemException);
+  BOOST_MESSAGE("Test requests OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_transactions_n )
+{
+  mdb->process("CREATE TABLE counter (value INTEGER)");
+  {
+    DbTransaction transaction(mdb.get());
+    mdb->process("INSERT INTO counter VALUES (1)", transaction.getId());
+    transaction.commit();
+  }
+  {
+    // rolled back when left without commit
+    DbTransaction transaction(mdb.get());
+    mdb->process("INSERT INTO counter VALUES (2)", transaction.getId());
+  }
+  boost::scoped_ptr<DatabaseResult> result(mdb->getResult("SELECT SUM(value) FROM counter"));
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), "1");
+  BOOST_REQUIRE_EQUAL(mdb->getPoolStats().inUse, 0);
+  BOOST_MESSAGE("Test transactions OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_insert_rows_n )
+{
+  mdb->process("CREATE TABLE job (numjobid INTEGER PRIMARY KEY AUTOINCREMENT,"
+               " jobid VARCHAR(255), status INTEGER)");
+  std::vector<std::string> columns;
+  columns.push_back("jobid");
+  columns.push_back("status");
+  std::vector<std::vector<std::string> > rows;
+  for (size_t i = 0; i < Database::maxInsertRows + 1; ++i) {
+    std::vector<std::string> row;
+    row.push_back(i == 0 ? "o'brien" : "j" + boost::lexical_cast<std::string>(i));
+    row.push_back("1");
+    rows.push_back(row);
+  }
+  // in two requests
+  mdb->insertRows("job", columns, rows);
+  boost::scoped_ptr<DatabaseResult> result(mdb->getResult("SELECT COUNT(*), SUM(status) FROM job"));
+  BOOST_REQUIRE_EQUAL(result->get(0).at(0), boost::lexical_cast<std::string>(rows.size()));
+  BOOST_REQUIRE_EQUAL(result->get(0).at(1), boost::lexical_cast<std::string>(rows.size()));
+  result.reset(mdb->getResult("SELECT jobid FROM job WHERE numjobid=1"));
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), "o'brien");
+
+  // all or nothing
+  rows.back().pop_back();
+  BOOST_REQUIRE_THROW(mdb->insertRows("job", columns, rows), SystemException);
+  result.reset(mdb->getResult("SELECT COUNT(*) FROM job"));
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), boost::lexical_cast<std::string>(rows.size()));
+  BOOST_MESSAGE("Test insert rows OK");
+}
+
+BOOST_AUTO_TEST_CASE( test_insert_rows_null_n )
+{
+  mdb->process("CREATE TABLE step (jobid VARCHAR(255), workId INTEGER)");
+  std::vector<std::string> columns;
+  columns.push_back("jobid");
+  columns.push_back("workId");
+  std::vector<std::vector<std::string> > rows(2, std::vector<std::string>(2, "0"));
+  rows[0][0] = "j.0";
+  rows[1][0] = "j.1";
+  rows[1][1] = "7";
+  std::vector<std::vector<bool> > nulls(2, std::vector<bool>(2, false));
+  nulls[0][1] = true;
+  mdb->insertRows("step", columns, rows, nulls);
+  boost::scoped_ptr<DatabaseResult> result(
+    mdb->getResult("SELECT jobid FROM step WHERE workId IS NULL"));
+  BOOST_REQUIRE_EQUAL(result->getNbTuples(), 1);
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), "j.0");
+  result.reset(mdb->getResult("SELECT workId FROM step WHERE jobid='j.1'"));
+  BOOST_REQUIRE_EQUAL(result->getFirstElement(), "7");
+
+  // a flag per value
+  nulls.back().pop_back();
+  BOOST_REQUIRE_THROW(mdb->insertRows("step", columns, rows, nulls), SystemException);
+  BOOST_MESSAGE("Test insert NULL values OK");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
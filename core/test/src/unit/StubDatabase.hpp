@@ -0,0 +1,212 @@
+#ifndef STUB_DATABASE_HPP
+#define STUB_DATABASE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+/**
+ * \brief Database of the unit tests of the database layer: it records the
+ * requests it receives, answers the reads with the results set for them
+ * and fails the requests containing a given fragment. The tests needing a
+ * state override answer and apply.
+ */
+class StubDatabase : public Database {
+public:
+  /**
+   * \brief Constructor
+   * \param type the type of database reported
+   */
+  explicit StubDatabase(DbConfiguration::db_type_t type = DbConfiguration::POSTGRESQL)
+    : mtype(type), mfailing(false), mbatches(0) {}
+
+  /**
+   * \brief Set the rows returned by a request
+   * \param request the exact request
+   * \param rows the rows, none for an empty result
+   */
+  void
+  setResult(const std::string& request, const std::vector<std::vector<std::string> >& rows) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mresults[request] = rows;
+  }
+
+  /**
+   * \brief Set the single value returned by a request
+   * \param request the exact request
+   * \param value the value of the single row and column
+   */
+  void
+  setValue(const std::string& request, const std::string& value) {
+    setResult(request, std::vector<std::vector<std::string> >(1, std::vector<std::string>(1, value)));
+  }
+
+  /**
+   * \brief Make the requests fail
+   * \param fragment the requests containing it fail, empty for all
+   * \param message the error raised
+   */
+  void
+  setFailure(const std::string& fragment, const std::string& message) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mfailing = true;
+    mfailure = fragment;
+    mmessage = message;
+  }
+
+  /**
+   * \brief Make the requests succeed again
+   */
+  void
+  clearFailure() {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mfailing = false;
+  }
+
+  /**
+   * \brief Get the reads received, including the failed ones
+   * \return the requests
+   */
+  std::vector<std::string>
+  getReads() {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    return mreads;
+  }
+
+  /**
+   * \brief Get the statements received, one by one or in batches
+   * \return the statements
+   */
+  std::vector<std::string>
+  getStatements() {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    return mstatements;
+  }
+
+  /**
+   * \brief Get the number of batches received
+   * \return the number of batches
+   */
+  int
+  getBatches() {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    return mbatches;
+  }
+
+  DatabaseResult*
+  getResult(std::string request, int transacId = -1) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    mreads.push_back(request);
+    check(request);
+    return answer(request);
+  }
+
+  int
+  process(std::string request, int transacId = -1) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    check(request);
+    mstatements.push_back(request);
+    apply(request);
+    return 0;
+  }
+
+  int
+  processBatch(const std::vector<std::string>& requests, int transacId = -1) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    ++mbatches;
+    std::vector<std::string>::const_iterator it;
+    for (it = requests.begin(); it != requests.end(); ++it) {
+      check(*it);
+      mstatements.push_back(*it);
+      apply(*it);
+    }
+    return 0;
+  }
+
+  int connect() { return 0; }
+  DbConfiguration::db_type_t getDbType() { return mtype; }
+  int startTransaction() { return 0; }
+  void endTransaction(int transactionID) {}
+  void cancelTransaction(int transactionID) {}
+  void flush(int transactionID) {}
+  int generateId(std::string table, std::string fields, std::string val, int tid, std::string primary) { return 0; }
+  std::string getRequest(const int key) { return ""; }
+  std::string escapeData(const std::string& data) { return data; }
+  int disconnect() { return 0; }
+
+protected:
+  /**
+   * \brief Answer a read which did not fail, called with the lock held
+   * \param request the request
+   * \return the rows set for the request, none by default
+   */
+  virtual DatabaseResult*
+  answer(const std::string& request) {
+    std::vector<std::vector<std::string> >& rows = mresults[request];
+    size_t fields = rows.empty() ? 1 : rows[0].size();
+    return new DatabaseResult(rows, std::vector<std::string>(fields, "value"));
+  }
+
+  /**
+   * \brief Apply a statement which did not fail, called with the lock held
+   * \param request the statement
+   */
+  virtual void
+  apply(const std::string& request) {}
+
+private:
+  /**
+   * \brief Raise the failure set if it concerns a request
+   * \param request the request
+   */
+  void
+  check(const std::string& request) {
+    if (mfailing && request.find(mfailure) != std::string::npos) {
+      throw SystemException(ERRCODE_DBERR, mmessage);
+    }
+  }
+
+  /**
+   * \brief Protects the requests received, the statements are sent by
+   * several threads
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief The type of database reported
+   */
+  DbConfiguration::db_type_t mtype;
+  /**
+   * \brief The rows of the requests
+   */
+  std::map<std::string, std::vector<std::vector<std::string> > > mresults;
+  /**
+   * \brief Whether the requests containing mfailure fail
+   */
+  bool mfailing;
+  /**
+   * \brief The fragment of the failing requests
+   */
+  std::string mfailure;
+  /**
+   * \brief The error of the failing requests
+   */
+  std::string mmessage;
+  /**
+   * \brief The reads received
+   */
+  std::vector<std::string> mreads;
+  /**
+   * \brief The statements received
+   */
+  std::vector<std::string> mstatements;
+  /**
+   * \brief The number of batches received
+   */
+  int mbatches;
+};
+
+#endif // STUB_DATABASE_HPP
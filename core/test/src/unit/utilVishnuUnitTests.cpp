@@ -75,6 +75,20 @@ BOOST_AUTO_TEST_CASE( test_cryptPwd_n )
 }
 
 
+BOOST_AUTO_TEST_CASE( test_generateToken_n )
+{
+  std::string token = vishnu::generateToken(64);
+
+  BOOST_REQUIRE_EQUAL(token.size(), 64);
+  BOOST_REQUIRE(token.find_first_not_of("./0123456789"
+                                        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                        "abcdefghijklmnopqrstuvwxyz") == std::string::npos);
+  BOOST_REQUIRE(token != vishnu::generateToken(64));
+  BOOST_REQUIRE(vishnu::generateToken(0).empty());
+  BOOST_MESSAGE("Test generateToken OK");
+}
+
+
 BOOST_AUTO_TEST_CASE( test_isNumerical_n )
 {
   std::string input_1 = "12345";